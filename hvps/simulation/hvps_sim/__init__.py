@@ -16,6 +16,8 @@ power       -- Power conversion chain models (transformers, SCRs, filters)
 controls    -- Control system (PLC, regulator board, Enerpro firing boards)
 protection  -- Protection systems (crowbar, interlocks, arc detection)
 simulator   -- Main simulation engine and result containers
+engine      -- Vectorized batch engine and parallel parameter sweeps
+cosim       -- Closed-loop co-simulation of rf_hvps_loop against the plant
 plotting    -- Visualization and analysis tools
 examples    -- Runnable demonstration scenarios
 """
@@ -25,4 +27,5 @@ __author__ = "SSRL/SLAC Engineering"
 
 from hvps.simulation.hvps_sim.config import HVPSConfig
 from hvps.simulation.hvps_sim.simulator import HVPSSimulator, SimulationResult
+from hvps.simulation.hvps_sim.engine import BatchCase, BatchResult
 
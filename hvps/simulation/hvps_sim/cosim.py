@@ -0,0 +1,696 @@
+"""
+HVPS Loop Co-Simulation
+=======================
+
+Closed-loop co-simulation of the ``rf_hvps_loop`` sequencer (HVPS
+"process" state) against the hvps_sim plant on a virtual clock.
+
+    rf_hvps_loop proc  ──requested kV──►  HVPS  ──►  klystron  ──►  cavities
+          ▲                                 │            │            │
+          └── readback, forward power, gap voltage check, vacuum check┘
+
+Loop side (llrf/legacyLLRF):
+    HVPSLoop transliterates the ``proc`` state of rf_hvps_loop.st and the
+    HVPS_LOOP_SET_VOLTAGE / HVPS_LOOP_CHECK_STATUS macros. Status codes
+    and HVPS_LOOP_MAX_VOLT_TOL are those of rf_hvps_loop_defs.h. The loop
+    wakes on the ``{STN}:HVPS:LOOP:READY`` monitor or, failing that, after
+    HVPS_LOOP_SLOW_PERIOD (the SNL ``delay()`` restarts on every state
+    entry). Processing never slows down in the adaptive scheduler, so
+    rfSched.c is not modelled. With ``cond_ctrl`` the up step is scaled by
+    the trend forecasts of rfCond.c (CondTrend, cond_scale, cond_delta).
+
+Plant side:
+    The supply is reduced to its behaviour at loop timescales (the
+    regulator settles in well under 100 ms, see run_step_response): a
+    first-order lag to a static setpoint→output map, with the 5 s
+    soft-start after turn-on. ``calibrate_plant`` measures the static map
+    with the batch engine. The klystron load is power.KlystronLoad;
+    arcs and interlocks go through protection.ProtectionManager. Cavity
+    vacuum follows a simple RF-conditioning model (outgassing that falls
+    with accumulated RF energy, plus random bursts whose rate rises
+    steeply above the conditioned power level).
+
+Station side:
+    A trip (arc, vacuum interlock, HVPS interlock) takes the station OFF
+    and zeroes the requested voltage as s_go_off does; after
+    ``restart_delay`` the station is turned back on at VOLT:MIN as
+    HVPSONSUB does, and the loop re-enters ``proc``.
+
+Usage:
+    from hvps.simulation.hvps_sim.cosim import (
+        LoopParams, Scenario, run_cosim, sweep_loop)
+
+    result = run_cosim(LoopParams(), Scenario(duration=4 * 3600.0))
+    print(result.summary())
+
+    results = sweep_loop({'delta_proc_voltage_up': [0.02, 0.05, 0.1],
+                          'cond_ctrl': [False, True]},
+                         Scenario(duration=3600.0, ready_interval=None))
+    print(format_sweep(results))
+"""
+
+import itertools
+import math
+import os
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass, field, fields, replace
+from typing import Dict, List, Optional, Sequence
+
+import numpy as np
+
+from hvps.simulation.hvps_sim.config import HVPSConfig
+from hvps.simulation.hvps_sim.power import KlystronLoad
+from hvps.simulation.hvps_sim.protection import (
+    ProtectionManager, ProtectionState
+)
+
+# rf_hvps_loop_defs.h
+HVPS_LOOP_SLOW_PERIOD = 5.0
+HVPS_LOOP_MAX_VOLT_TOL = 10
+
+HVPS_LOOP_COND_HORIZON = 10.0
+HVPS_LOOP_COND_DECADES = 0.5
+HVPS_LOOP_COND_FRACTION = 0.05
+HVPS_LOOP_COND_STEP_MAX = 2.0
+
+# rfCond.h / rfCond.c
+RF_COND_WINDOW = 16
+RF_COND_MIN_POINTS = 4
+RF_COND_PREDOWN_FRAC = 0.5
+
+HVPS_LOOP_STATE_OFF = 0
+HVPS_LOOP_STATE_PROC = 1
+HVPS_LOOP_STATE_ON = 2
+
+HVPS_LOOP_STATUS_UNKNOWN = 0
+HVPS_LOOP_STATUS_GOOD = 1
+HVPS_LOOP_STATUS_RFP_BAD = 2
+HVPS_LOOP_STATUS_CAVV_LIM = 3
+HVPS_LOOP_STATUS_OFF = 4
+HVPS_LOOP_STATUS_VACM_BAD = 5
+HVPS_LOOP_STATUS_POWR_BAD = 6
+HVPS_LOOP_STATUS_GAPV_BAD = 7
+HVPS_LOOP_STATUS_GAPV_TOL = 8
+HVPS_LOOP_STATUS_VOLT_LIM = 9
+HVPS_LOOP_STATUS_STN_OFF = 10
+HVPS_LOOP_STATUS_VOLT_TOL = 11
+HVPS_LOOP_STATUS_VOLT_BAD = 12
+
+STATUS_NAMES = {
+    HVPS_LOOP_STATUS_UNKNOWN: "UNKNOWN",
+    HVPS_LOOP_STATUS_GOOD: "GOOD",
+    HVPS_LOOP_STATUS_RFP_BAD: "RFP_BAD",
+    HVPS_LOOP_STATUS_CAVV_LIM: "CAVV_LIM",
+    HVPS_LOOP_STATUS_OFF: "OFF",
+    HVPS_LOOP_STATUS_VACM_BAD: "VACM_BAD",
+    HVPS_LOOP_STATUS_POWR_BAD: "POWR_BAD",
+    HVPS_LOOP_STATUS_GAPV_BAD: "GAPV_BAD",
+    HVPS_LOOP_STATUS_GAPV_TOL: "GAPV_TOL",
+    HVPS_LOOP_STATUS_VOLT_LIM: "VOLT_LIM",
+    HVPS_LOOP_STATUS_STN_OFF: "STN_OFF",
+    HVPS_LOOP_STATUS_VOLT_TOL: "VOLT_TOL",
+    HVPS_LOOP_STATUS_VOLT_BAD: "VOLT_BAD",
+}
+
+
+@dataclass
+class LoopParams:
+    """rf_hvps_loop tuning inputs (compile-time constants and PV values)."""
+    max_interval: float = HVPS_LOOP_SLOW_PERIOD   # HVPS_LOOP_SLOW_PERIOD (s)
+    delta_proc_voltage_up: float = 0.05           # {STN}:HVPS:LOOP:VOLTUP (kV)
+    delta_proc_voltage_down: float = -0.25        # {STN}:HVPS:LOOP:VOLTDOWN (kV)
+    allowed_hvps_voltage_diff: float = 2.0        # {STN}:HVPS:LOOP:VOLTDIFF (kV)
+    max_hvps_voltage: float = 82.0                # {STN}:HVPS:VOLT:CTRL.DRVH (kV)
+    min_hvps_voltage: float = 50.0                # {STN}:HVPS:VOLT:MIN (kV)
+    max_klystron_forward_power: float = 1100.0    # {STN}:KLYSOUTFRWD:POWER:MAX (kW)
+    cond_ctrl: bool = False                       # {STN}:HVPS:COND:CTRL
+    cond_horizon: float = HVPS_LOOP_COND_HORIZON  # HVPS_LOOP_COND_HORIZON (s)
+    cond_decades: float = HVPS_LOOP_COND_DECADES  # HVPS_LOOP_COND_DECADES
+    cond_fraction: float = HVPS_LOOP_COND_FRACTION  # HVPS_LOOP_COND_FRACTION
+    cond_step_max: float = HVPS_LOOP_COND_STEP_MAX  # HVPS_LOOP_COND_STEP_MAX
+
+
+@dataclass
+class PlantParams:
+    """Loop-timescale plant, load and cavity parameters."""
+    # HVPS
+    tau_s: float = 0.05                  # Closed-loop regulator time constant
+    soft_start_s: float = 5.0            # RegulatorBoard soft-start
+    readback_noise_kv: float = 0.05      # {STN}:HVPS:VOLT noise (1σ)
+    setpoint_map_kv: Optional[tuple] = None  # (setpoints, outputs) from calibrate_plant
+    # Klystron
+    efficiency: float = 0.6              # RF out / beam power
+    arc_rate_per_hour: Optional[float] = None  # At arc_ref_kv; None = KlystronLoadConfig
+    arc_ref_kv: float = 77.0
+    arc_scale_kv: float = 3.0            # e-folding of arc rate with voltage
+    # Cavities
+    n_cavities: int = 4
+    gap_kv_per_sqrt_kw: float = 50.0     # Gap voltage per cavity = k √P_cav
+    max_gap_voltage_kv: float = 850.0    # {STN}:CAVVOLT:CHECK MAJOR above
+    base_pressure: float = 2e-10         # Torr
+    outgas_per_kw: float = 2e-11         # Torr/kW, unconditioned
+    conditioning_kwh: float = 150.0      # e-folding RF energy per cavity
+    pump_tau_s: float = 3.0
+    burst_rate_per_hour: float = 20.0    # At the conditioned power level
+    burst_scale_kw: float = 10.0         # e-folding of burst rate with power
+    conditioned_kw: float = 200.0        # Per-cavity conditioned level at start
+    conditioning_kw_per_kwh: float = 0.5 # Conditioned level rise per kWh
+    burst_factor: float = 30.0           # Pressure multiplier of a burst
+    vacuum_check: float = 2e-9           # {STN}:CAVVACM:CHECK MAJOR above
+    vacuum_trip: float = 2e-8            # Vacuum interlock trips station
+    cavity_spread: float = 0.15          # Relative spread of cavity outgassing
+
+
+@dataclass
+class Scenario:
+    """Co-simulation run description."""
+    duration: float = 3600.0             # Virtual time (s)
+    target_kv: float = 77.0              # For time-to-target and overshoot
+    ready_interval: Optional[float] = 0.5  # {STN}:HVPS:LOOP:READY period; None = no monitor
+    restart_delay: float = 30.0          # Trip to station turn-on (s)
+    turn_on_wait: float = 6.0            # HVPSONSUB readback wait (s)
+    seed: int = 0
+    plant: PlantParams = field(default_factory=PlantParams)
+
+
+class CondTrend:
+    """rfCondTrend: sliding least-squares trend of one reading."""
+
+    def __init__(self, logy: bool):
+        self.logy = logy
+        self.t: List[float] = []
+        self.y: List[float] = []
+
+    def add(self, t: float, value: float) -> bool:
+        """rfCondAdd(); readings that can't be logged are dropped."""
+        if self.logy:
+            if not value > 0.0:
+                return False
+            value = math.log10(value)
+        self.t.append(t)
+        self.y.append(value)
+        if len(self.t) > RF_COND_WINDOW:
+            del self.t[0], self.y[0]
+        return True
+
+    def forecast(self, horizon: float) -> Optional[tuple]:
+        """rfCondForecast(): (rate per second, forecast) or None."""
+        n = len(self.t)
+        if n < RF_COND_MIN_POINTS:
+            return None
+        dt = np.array(self.t) - self.t[-1]
+        y = np.array(self.y)
+        den = n * np.dot(dt, dt) - dt.sum() ** 2
+        if den <= 0.0:
+            return None
+        slope = (n * np.dot(dt, y) - dt.sum() * y.sum()) / den
+        fcst = (y.sum() - slope * dt.sum()) / n + slope * horizon
+        return float(slope), float(10.0 ** fcst if self.logy else fcst)
+
+
+def cond_scale(vacm_fcst: float, vacm_limit: float, decades: float,
+               gapv_fcst: float, gapv_limit: float, fraction: float,
+               step_max: float) -> float:
+    """rfCondScale(): step scale from the smaller forecast headroom."""
+    rooms = []
+    if vacm_limit > 0.0 and vacm_fcst > 0.0 and decades > 0.0:
+        rooms.append((math.log10(vacm_limit) - math.log10(vacm_fcst)) / decades)
+    if gapv_limit > 0.0 and fraction > 0.0:
+        rooms.append((gapv_limit - gapv_fcst) / (fraction * gapv_limit))
+    if not rooms:
+        return 1.0
+    return max(min(rooms + [step_max]), -1.0)
+
+
+def cond_delta(scale: float, up: float, down: float) -> float:
+    """rfCondDelta()."""
+    if scale > 0.0:
+        return up * scale
+    return down * -scale * RF_COND_PREDOWN_FRAC
+
+
+class HVPSLoop:
+    """rf_hvps_loop ``proc`` state and its macros.
+
+    Variables keep the sequence names; ``inputs`` supplies the monitored
+    PVs for one cycle.
+    """
+
+    def __init__(self, params: LoopParams):
+        self.p = params
+        self.hvps_loop_state = HVPS_LOOP_STATE_OFF
+        self.hvps_loop_status = HVPS_LOOP_STATUS_STN_OFF
+        self.prev_hvps_loop_status = self.hvps_loop_status
+        self.volt_tol_count = 0
+        self.prev_requested_hvps_voltage = 0.0
+        self.delta_hvps_voltage = 0.0
+        self.status_changes = 0
+        self.volt_tol_events = 0
+        self.cond_vacm = CondTrend(True)
+        self.cond_gapv = CondTrend(False)
+        self.cond_scale = 1.0
+
+    def enter_proc(self, readback_hvps_voltage: float):
+        """state off → state proc."""
+        self.hvps_loop_state = HVPS_LOOP_STATE_PROC
+        self.prev_requested_hvps_voltage = readback_hvps_voltage
+        self.volt_tol_count = 0
+        self.cond_vacm = CondTrend(True)     # HVPS_LOOP_COND_RESET()
+        self.cond_gapv = CondTrend(False)
+
+    def cond_update(self, inputs: Dict):
+        """HVPS_LOOP_COND_UPDATE(), less the PV writes."""
+        p = self.p
+        t = inputs['time']
+        self.cond_vacm.add(t, inputs['max_pressure'])
+        self.cond_gapv.add(t, inputs['gap_voltage_kv'])
+        vacm = self.cond_vacm.forecast(p.cond_horizon)
+        gapv = self.cond_gapv.forecast(p.cond_horizon)
+        self.cond_scale = cond_scale(
+            vacm[1] if vacm else inputs['max_pressure'],
+            inputs['cavity_vacuum_limit'] if vacm else 0.0, p.cond_decades,
+            gapv[1] if gapv else inputs['gap_voltage_kv'],
+            inputs['gap_voltage_limit'] if gapv else 0.0, p.cond_fraction,
+            p.cond_step_max)
+
+    def station_off(self):
+        """state proc → state off on STATION_OFF/PARK."""
+        self.hvps_loop_state = HVPS_LOOP_STATE_OFF
+        self.hvps_loop_status = HVPS_LOOP_STATUS_STN_OFF
+        self.check_status()
+
+    def proc_cycle(self, inputs: Dict, requested_hvps_voltage: float) -> float:
+        """One pass of the proc ``when (efTestAndClear(...) || delay(...))``.
+
+        Returns the new requested HVPS voltage.
+        """
+        p = self.p
+        if inputs['rfp_invalid']:
+            self.hvps_loop_status = HVPS_LOOP_STATUS_RFP_BAD
+        elif inputs['power_invalid']:
+            self.hvps_loop_status = HVPS_LOOP_STATUS_POWR_BAD
+        elif inputs['gap_invalid']:
+            self.hvps_loop_status = HVPS_LOOP_STATUS_GAPV_BAD
+        elif inputs['vacuum_invalid']:
+            self.hvps_loop_status = HVPS_LOOP_STATUS_VACM_BAD
+        elif inputs['readback_invalid']:
+            self.hvps_loop_status = HVPS_LOOP_STATUS_VOLT_BAD
+        else:
+            self.cond_update(inputs)
+            if ((inputs['klystron_forward_power'] > p.max_klystron_forward_power) or
+                    inputs['gap_voltage_major'] or inputs['cavity_vacuum_major']):
+                self.delta_hvps_voltage = p.delta_proc_voltage_down
+            elif p.cond_ctrl:
+                self.delta_hvps_voltage = cond_delta(
+                    self.cond_scale, p.delta_proc_voltage_up,
+                    p.delta_proc_voltage_down)
+            else:
+                self.delta_hvps_voltage = p.delta_proc_voltage_up
+            requested_hvps_voltage = self.set_voltage(
+                requested_hvps_voltage, inputs['readback_hvps_voltage'])
+        self.check_status()
+        return requested_hvps_voltage
+
+    def set_voltage(self, requested_hvps_voltage: float,
+                    readback_hvps_voltage: float) -> float:
+        """HVPS_LOOP_SET_VOLTAGE()."""
+        p = self.p
+        requested_hvps_voltage += self.delta_hvps_voltage
+        self.hvps_loop_status = HVPS_LOOP_STATUS_GOOD
+        if requested_hvps_voltage > p.max_hvps_voltage:
+            self.hvps_loop_status = HVPS_LOOP_STATUS_VOLT_LIM
+            if self.delta_hvps_voltage > 0:
+                requested_hvps_voltage = p.max_hvps_voltage
+        elif (requested_hvps_voltage < p.min_hvps_voltage and
+              self.delta_hvps_voltage <= 0):
+            requested_hvps_voltage = p.min_hvps_voltage
+        if (abs(readback_hvps_voltage - self.prev_requested_hvps_voltage) >
+                p.allowed_hvps_voltage_diff):
+            requested_hvps_voltage = self.prev_requested_hvps_voltage
+            self.volt_tol_events += 1
+            if self.volt_tol_count > HVPS_LOOP_MAX_VOLT_TOL:
+                self.hvps_loop_status = HVPS_LOOP_STATUS_VOLT_TOL
+            else:
+                self.volt_tol_count += 1
+        else:
+            self.volt_tol_count = 0
+        self.prev_requested_hvps_voltage = requested_hvps_voltage
+        return requested_hvps_voltage
+
+    def check_status(self):
+        """HVPS_LOOP_CHECK_STATUS(), less the PV writes."""
+        if self.prev_hvps_loop_status != self.hvps_loop_status:
+            self.prev_hvps_loop_status = self.hvps_loop_status
+            self.status_changes += 1
+
+
+class StationPlant:
+    """HVPS, klystron and cavities at loop timescales."""
+
+    def __init__(self, plant: PlantParams, config: HVPSConfig,
+                 rng: np.random.Generator):
+        self.pp = plant
+        self.rng = rng
+        self.klystron = KlystronLoad(config)
+        self.protection = ProtectionManager(config)
+        self.arc_rate = (plant.arc_rate_per_hour
+                         if plant.arc_rate_per_hour is not None
+                         else config.klystron.arc_probability_per_hour) / 3600.0
+
+        self.on = False
+        self.on_time = 0.0
+        self.requested_kv = 0.0
+        self.v_kv = 0.0
+        n = plant.n_cavities
+        self.outgas = 1.0 + plant.cavity_spread * rng.standard_normal(n)
+        self.dose_kwh = np.zeros(n)
+        self.cond_kw = np.full(n, plant.conditioned_kw)
+        self.pressure = np.full(n, plant.base_pressure)
+        self.burst = np.zeros(n)
+
+    def output_kv(self, requested_kv: float) -> float:
+        """Static setpoint → output map."""
+        if self.pp.setpoint_map_kv is None:
+            return requested_kv
+        sp, out = self.pp.setpoint_map_kv
+        return float(np.interp(requested_kv, sp, out))
+
+    def turn_on(self, t: float, requested_kv: float):
+        self.on = True
+        self.on_time = t
+        self.requested_kv = requested_kv
+        self.protection.master_reset(t)
+
+    def turn_off(self):
+        self.on = False
+        self.requested_kv = 0.0
+
+    def beam_current(self, t: float) -> float:
+        return self.klystron.current(self.v_kv * 1000.0, t)
+
+    def forward_power_kw(self, t: float) -> float:
+        return self.pp.efficiency * self.v_kv * self.beam_current(t)
+
+    def advance(self, t0: float, t1: float) -> Optional[str]:
+        """Advance the plant from t0 to t1. Returns a trip cause or None."""
+        pp = self.pp
+        dt = t1 - t0
+        if dt <= 0:
+            return None
+
+        # HVPS output: first-order lag to the (soft-started) static map
+        if self.on:
+            ss = min((t1 - self.on_time) / pp.soft_start_s, 1.0)
+            target = self.output_kv(self.requested_kv) * ss
+        else:
+            target = 0.0
+        self.v_kv = target + (self.v_kv - target) * math.exp(-dt / pp.tau_s)
+
+        # Cavity vacuum and conditioning
+        p_cav = self.forward_power_kw(t1) / pp.n_cavities if self.on else 0.0
+        self.dose_kwh += p_cav * dt / 3600.0
+        self.cond_kw = pp.conditioned_kw + pp.conditioning_kw_per_kwh * self.dose_kwh
+        decay = math.exp(-dt / pp.pump_tau_s)
+        rate = (pp.burst_rate_per_hour / 3600.0 *
+                np.exp((p_cav - self.cond_kw) / pp.burst_scale_kw)) if p_cav > 0 \
+            else np.zeros(pp.n_cavities)
+        bursts = self.rng.random(pp.n_cavities) < -np.expm1(-rate * dt)
+        self.burst = self.burst * decay + bursts * (pp.burst_factor - 1.0)
+        gas = (pp.outgas_per_kw * p_cav * self.outgas *
+               np.exp(-self.dose_kwh / pp.conditioning_kwh))
+        self.pressure = (pp.base_pressure + gas) * (1.0 + self.burst)
+
+        if not self.on:
+            return None
+
+        # Klystron arc → crowbar sequence through the protection manager
+        rate = self.arc_rate * math.exp((self.v_kv - pp.arc_ref_kv) / pp.arc_scale_kv)
+        if self.rng.random() < -math.expm1(-rate * dt):
+            t_arc = t0 + self.rng.random() * dt
+            self.klystron.trigger_arc(t_arc)
+            self.protection.force_arc(t_arc)
+            step = 1e-3
+            t = t_arc
+            while self.protection.state != ProtectionState.NORMAL and t < t_arc + 1.0:
+                self.protection.update(t, self.v_kv * 1000.0, self.beam_current(t), step)
+                t += step
+            return 'arc'
+
+        # HVPS interlocks (overvoltage / overcurrent latch → TRIPPED)
+        status = self.protection.update(t1, self.v_kv * 1000.0,
+                                        self.beam_current(t1), dt)
+        self.protection.arc_detector.reset()
+        if status.state == ProtectionState.TRIPPED:
+            return 'interlock'
+
+        if np.max(self.pressure) > pp.vacuum_trip:
+            return 'vacuum'
+        return None
+
+    def inputs(self, t: float) -> Dict:
+        """Monitored PVs as seen by rf_hvps_loop."""
+        pp = self.pp
+        p_fwd = self.forward_power_kw(t)
+        gap = pp.gap_kv_per_sqrt_kw * math.sqrt(max(p_fwd / pp.n_cavities, 0.0))
+        return {
+            'rfp_invalid': False,
+            'power_invalid': False,
+            'gap_invalid': False,
+            'vacuum_invalid': False,
+            'readback_invalid': False,
+            'readback_hvps_voltage': self.v_kv + pp.readback_noise_kv *
+            self.rng.standard_normal(),
+            'klystron_forward_power': p_fwd,
+            'gap_voltage_kv': gap,
+            'gap_voltage_major': gap > pp.max_gap_voltage_kv,
+            'cavity_vacuum_major': bool(np.max(self.pressure) > pp.vacuum_check),
+            'max_pressure': float(np.max(self.pressure)),
+            'gap_voltage_limit': pp.max_gap_voltage_kv,
+            'cavity_vacuum_limit': pp.vacuum_check,
+            'time': t,
+        }
+
+
+@dataclass
+class CoSimResult:
+    """Loop-cycle traces and figures of merit for one co-simulation."""
+    params: LoopParams = field(default_factory=LoopParams)
+    scenario: Scenario = field(default_factory=Scenario)
+    # Per loop cycle
+    time: np.ndarray = field(default_factory=lambda: np.array([]))
+    requested_kv: np.ndarray = field(default_factory=lambda: np.array([]))
+    readback_kv: np.ndarray = field(default_factory=lambda: np.array([]))
+    forward_power_kw: np.ndarray = field(default_factory=lambda: np.array([]))
+    gap_voltage_kv: np.ndarray = field(default_factory=lambda: np.array([]))
+    max_pressure: np.ndarray = field(default_factory=lambda: np.array([]))
+    status: np.ndarray = field(default_factory=lambda: np.array([], dtype=np.int8))
+    # Events
+    trips: List[tuple] = field(default_factory=list)   # (time, cause)
+    volt_tol_events: int = 0
+    status_changes: int = 0
+
+    def time_to_target(self, tol_kv: float = 0.5) -> float:
+        """Virtual time until the readback first reaches target (s), or NaN."""
+        hit = np.nonzero(self.readback_kv >= self.scenario.target_kv - tol_kv)[0]
+        return float(self.time[hit[0]]) if len(hit) else float('nan')
+
+    def metrics(self) -> Dict[str, float]:
+        """Time-to-target, overshoot, trips and loop activity."""
+        target = self.scenario.target_kv
+        t_hit = self.time_to_target()
+        after = self.time >= t_hit if not math.isnan(t_hit) else np.zeros(0, bool)
+        overshoot = (float(np.max(self.readback_kv[after]) - target)
+                     if np.any(after) else 0.0)
+        p_max = self.params.max_klystron_forward_power
+        causes = [c for _, c in self.trips]
+        return {
+            'time_to_target_s': t_hit,
+            'overshoot_kv': max(overshoot, 0.0),
+            'power_overshoot_pct': max(float(np.max(self.forward_power_kw,
+                                                    initial=0.0)) / p_max - 1.0,
+                                       0.0) * 100.0,
+            'trips': len(self.trips),
+            'arc_trips': causes.count('arc'),
+            'vacuum_trips': causes.count('vacuum'),
+            'interlock_trips': causes.count('interlock'),
+            'volt_tol_events': self.volt_tol_events,
+            'final_kv': float(self.readback_kv[-1]) if len(self.readback_kv) else 0.0,
+            'cycles': len(self.time),
+        }
+
+    def summary(self) -> str:
+        m = self.metrics()
+        p = self.params
+        lines = [
+            "HVPS Loop Co-Simulation",
+            "=" * 45,
+            f"Virtual time:   {self.scenario.duration/3600.0:.2f} h "
+            f"({m['cycles']} loop cycles)",
+            f"Loop:           up {p.delta_proc_voltage_up:+.3f} kV, "
+            f"down {p.delta_proc_voltage_down:+.3f} kV, "
+            f"diff {p.allowed_hvps_voltage_diff:.2f} kV, "
+            f"max interval {p.max_interval:.1f} s, "
+            f"cond {'on' if p.cond_ctrl else 'off'}",
+            f"Time to target: {m['time_to_target_s']:.1f} s "
+            f"({self.scenario.target_kv:.1f} kV)",
+            f"Overshoot:      {m['overshoot_kv']:.2f} kV, "
+            f"forward power {m['power_overshoot_pct']:.1f}%",
+            f"Trips:          {m['trips']} (arc {m['arc_trips']}, "
+            f"vacuum {m['vacuum_trips']}, interlock {m['interlock_trips']})",
+            f"Volt tolerance: {m['volt_tol_events']} held steps",
+            f"Final readback: {m['final_kv']:.2f} kV",
+        ]
+        return "\n".join(lines)
+
+
+def run_cosim(params: Optional[LoopParams] = None,
+              scenario: Optional[Scenario] = None,
+              config: Optional[HVPSConfig] = None) -> CoSimResult:
+    """Run the loop against the plant for ``scenario.duration`` virtual seconds.
+
+    The virtual clock jumps from one loop wake-up to the next; the plant
+    is advanced analytically over each interval.
+    """
+    params = params or LoopParams()
+    scenario = scenario or Scenario()
+    config = config or HVPSConfig()
+    rng = np.random.default_rng(scenario.seed)
+
+    loop = HVPSLoop(params)
+    plant = StationPlant(scenario.plant, config, rng)
+    if scenario.ready_interval is not None:
+        period = min(scenario.ready_interval, params.max_interval)
+    else:
+        period = params.max_interval
+
+    rows = []
+    trips = []
+    t = 0.0
+    # Station turn-on at t=0 (HVPSONSUB) and loop entry once the station is ON
+    plant.turn_on(t, params.min_hvps_voltage)
+    proc_at = t + scenario.turn_on_wait
+    restart_at = None
+
+    while t < scenario.duration:
+        if restart_at is not None:
+            t_next = restart_at
+        elif proc_at is not None:
+            t_next = proc_at
+        else:
+            t_next = t + period
+        t_next = min(t_next, scenario.duration)
+        cause = plant.advance(t, t_next)
+        t = t_next
+
+        if cause is not None:
+            # s_go_off: requested voltage to zero, station OFF
+            trips.append((t, cause))
+            plant.turn_off()
+            loop.station_off()
+            restart_at = t + scenario.restart_delay
+            proc_at = None
+            continue
+
+        if restart_at is not None and t >= restart_at:
+            restart_at = None
+            plant.turn_on(t, params.min_hvps_voltage)
+            proc_at = t + scenario.turn_on_wait
+            continue
+
+        if proc_at is not None:
+            if t >= proc_at:
+                proc_at = None
+                loop.enter_proc(plant.inputs(t)['readback_hvps_voltage'])
+            continue
+
+        inputs = plant.inputs(t)
+        plant.requested_kv = loop.proc_cycle(inputs, plant.requested_kv)
+        rows.append((t, plant.requested_kv, inputs['readback_hvps_voltage'],
+                     inputs['klystron_forward_power'], inputs['gap_voltage_kv'],
+                     inputs['max_pressure'], loop.hvps_loop_status))
+
+    data = np.array(rows) if rows else np.zeros((0, 7))
+    return CoSimResult(
+        params=params, scenario=scenario,
+        time=data[:, 0], requested_kv=data[:, 1], readback_kv=data[:, 2],
+        forward_power_kw=data[:, 3], gap_voltage_kv=data[:, 4],
+        max_pressure=data[:, 5], status=data[:, 6].astype(np.int8),
+        trips=trips, volt_tol_events=loop.volt_tol_events,
+        status_changes=loop.status_changes)
+
+
+def calibrate_plant(config: Optional[HVPSConfig] = None,
+                    setpoints_kv: Sequence[float] = tuple(range(40, 90, 5)),
+                    duration: float = 8.0, workers: Optional[int] = None) -> tuple:
+    """Measure the static setpoint → output map with the batch engine.
+
+    Returns ``(setpoints, outputs)`` in kV for PlantParams.setpoint_map_kv.
+    """
+    from hvps.simulation.hvps_sim.engine import BatchCase, run_batch
+    cases = [BatchCase(voltage_kv=v) for v in setpoints_kv]
+    res = run_batch(cases, duration, config=config, dt=200e-6,
+                    startup_delay=0.2, record_every=25, workers=workers)
+    tail = res.time >= duration - 1.5
+    outputs = np.mean(np.abs(res.voltage_kv[:, tail]), axis=1)
+    return (np.asarray(setpoints_kv, dtype=float), outputs)
+
+
+def _run_one(args) -> CoSimResult:
+    """Worker entry point for :func:`sweep_loop`."""
+    params, scenario, config = args
+    return run_cosim(params, scenario, config)
+
+
+def sweep_loop(grid: Dict[str, Sequence], scenario: Optional[Scenario] = None,
+               base: Optional[LoopParams] = None,
+               config: Optional[HVPSConfig] = None,
+               workers: Optional[int] = None) -> List[CoSimResult]:
+    """Run the cartesian product of a LoopParams grid across processes.
+
+    Parameters
+    ----------
+    grid : dict
+        Maps LoopParams field names to values, e.g.
+        ``{'max_interval': [2, 5, 10], 'allowed_hvps_voltage_diff': [1, 2]}``.
+    scenario : Scenario, optional
+        Shared run description (same seed for every case).
+    base : LoopParams, optional
+        Values of the fields not being swept.
+    workers : int, optional
+        Worker processes (default: one per CPU).
+    """
+    scenario = scenario or Scenario()
+    base = base or LoopParams()
+    valid = {f.name for f in fields(LoopParams)}
+    for name in grid:
+        if name not in valid:
+            raise ValueError(f"Unknown loop parameter: {name}")
+    names = list(grid)
+    jobs = [(replace(base, **dict(zip(names, values))), scenario, config)
+            for values in itertools.product(*(grid[k] for k in names))]
+    if workers is None:
+        workers = os.cpu_count() or 1
+    workers = max(1, min(workers, len(jobs)))
+    if workers == 1:
+        return [_run_one(job) for job in jobs]
+    with ProcessPoolExecutor(max_workers=workers) as pool:
+        return list(pool.map(_run_one, jobs))
+
+
+def format_sweep(results: Sequence[CoSimResult]) -> str:
+    """One-line-per-case table of sweep metrics."""
+    lines = [
+        f"{'#':>3}  {'up':>6} {'down':>6} {'diff':>5} {'maxint':>6} {'cond':>4}  "
+        f"{'t_target':>9} {'ovs kV':>6} {'P ovs%':>6} {'trips':>5} "
+        f"{'arc':>4} {'vac':>4} {'final':>6}",
+    ]
+    for k, r in enumerate(results):
+        p, m = r.params, r.metrics()
+        lines.append(
+            f"{k:3d}  {p.delta_proc_voltage_up:6.3f} {p.delta_proc_voltage_down:6.3f} "
+            f"{p.allowed_hvps_voltage_diff:5.2f} {p.max_interval:6.1f} "
+            f"{'on' if p.cond_ctrl else 'off':>4}  "
+            f"{m['time_to_target_s']:9.1f} {m['overshoot_kv']:6.2f} "
+            f"{m['power_overshoot_pct']:6.1f} {m['trips']:5d} "
+            f"{m['arc_trips']:4d} {m['vacuum_trips']:4d} {m['final_kv']:6.2f}")
+    return "\n".join(lines)
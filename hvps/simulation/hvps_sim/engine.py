@@ -0,0 +1,600 @@
+"""
+Vectorized Batch Engine
+=======================
+
+Array-based implementation of the HVPSSimulator time-stepping loop.
+Every state variable of the control, protection and power models is held
+as a NumPy array with one element per case, so a whole family of cases
+(firing angle, filter L/C, arc timing, setpoint) advances in lockstep
+through a single pass of the time loop.
+
+The per-step arithmetic follows the object models exactly:
+
+    PLCController.scan          -- Rung 104/108/109 integer filter
+    RegulatorBoard.compute      -- PI with soft-start and trips
+    EnerproFiringBoard.update   -- first-order PLL lag, inhibit/release
+    ProtectionManager.update    -- arc detect, crowbar, turn-off, recovery
+    PowerConversionChain.compute -- 12-pulse bridges, LC filter, klystron
+
+Quantities that depend only on time (AC line-to-line peaks, bridge ripple
+shape) are precomputed once as vectors. The single-sample
+``filtering.LCFilter.filter_ripple`` pass applied in ``HVPSSimulator._step``
+is an identity (state is reset to the input before one Euler step) and is
+therefore omitted.
+
+Larger sweeps are split into chunks and distributed across processes
+with :func:`run_sweep`.
+
+Usage:
+    from hvps.simulation.hvps_sim.engine import BatchCase, run_sweep
+
+    result = run_sweep({'inductor_h': [0.2, 0.3, 0.4],
+                        'arc_time': [None, 2.0]}, duration=4.0)
+    print(result.summary())
+"""
+
+import itertools
+import os
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass, field, fields, replace
+from typing import Dict, List, Optional, Sequence
+
+import numpy as np
+
+from hvps.simulation.hvps_sim.config import HVPSConfig
+from hvps.simulation.hvps_sim.protection import ProtectionState
+
+# Integer codes used in the batch arrays (match the enum values)
+_NORMAL = ProtectionState.NORMAL.value
+_CROWBAR_FIRING = ProtectionState.CROWBAR_FIRING.value
+_THYRISTOR_TURNOFF = ProtectionState.THYRISTOR_TURNOFF.value
+_RECOVERING = ProtectionState.RECOVERING.value
+_TRIPPED = ProtectionState.TRIPPED.value
+
+# SystemMode values (simulator.SystemMode, kept local to avoid the
+# simulator's filtering/thyristor model imports in worker processes)
+MODE_OFF = 1
+MODE_STARTUP = 2
+MODE_REGULATING = 3
+MODE_FAULT = 4
+
+
+@dataclass
+class BatchCase:
+    """One case of a batch run.
+
+    Fields left as ``None`` take their value from the shared HVPSConfig.
+    """
+    voltage_kv: float = 77.0                  # Setpoint magnitude (kV)
+    firing_angle_deg: Optional[float] = None  # Fixed α (open loop); None = closed loop
+    inductor_h: Optional[float] = None        # L1 = L2 (H)
+    capacitor_uf: Optional[float] = None      # Filter capacitor (µF)
+    damping_ohm: Optional[float] = None       # Isolation resistance (Ω)
+    arc_time: Optional[float] = None          # Arc event time (s); None = no arc
+    arc_duration_us: float = 50.0             # Arc duration (µs)
+
+
+@dataclass
+class BatchResult:
+    """Time series for every case of a batch run.
+
+    Arrays are shaped (n_cases, n_samples); samples are taken every
+    ``record_every`` time steps.
+    """
+    cases: List[BatchCase] = field(default_factory=list)
+    time: np.ndarray = field(default_factory=lambda: np.array([]))
+    dt: float = 0.0
+    duration: float = 0.0
+
+    voltage_kv: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    current_a: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    firing_angle_deg: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    n7_10_ref: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    i_inductor1_a: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    crowbar_active: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    arc_energy_j: np.ndarray = field(default_factory=lambda: np.zeros((0, 0)))
+    protection_state: np.ndarray = field(default_factory=lambda: np.zeros((0, 0), dtype=np.int8))
+    mode: np.ndarray = field(default_factory=lambda: np.zeros((0, 0), dtype=np.int8))
+
+    def metrics(self) -> Dict[str, np.ndarray]:
+        """Per-case figures of merit (one array element per case).
+
+        Steady-state values use the last 25% of the record; ripple is
+        reported as zero for cases not energized above 1 kV.
+        """
+        n_ss = max(1, self.voltage_kv.shape[1] // 4)
+        v_ss = np.abs(self.voltage_kv[:, -n_ss:])
+        v_mean = np.mean(v_ss, axis=1)
+        with np.errstate(invalid='ignore', divide='ignore'):
+            ripple_pct = np.where(v_mean > 1.0,
+                                  (np.max(v_ss, axis=1) - np.min(v_ss, axis=1))
+                                  / v_mean * 100.0, 0.0)
+        fault = self.protection_state != _NORMAL
+        return {
+            'final_voltage_kv': v_mean,
+            'final_current_a': np.mean(self.current_a[:, -n_ss:], axis=1),
+            'ripple_pp_pct': ripple_pct,
+            'peak_voltage_kv': np.max(np.abs(self.voltage_kv), axis=1),
+            'max_arc_energy_j': np.max(self.arc_energy_j, axis=1),
+            'fault_time_s': np.sum(fault, axis=1) * (self.time[1] - self.time[0]
+                                                      if len(self.time) > 1 else 0.0),
+            'tripped': self.protection_state[:, -1] == _TRIPPED,
+        }
+
+    def summary(self) -> str:
+        """Return a one-line-per-case table of the batch metrics."""
+        m = self.metrics()
+        lines = [
+            "SPEAR3 HVPS Batch Results",
+            "=" * 78,
+            f"{len(self.cases)} cases, {self.duration:.3f} s, "
+            f"dt = {self.dt*1e6:.1f} µs",
+            "",
+            f"{'#':>3}  {'V set':>6} {'α fix':>6} {'L (H)':>6} {'C (µF)':>7} "
+            f"{'arc t':>6}  {'V out':>7} {'ripple%':>8} {'E arc':>7} {'trip':>5}",
+        ]
+        for k, c in enumerate(self.cases):
+            lines.append(
+                f"{k:3d}  {c.voltage_kv:6.1f} "
+                f"{'-' if c.firing_angle_deg is None else f'{c.firing_angle_deg:.1f}':>6} "
+                f"{'-' if c.inductor_h is None else f'{c.inductor_h:.3f}':>6} "
+                f"{'-' if c.capacitor_uf is None else f'{c.capacitor_uf:.2f}':>7} "
+                f"{'-' if c.arc_time is None else f'{c.arc_time:.2f}':>6}  "
+                f"{m['final_voltage_kv'][k]:7.2f} {m['ripple_pp_pct'][k]:8.3f} "
+                f"{m['max_arc_energy_j'][k]:7.2f} "
+                f"{'yes' if m['tripped'][k] else 'no':>5}")
+        return "\n".join(lines)
+
+    @staticmethod
+    def concatenate(parts: Sequence['BatchResult']) -> 'BatchResult':
+        """Join results of the same time base along the case axis."""
+        out = BatchResult(time=parts[0].time, dt=parts[0].dt,
+                          duration=parts[0].duration)
+        out.cases = [c for p in parts for c in p.cases]
+        for f in fields(BatchResult):
+            value = getattr(parts[0], f.name)
+            if isinstance(value, np.ndarray) and value.ndim == 2:
+                setattr(out, f.name,
+                        np.concatenate([getattr(p, f.name) for p in parts]))
+        return out
+
+
+class BatchEngine:
+    """Lockstep array implementation of HVPSSimulator for many cases.
+
+    Parameters
+    ----------
+    config : HVPSConfig, optional
+        Shared configuration; per-case overrides come from ``cases``.
+    cases : sequence of BatchCase
+        Cases to advance together.
+    dt : float
+        Time step (s). Default 100 µs, as HVPSSimulator.
+    """
+
+    def __init__(self, config: Optional[HVPSConfig] = None,
+                 cases: Sequence[BatchCase] = (BatchCase(),),
+                 dt: float = 100e-6):
+        self.config = config or HVPSConfig()
+        self.cases = list(cases)
+        self.dt = dt
+        cfg = self.config
+        n = len(self.cases)
+
+        def per_case(attr, default):
+            return np.array([default if getattr(c, attr) is None
+                             else getattr(c, attr) for c in self.cases],
+                            dtype=float)
+
+        # Per-case parameters
+        self.voltage_kv = np.array([abs(c.voltage_kv) for c in self.cases])
+        self.open_loop = np.array([c.firing_angle_deg is not None
+                                   for c in self.cases])
+        self.fixed_angle = per_case('firing_angle_deg', 0.0)
+        self.L = per_case('inductor_h', cfg.filter.inductor_l1_h)
+        self.C = per_case('capacitor_uf', cfg.filter.capacitor_uf) * 1e-6
+        self.R_damp = per_case('damping_ohm', cfg.filter.isolation_resistance)
+        self.arc_time = per_case('arc_time', np.inf)
+        self.arc_duration = np.array([c.arc_duration_us * 1e-6
+                                      for c in self.cases])
+        self.n = n
+
+    # ---- Time-only quantities ----
+
+    def _line_peaks(self, t: np.ndarray) -> tuple:
+        """Bridge-input line-to-line peaks for T1 and T2 over a time vector.
+
+        Same arithmetic as ACSource, PhaseShiftTransformer and
+        RectifierTransformer in power.py.
+        """
+        cfg = self.config
+        v_pk = cfg.ac_input.voltage_peak
+        w = cfg.ac_input.omega
+        v_a = v_pk * np.sin(w * t)
+        v_b = v_pk * np.sin(w * t - 2 * np.pi / 3)
+        v_c = v_pk * np.sin(w * t + 2 * np.pi / 3)
+
+        eff0 = 1.0 - (cfg.phase_shift_xfmr.copper_loss_pu +
+                      cfg.phase_shift_xfmr.core_loss_pu)
+        eff1 = 1.0 - (cfg.rect_xfmr.copper_loss_pu + cfg.rect_xfmr.core_loss_pu)
+        ratio = 40_000.0 / (v_pk / np.sqrt(3)) * eff1
+
+        peaks = []
+        for shift in (cfg.phase_shift_xfmr.phase_shift_deg,
+                      -cfg.phase_shift_xfmr.phase_shift_deg):
+            cs, sn = np.cos(np.radians(shift)), np.sin(np.radians(shift))
+            a = eff0 * (v_a * cs - v_b * sn / np.sqrt(3)) * ratio
+            b = eff0 * (v_b * cs - v_c * sn / np.sqrt(3)) * ratio
+            c = eff0 * (v_c * cs - v_a * sn / np.sqrt(3)) * ratio
+            peaks.append(np.maximum(np.maximum(np.abs(a - b), np.abs(b - c)),
+                                    np.abs(c - a)))
+        return peaks[0], peaks[1]
+
+    # ---- Main loop ----
+
+    def run(self, duration: float, startup_delay: float = 0.5,
+            record_every: int = 1) -> BatchResult:
+        """Advance all cases from power-on reset for ``duration`` seconds.
+
+        Parameters
+        ----------
+        duration : float
+            Total simulation time (s).
+        startup_delay : float
+            Time of the shared startup event (s).
+        record_every : int
+            Decimation factor for the stored time series.
+
+        Returns
+        -------
+        BatchResult
+        """
+        cfg = self.config
+        dt = self.dt
+        n = self.n
+        n_steps = int(duration / dt)
+        t_all = np.arange(n_steps) * dt
+
+        # Time-only precomputation
+        f_line = cfg.ac_input.frequency
+        vll1, vll2 = self._line_peaks(t_all)
+        w_r = 2 * np.pi * 6 * f_line
+        ripple_shape = (np.cos(w_r * t_all) + 0.3 * np.cos(2 * w_r * t_all) +
+                        0.1 * np.cos(3 * w_r * t_all))
+        k6 = 3.0 * np.sqrt(2) / np.pi
+        scr_drop2 = 2 * cfg.thyristor_bridge.on_voltage_drop * \
+            cfg.thyristor_bridge.scrs_per_stack
+
+        # Control constants
+        plc = cfg.plc
+        ene = cfg.enerpro
+        reg = cfg.regulator
+        alpha_filt = min(dt / (3.0 / f_line), 1.0)
+        r_reg, r_plc = reg.reg_to_sighi_r, reg.plc_to_sighi_r
+        r_par = (r_reg * r_plc) / (r_reg + r_plc)
+        kp, ki = 2.0, 8.0
+        sig_span = ene.sig_hi_max_v - ene.sig_hi_min_v
+        ang_span = ene.max_delay_angle_deg - ene.min_delay_angle_deg
+        n7_30 = np.trunc(np.clip(self.voltage_kv / 85.0 * 32000, 0, 32767))
+        ref = np.maximum(n7_30, plc.ref_min_internal)
+        ref_cap = plc.ref_max_internal
+        if plc.ref_max_external > 0:
+            ref_cap = min(ref_cap, plc.ref_max_external)
+
+        # Protection constants
+        kly = cfg.klystron
+        trigger_delay = cfg.crowbar.trigger_delay_us * 1e-6
+        turnoff_time = 0.006
+        recovery_time = cfg.output.arc_recovery_ms / 1000.0
+        ilk = cfg.interlocks
+
+        # State arrays
+        zeros = lambda: np.zeros(n)
+        falses = lambda: np.zeros(n, dtype=bool)
+        n7_10, n7_11 = zeros(), zeros()
+        plc_acc, plc_last = 0.0, 0.0
+        integ = zeros()
+        ss_elapsed, ss_progress = zeros(), zeros()
+        ss_active, reg_tripped = falses(), falses()
+        angle = np.full(n, ene.max_delay_angle_deg)
+        inhibited = falses()
+        i_l1, i_l2, v_c = zeros(), zeros(), zeros()
+        arcing = falses()
+        arc_start, arc_len = zeros(), self.arc_duration.copy()
+        arc_pending = np.isfinite(self.arc_time)
+        prot = np.full(n, _NORMAL, dtype=np.int8)
+        v_prev, i_prev = zeros(), zeros()
+        cb_enabled, cb_firing = falses(), falses()
+        cb_fire_time, cb_energy = zeros(), zeros()
+        turnoff_started, turnoff_start = falses(), zeros()
+        recovery_start = zeros()
+        ilk_latched = falses()
+        mode = np.full(n, MODE_OFF, dtype=np.int8)
+        v_target = zeros()
+        regulator_on = False
+        energized = False
+
+        # Output
+        n_rec = (n_steps + record_every - 1) // record_every
+        res = BatchResult(cases=self.cases, dt=dt, duration=duration)
+        res.time = t_all[::record_every].copy()
+        for name in ('voltage_kv', 'current_a', 'firing_angle_deg',
+                     'n7_10_ref', 'i_inductor1_a', 'crowbar_active',
+                     'arc_energy_j'):
+            setattr(res, name, np.zeros((n, n_rec)))
+        res.protection_state = np.zeros((n, n_rec), dtype=np.int8)
+        res.mode = np.zeros((n, n_rec), dtype=np.int8)
+
+        for k in range(n_steps):
+            t = t_all[k]
+
+            # -- Scheduled events (HVPSSimulator._handle_event) --
+            if not energized and startup_delay <= t:
+                energized = True
+                regulator_on = True
+                v_target = self.voltage_kv * 1000.0
+                mode[:] = MODE_STARTUP
+                cb_enabled[:] = True
+                ss_active[:] = True
+                ss_elapsed[:] = 0.0
+                ss_progress[:] = 0.0
+                inhibited[:] = False
+            hit = arc_pending & (self.arc_time <= t)
+            if hit.any():
+                arc_pending &= ~hit
+                arcing |= hit
+                arc_start[hit] = t
+                prot[hit] = _CROWBAR_FIRING
+                fire = hit & cb_enabled
+                cb_firing |= fire
+                cb_fire_time[fire] = t
+                cb_energy[fire] = 0.0
+                turnoff_started[hit] = False
+                mode[hit] = MODE_FAULT
+
+            # -- Measurements from previous step --
+            v_mag = np.abs(v_c)
+            ended = arcing & (t - arc_start > arc_len)
+            arcing &= ~ended
+            i_norm = np.where(v_mag > 0,
+                              np.minimum(kly.perveance * v_mag ** 1.5,
+                                         v_mag / kly.impedance_nominal), 0.0)
+            i_out = np.where(arcing, v_mag / kly.arc_impedance, i_norm)
+
+            # -- PLC scan (Rung 104/108/109) --
+            plc_acc += t - plc_last
+            plc_last = t
+            if plc_acc >= plc.scan_period_s:
+                plc_acc -= plc.scan_period_s
+                if regulator_on:
+                    delta = np.trunc((ref - n7_10) / 10)
+                    n7_10 = np.where(delta == 0, ref, n7_10 + delta)
+                    n7_10 = np.minimum(n7_10, ref_cap)
+                    n7_11 = np.minimum(
+                        np.trunc(n7_10 * plc.phase_multiplier /
+                                 plc.phase_divisor) + plc.phase_offset,
+                        plc.phase_max)
+                else:
+                    n7_10[:] = 0.0
+                    n7_11[:] = 0.0
+
+            # -- Regulator board --
+            run_reg = ~reg_tripped
+            ss_step = run_reg & ss_active
+            ss_elapsed = np.where(ss_step, ss_elapsed + dt, ss_elapsed)
+            ss_progress = np.where(ss_step,
+                                   np.minimum(ss_elapsed / reg.soft_start_time_s, 1.0),
+                                   ss_progress)
+            ss_active &= ~(ss_step & (ss_progress >= 1.0))
+            v_set = v_target * np.where(ss_step, ss_progress, 1.0)
+            v_err = v_set - v_mag
+            over_i = i_out > reg.current_limit_a
+            v_err = np.where(over_i,
+                             np.minimum(v_err, (reg.current_limit_a - i_out) * 100.0),
+                             v_err)
+            integ = np.where(run_reg, np.clip(integ + v_err * dt, -5.0, 5.0), integ)
+            v_reg = np.where(run_reg,
+                             np.clip(kp * v_err + ki * integ, 0.0, 8.0), 0.0)
+            trip = run_reg & ((v_mag > reg.overvoltage_trip_kv * 1000) |
+                              (i_out > reg.overcurrent_trip_a))
+            reg_tripped |= trip
+            integ[trip] = 0.0
+            v_reg[trip] = 0.0
+
+            # -- Enerpro --
+            sig_hi = np.clip((v_reg / r_reg + (n7_11 / plc.dac_max * 10.0) / r_plc)
+                             * r_par, 0.0, 10.0)
+            target = np.where(
+                sig_hi < ene.sig_hi_min_v, ene.max_delay_angle_deg,
+                np.where(sig_hi > ene.sig_hi_max_v, ene.min_delay_angle_deg,
+                         ene.max_delay_angle_deg -
+                         (sig_hi - ene.sig_hi_min_v) / sig_span * ang_span))
+            angle = np.where(inhibited, ene.max_delay_angle_deg,
+                             angle + alpha_filt * (target - angle))
+            firing = np.where(self.open_loop, self.fixed_angle, angle)
+
+            # -- Protection (ProtectionManager.update) --
+            ilk_now = ((np.abs(i_out) > ilk.dc_overcurrent_a) |
+                       (v_mag > ilk.overvoltage_kv * 1000))
+            ilk_latched |= ilk_now
+            prev = prot.copy()
+            cb_active = np.zeros(n, dtype=bool)
+
+            s = prev == _NORMAL
+            if s.any():
+                energ = s & (v_prev > 1000)
+                arc = energ & ((np.abs(v_prev - v_mag) / dt > 1e9) |
+                               (v_mag < v_prev * 0.8) |
+                               ((i_prev > 0) & (i_out > i_prev * 2.0)))
+                fire = arc & cb_enabled
+                cb_firing |= fire
+                cb_fire_time[fire] = t
+                cb_energy[fire] = 0.0
+                prot[arc] = _CROWBAR_FIRING
+                prot[s & ilk_now] = _TRIPPED
+                v_prev = np.where(s, v_mag, v_prev)
+                i_prev = np.where(s, i_out, i_prev)
+
+            s = prev == _CROWBAR_FIRING
+            if s.any():
+                cond = s & cb_firing & (t - cb_fire_time >= trigger_delay)
+                cb_energy = np.where(cond, cb_energy + np.abs(v_mag * i_out) * dt,
+                                     cb_energy)
+                cb_active = cond
+                start = s & ~turnoff_started
+                turnoff_start[start] = t
+                turnoff_started |= start
+                done = s & (t - turnoff_start >= turnoff_time)
+                prot[done] = _THYRISTOR_TURNOFF
+                turnoff_started &= ~done
+
+            s = prev == _THYRISTOR_TURNOFF
+            if s.any():
+                cond = s & cb_firing & (t - cb_fire_time >= trigger_delay)
+                cb_energy = np.where(cond, cb_energy + np.abs(v_mag * i_out) * dt,
+                                     cb_energy)
+                prot[s] = _RECOVERING
+                recovery_start[s] = t
+
+            s = prev == _RECOVERING
+            if s.any():
+                done = s & (t - recovery_start >= recovery_time)
+                prot[done] = _NORMAL
+                cb_firing &= ~done
+                cb_enabled |= done
+
+            blocked = ((prot == _CROWBAR_FIRING) | (prot == _THYRISTOR_TURNOFF) |
+                       (prot == _TRIPPED))
+            firing_eff = np.where(blocked, 180.0, firing)
+            inhibited |= blocked
+
+            # -- Power chain (PowerConversionChain.compute) --
+            if energized:
+                a_rad = np.radians(np.clip(firing_eff, 0, 180))
+                rf = 0.003 * (1.0 + 0.1 * np.abs(np.sin(np.radians(firing_eff))))
+                cos_a = np.cos(a_rad)
+                v_avg1 = np.maximum(k6 * vll1[k] * cos_a - scr_drop2, 0.0)
+                v_avg2 = np.maximum(k6 * vll2[k] * cos_a - scr_drop2, 0.0)
+                v_b1 = np.where(v_avg1 > 0, v_avg1 * (1.0 + rf * ripple_shape[k]), 0.0)
+                v_b2 = np.where(v_avg2 > 0, v_avg2 * (1.0 + rf * ripple_shape[k]), 0.0)
+
+                i_l1 = np.maximum(i_l1 + (v_b1 - v_c) / self.L * dt, 0.0)
+                i_l2 = np.maximum(i_l2 + (v_b2 - v_c) / self.L * dt, 0.0)
+                i_damp = np.where(self.R_damp > 0, v_c / self.R_damp, 0.0)
+                v_c = np.maximum(v_c + (i_l1 + i_l2 - i_out - i_damp) / self.C * dt,
+                                 0.0)
+                v_out = -v_c
+                i_rec = i_out
+            else:
+                v_out = np.zeros(n)
+                i_rec = np.zeros(n)
+
+            # Crowbar discharge of the filter capacitor
+            if cb_active.any():
+                v_c = np.where(cb_active,
+                               np.maximum(v_c - v_c / 0.5 * dt, 0.0), v_c)
+
+            # -- System mode --
+            back = (mode == MODE_FAULT) & (prot == _NORMAL)
+            mode[back] = MODE_REGULATING
+            inhibited &= ~back
+            mode[(mode == MODE_STARTUP) & (ss_progress >= 1.0)] = MODE_REGULATING
+
+            # -- Record --
+            if k % record_every == 0:
+                j = k // record_every
+                res.voltage_kv[:, j] = v_out / 1000.0
+                res.current_a[:, j] = i_rec
+                res.firing_angle_deg[:, j] = np.where(self.open_loop,
+                                                      self.fixed_angle, angle)
+                res.n7_10_ref[:, j] = n7_10
+                res.i_inductor1_a[:, j] = i_l1 if energized else 0.0
+                res.crowbar_active[:, j] = cb_active
+                res.arc_energy_j[:, j] = cb_energy
+                res.protection_state[:, j] = prot
+                res.mode[:, j] = mode
+
+        return res
+
+
+def _run_chunk(args) -> BatchResult:
+    """Worker entry point for :func:`run_batch`."""
+    config, cases, dt, duration, startup_delay, record_every = args
+    engine = BatchEngine(config, cases, dt)
+    return engine.run(duration, startup_delay, record_every)
+
+
+def run_batch(cases: Sequence[BatchCase], duration: float,
+              config: Optional[HVPSConfig] = None, dt: float = 100e-6,
+              startup_delay: float = 0.5, record_every: int = 1,
+              workers: Optional[int] = None) -> BatchResult:
+    """Run a list of cases, split across worker processes.
+
+    Parameters
+    ----------
+    cases : sequence of BatchCase
+        Cases to simulate.
+    duration : float
+        Simulation time per case (s).
+    config : HVPSConfig, optional
+        Shared configuration.
+    dt : float
+        Time step (s).
+    startup_delay : float
+        Startup event time (s).
+    record_every : int
+        Decimation factor for the stored time series.
+    workers : int, optional
+        Number of processes. Default: one per CPU, never more than the
+        number of cases. ``1`` runs in the calling process.
+
+    Returns
+    -------
+    BatchResult
+        Cases in the order given.
+    """
+    cases = list(cases)
+    config = config or HVPSConfig()
+    if workers is None:
+        workers = os.cpu_count() or 1
+    workers = max(1, min(workers, len(cases)))
+
+    if workers == 1:
+        return _run_chunk((config, cases, dt, duration, startup_delay,
+                           record_every))
+
+    chunks = [c.tolist() for c in np.array_split(np.array(cases, dtype=object),
+                                                 workers)]
+    jobs = [(config, chunk, dt, duration, startup_delay, record_every)
+            for chunk in chunks if chunk]
+    with ProcessPoolExecutor(max_workers=len(jobs)) as pool:
+        parts = list(pool.map(_run_chunk, jobs))
+    return BatchResult.concatenate(parts)
+
+
+def sweep_cases(grid: Dict[str, Sequence], base: Optional[BatchCase] = None
+                ) -> List[BatchCase]:
+    """Expand a parameter grid into the cartesian product of BatchCases.
+
+    Parameters
+    ----------
+    grid : dict
+        Maps BatchCase field names to the values to sweep, e.g.
+        ``{'firing_angle_deg': [40, 50, 60], 'capacitor_uf': [4, 8]}``.
+    base : BatchCase, optional
+        Values for the fields not being swept.
+    """
+    base = base or BatchCase()
+    names = list(grid)
+    valid = {f.name for f in fields(BatchCase)}
+    for name in names:
+        if name not in valid:
+            raise ValueError(f"Unknown sweep parameter: {name}")
+    return [replace(base, **dict(zip(names, values)))
+            for values in itertools.product(*(grid[k] for k in names))]
+
+
+def run_sweep(grid: Dict[str, Sequence], duration: float,
+              base: Optional[BatchCase] = None, **kwargs) -> BatchResult:
+    """Sweep a parameter grid. Keyword arguments go to :func:`run_batch`."""
+    return run_batch(sweep_cases(grid, base), duration, **kwargs)
@@ -30,6 +30,9 @@ from hvps.simulation.hvps_sim.protection import (
 )
 from hvps.simulation.hvps_sim.filtering import LCFilter, TwelvePulseRippleGenerator, FilterComponents
 from hvps.simulation.hvps_sim.thyristor_physics import TwelvePulseThyristorRectifier
+from hvps.simulation.hvps_sim.engine import (
+    BatchCase, BatchResult, run_batch, sweep_cases
+)
 
 
 class SystemMode(Enum):
@@ -342,6 +345,45 @@ class HVPSSimulator:
         self.schedule_event(step_time, 'setpoint', {'voltage_kv': v_final_kv})
         return self.run(duration=duration, voltage_kv=v_initial_kv)
 
+    def run_batch(self, cases: List[BatchCase], duration: float,
+                  startup_delay: float = 0.5, record_every: int = 1,
+                  workers: Optional[int] = None) -> BatchResult:
+        """Run many cases with the vectorized batch engine.
+
+        Each case starts from power-on reset with this simulator's
+        configuration and time step; see engine.BatchCase for the
+        per-case parameters (setpoint, fixed firing angle, L/C, arc).
+
+        Parameters
+        ----------
+        cases : list of BatchCase
+            Cases to simulate.
+        duration : float
+            Simulation time per case (s).
+        startup_delay : float
+            Time of the startup event (s).
+        record_every : int
+            Store every Nth time step.
+        workers : int, optional
+            Worker processes (default: one per CPU).
+        """
+        return run_batch(cases, duration, config=self.config, dt=self.dt,
+                         startup_delay=startup_delay,
+                         record_every=record_every, workers=workers)
+
+    def sweep(self, grid: Dict[str, list], duration: float,
+              base: Optional[BatchCase] = None, **kwargs) -> BatchResult:
+        """Run the cartesian product of a parameter grid.
+
+        Example::
+
+            sim.sweep({'firing_angle_deg': [40, 50, 60],
+                       'capacitor_uf': [4.0, 8.0]}, duration=3.0)
+
+        Keyword arguments are passed to :meth:`run_batch`.
+        """
+        return self.run_batch(sweep_cases(grid, base), duration, **kwargs)
+
     # ---- Internal methods ----
 
     def _process_events(self, t: float, default_voltage_kv: float):
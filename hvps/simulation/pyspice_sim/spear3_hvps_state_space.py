@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""
+SPEAR3 HVPS State-Space Surrogate
+=================================
+
+Piecewise-linear state-space surrogate for ``PySpiceCircuitModel.compute_step``
+and a lockstep batch engine for ``SPEAR3SystemSimulator.run_startup``.
+
+The circuit step is linear in the state x = [i_inductor, v_capacitor] and
+the rectifier source u once the conduction pattern is fixed:
+
+    pattern 0  output rectifiers blocking  (v_capacitor <= 0, no load current)
+    pattern 1  output rectifiers conducting (v_capacitor > 0, load on R_load)
+
+    x[k+1] = clamp(A[p] @ x[k] + B[p] * u[k]),   clamp: v_capacitor >= 0
+
+A and B are extracted once per circuit and time step by probing
+``compute_step`` itself with unit states and inputs, so they follow the
+reference model (including its semi-implicit Euler update) rather than a
+second derivation of it. They are cached on disk keyed by the circuit
+parameters, dt, and the source of ``compute_step``.
+
+The 12-pulse thyristor conduction pattern only shapes the T1 current
+monitor. It is extracted as a table of the T1 current for each 30°
+segment of the 60 Hz cycle. The sawtooth monitor and the source ripple
+depend only on time, so they are precomputed once as vectors.
+
+All cases of a batch advance together through one pass of the time loop.
+Each step gathers the 2x2 A and 2x1 B of every case's pattern and applies
+them as one fixed-size batched matrix product (``step_state``).
+
+Usage:
+    from spear3_hvps_state_space import run_startup_batch
+
+    results = run_startup_batch([70.0, 77.0, 84.0], duration=10.0)
+    print(results[1].summary())
+"""
+
+import copy
+import hashlib
+import inspect
+import math
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Union
+
+import numpy as np
+
+from spear3_hvps_system_simulator import (ControlSystem, PySpiceCircuitModel,
+                                          SimulationResult, SystemMode)
+
+# Bump when the cached arrays change meaning
+SURROGATE_VERSION = 1
+
+DEFAULT_CACHE_DIR = Path(__file__).parent / 'state_space_cache'
+
+N_PATTERNS = 2            # Output rectifier blocking / conducting
+N_SEGMENTS = 12           # 30° thyristor conduction segments per cycle
+LINE_FREQ_HZ = 60.0       # AC frequency of the monitor waveforms
+
+MONITOR_CHANNELS = ('hvps_voltage_monitor_kv', 'hvps_current_monitor_a',
+                    'inductor2_sawtooth_monitor_kv',
+                    'transformer1_current_monitor_a')
+
+
+@dataclass
+class StateSpaceModel:
+    """Extracted matrices of one circuit at one time step."""
+    dt: float
+    A: np.ndarray             # (N_PATTERNS, 2, 2)
+    B: np.ndarray             # (N_PATTERNS, 2)
+    t1_segment_a: np.ndarray  # (N_SEGMENTS,) T1 current per 30° segment
+    source_gain: float        # V_dc per unit cos(α)
+    ripple_fraction: float
+    ripple_freq: float
+    ripple_filtered: float
+    output_ratio: float       # v_output / v_capacitor magnitude
+    r_load: float
+
+
+def step_state(A: np.ndarray, B: np.ndarray, x: np.ndarray,
+               u: np.ndarray) -> np.ndarray:
+    """Advance states x (N, 2) one step with source u (N,).
+
+    A (N, N_PATTERNS, 2, 2) and B (N, N_PATTERNS, 2) hold each case's
+    matrices; the pattern of each case is picked from its capacitor voltage.
+    """
+    cases = np.arange(len(x))
+    p = (x[:, 1] > 0).astype(np.intp)
+    x_next = np.einsum('nij,nj->ni', A[cases, p], x) + B[cases, p] * u[:, None]
+    np.maximum(x_next[:, 1], 0.0, out=x_next[:, 1])
+    return x_next
+
+
+def _cache_key(circuit: PySpiceCircuitModel, dt: float) -> str:
+    """Key of the circuit parameters, dt and the reference step code."""
+    params = [SURROGATE_VERSION, dt, circuit.L_total, circuit.C_filter,
+              circuit.R_isolation, circuit.R_load, circuit.R_esr,
+              circuit.v_line_rms, circuit.transformer_ratio,
+              circuit.ripple_freq, circuit.ripple_fraction,
+              circuit.ripple_filtered]
+    text = repr(params) + inspect.getsource(type(circuit).compute_step)
+    return hashlib.sha1(text.encode()).hexdigest()[:16]
+
+
+def _probe(circuit: PySpiceCircuitModel, dt: float, i0: float, v0: float,
+           alpha_deg: float = 0.0, t: float = 0.0) -> Dict:
+    """One reference step from state (i0, v0); returns next state and outputs."""
+    circuit.i_inductor = i0
+    circuit.v_capacitor = v0
+    out = circuit.compute_step(alpha_deg, dt, t)
+    out['x'] = np.array([circuit.i_inductor, circuit.v_capacitor])
+    return out
+
+
+def extract_state_space(circuit: Optional[PySpiceCircuitModel] = None,
+                        dt: float = 0.0005) -> StateSpaceModel:
+    """Extract A, B and the pattern tables by probing ``compute_step``.
+
+    Each probe starts where v_capacitor stays positive after the step, so
+    the clamp is not active and the differences are exactly linear.
+    The circuit passed in is not modified.
+    """
+    circuit = copy.deepcopy(circuit if circuit is not None else PySpiceCircuitModel())
+
+    # Source gain at α = 0, t = 0 (no ripple), read back from the step
+    source_gain = float(_probe(circuit, dt, 0.0, 0.0)['v_unfiltered'])
+
+    # Zero source for the state probes
+    zero = copy.deepcopy(circuit)
+    zero.v_line_rms = 0.0
+
+    # Pattern 0 is probed from v = 0 stepping to v = -1, pattern 1 from
+    # v = 1 stepping to v = 2, both with i = 1 A so the capacitor charges
+    A = np.zeros((N_PATTERNS, 2, 2))
+    B = np.zeros((N_PATTERNS, 2))
+    for p, v0, dv in ((0, 0.0, -1.0), (1, 1.0, 1.0)):
+        base = _probe(zero, dt, 1.0, v0)['x']
+        A[p, :, 1] = (_probe(zero, dt, 1.0, v0 + dv)['x'] - base) / dv
+        A[p, :, 0] = base - A[p, :, 1] * v0
+        B[p] = (_probe(circuit, dt, 1.0, v0)['x'] - base) / source_gain
+
+    # Output map from one conducting probe
+    out = _probe(zero, dt, 1.0, 1.0)
+    output_ratio = float(-out['v_output'] / out['x'][1])
+
+    # T1 current of each thyristor conduction segment, probed mid-segment
+    period = 1.0 / LINE_FREQ_HZ
+    t1_segment_a = np.array([
+        _probe(zero, dt, 0.0, 0.0, t=(k + 0.5) * period / N_SEGMENTS)
+        ['transformer1_current_monitor']
+        for k in range(N_SEGMENTS)])
+
+    return StateSpaceModel(dt=dt, A=A, B=B, t1_segment_a=t1_segment_a,
+                           source_gain=source_gain,
+                           ripple_fraction=circuit.ripple_fraction,
+                           ripple_freq=circuit.ripple_freq,
+                           ripple_filtered=circuit.ripple_filtered,
+                           output_ratio=output_ratio,
+                           r_load=circuit.R_load)
+
+
+def load_state_space(circuit: Optional[PySpiceCircuitModel] = None,
+                     dt: float = 0.0005,
+                     cache_dir: Union[str, Path, None] = DEFAULT_CACHE_DIR
+                     ) -> StateSpaceModel:
+    """Return the state-space model of a circuit, extracting it on first use.
+
+    Pass ``cache_dir=None`` to extract without touching the disk.
+    """
+    circuit = circuit if circuit is not None else PySpiceCircuitModel()
+    if cache_dir is None:
+        return extract_state_space(circuit, dt)
+
+    path = Path(cache_dir) / f'ss_{_cache_key(circuit, dt)}.npz'
+    if path.exists():
+        with np.load(path) as data:
+            if int(data['version']) == SURROGATE_VERSION:
+                return StateSpaceModel(
+                    dt=float(data['dt']), A=data['A'], B=data['B'],
+                    t1_segment_a=data['t1_segment_a'],
+                    **{k: float(data[k]) for k in
+                       ('source_gain', 'ripple_fraction', 'ripple_freq',
+                        'ripple_filtered', 'output_ratio', 'r_load')})
+
+    model = extract_state_space(circuit, dt)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    np.savez(path, version=SURROGATE_VERSION, dt=model.dt, A=model.A,
+             B=model.B, t1_segment_a=model.t1_segment_a,
+             source_gain=model.source_gain,
+             ripple_fraction=model.ripple_fraction,
+             ripple_freq=model.ripple_freq,
+             ripple_filtered=model.ripple_filtered,
+             output_ratio=model.output_ratio, r_load=model.r_load)
+    return model
+
+
+def _sawtooth_monitor(t: np.ndarray) -> np.ndarray:
+    """Channel 3: T2 sawtooth with firing spike (compute_step, vectorized)."""
+    cycle_phase = (2 * np.pi * LINE_FREQ_HZ * t) % (2 * np.pi)
+    sawtooth = np.where(cycle_phase < np.pi,
+                        -5.0 * (cycle_phase / np.pi),
+                        -5.0 + 10.0 * ((cycle_phase - np.pi) / np.pi))
+    spike = np.where(np.abs(cycle_phase - np.pi / 6) < 0.1, 2.0, 0.0)
+    return sawtooth + spike
+
+
+def _transformer1_monitor(model: StateSpaceModel, t: np.ndarray) -> np.ndarray:
+    """Channel 4: T1 current from the conduction segment table."""
+    phase_deg = ((2 * np.pi * LINE_FREQ_HZ * t) % (2 * np.pi)) * 180.0 / np.pi
+    segment = np.minimum((phase_deg // (360.0 / N_SEGMENTS)).astype(np.intp),
+                         N_SEGMENTS - 1)
+    return model.t1_segment_a[segment]
+
+
+def _closed_loop_batch(A, B, targets, gain, ripple_fraction, output_ratio,
+                       ripple_sin, progress, control, dt, startup_step,
+                       v_cap, firing, control_output, u, ripple_amplitude):
+    """ControlSystem.update plus one circuit step, all cases per pass."""
+    x = np.zeros((len(targets), 2))
+    integral = np.zeros(len(targets))
+    v_meas = np.zeros(len(targets))
+    abs_targets = np.abs(targets)
+
+    for i in range(startup_step, v_cap.shape[1]):
+        error = abs_targets * progress[i] - v_meas
+        integral = np.clip(integral + error * dt, -10.0, 10.0)
+        co = control.kp * error + control.ki * integral
+        fa = np.clip(90.0 - co * 3.0, 30.0, 150.0)
+
+        v_dc = gain * np.cos(np.radians(fa))
+        ra = v_dc * ripple_fraction
+        ui = v_dc + ra * ripple_sin[:, i]
+        x = step_state(A, B, x, ui)
+
+        v_meas = np.abs(x[:, 1] * output_ratio) / 1000.0
+        v_cap[:, i] = x[:, 1]
+        firing[:, i] = fa
+        control_output[:, i] = co
+        u[:, i] = ui
+        ripple_amplitude[:, i] = ra
+
+
+def _closed_loop_scalar(A, B, targets, gain, ripple_fraction, output_ratio,
+                        ripple_sin, progress, control, dt, startup_step,
+                        v_cap, firing, control_output, u, ripple_amplitude):
+    """As _closed_loop_batch for one case, with the 2x2 step unrolled.
+
+    Array operations cost more than the arithmetic for a single case.
+    """
+    (a00, a01), (a10, a11) = A[0, 0].tolist()
+    (c00, c01), (c10, c11) = A[0, 1].tolist()
+    b0, b1 = B[0, 0].tolist()
+    d0, d1 = B[0, 1].tolist()
+    target = abs(float(targets[0]))
+    k_src, k_rip, k_out = float(gain[0]), float(ripple_fraction[0]), float(output_ratio[0])
+    kp, ki = float(control.kp), float(control.ki)
+    rip = ripple_sin[0].tolist()
+    prog = progress.tolist()
+    deg = math.pi / 180.0
+
+    i_l = v_c = integral = v_meas = 0.0
+    for i in range(startup_step, v_cap.shape[1]):
+        error = target * prog[i] - v_meas
+        integral = min(max(integral + error * dt, -10.0), 10.0)
+        co = kp * error + ki * integral
+        fa = min(max(90.0 - co * 3.0, 30.0), 150.0)
+
+        v_dc = k_src * math.cos(fa * deg)
+        ra = v_dc * k_rip
+        ui = v_dc + ra * rip[i]
+        if v_c > 0:
+            i_l, v_c = c00 * i_l + c01 * v_c + d0 * ui, c10 * i_l + c11 * v_c + d1 * ui
+        else:
+            i_l, v_c = a00 * i_l + a01 * v_c + b0 * ui, a10 * i_l + a11 * v_c + b1 * ui
+        v_c = max(v_c, 0.0)
+
+        v_meas = abs(v_c * k_out) / 1000.0
+        v_cap[0, i] = v_c
+        firing[0, i] = fa
+        control_output[0, i] = co
+        u[0, i] = ui
+        ripple_amplitude[0, i] = ra
+
+
+def run_startup_batch(target_kvs: Sequence[float], duration: float = 10.0,
+                      startup_delay: float = 0.5, dt: float = 0.0005,
+                      circuits: Optional[Sequence[PySpiceCircuitModel]] = None,
+                      control: Optional[ControlSystem] = None,
+                      cache_dir: Union[str, Path, None] = DEFAULT_CACHE_DIR
+                      ) -> List[SimulationResult]:
+    """Run ``SPEAR3SystemSimulator.run_startup`` for many cases at once.
+
+    Parameters
+    ----------
+    target_kvs : sequence of float
+        Target output voltage magnitude of each case (kV).
+    duration, startup_delay, dt : float
+        As for ``run_startup``.
+    circuits : sequence of PySpiceCircuitModel, optional
+        Circuit of each case, or one circuit for all. Default: the
+        standard circuit.
+    control : ControlSystem, optional
+        Source of the PI gains and soft-start time. Default: standard.
+    cache_dir : path or None
+        Where extracted matrices are cached; None to not cache.
+
+    Returns
+    -------
+    list of SimulationResult
+        One result per case, the same series ``run_startup`` stores.
+    """
+    targets = np.asarray(target_kvs, dtype=float)
+    n_cases = len(targets)
+    if circuits is None:
+        circuits = [PySpiceCircuitModel()]
+    if len(circuits) == 1:
+        circuits = list(circuits) * n_cases
+    if len(circuits) != n_cases:
+        raise ValueError("circuits must have one entry per target or only one")
+    control = control if control is not None else ControlSystem()
+
+    # Extract each distinct circuit once
+    models, model_of_case = {}, []
+    for circuit in circuits:
+        key = _cache_key(circuit, dt)
+        if key not in models:
+            models[key] = load_state_space(circuit, dt, cache_dir)
+        model_of_case.append(models[key])
+    A = np.stack([m.A for m in model_of_case])             # (N, P, 2, 2)
+    B = np.stack([m.B for m in model_of_case])             # (N, P, 2)
+    gain = np.array([m.source_gain for m in model_of_case])
+    ripple_fraction = np.array([m.ripple_fraction for m in model_of_case])
+    ripple_filtered = np.array([m.ripple_filtered for m in model_of_case])
+    output_ratio = np.array([m.output_ratio for m in model_of_case])
+    r_load = np.array([m.r_load for m in model_of_case])
+    ripple_freq = np.array([m.ripple_freq for m in model_of_case])
+
+    n_steps = int(duration / dt)
+    startup_step = int(startup_delay / dt)
+    t_grid = np.arange(n_steps) * dt
+    run = slice(startup_step, n_steps)
+
+    # Time-only terms.  The soft-start ramp accumulates dt exactly as
+    # ControlSystem.update does, and the mode follows from it.
+    ripple_sin = np.sin(2 * np.pi * ripple_freq[:, None] * t_grid[None, :])
+    elapsed = np.add.accumulate(np.full(max(n_steps - startup_step, 0), dt))
+    progress = np.zeros(n_steps)
+    progress[run] = np.minimum(elapsed / control.soft_start_time, 1.0)
+    mode = np.full(n_steps, SystemMode.OFF.name, dtype=object)
+    mode[run] = SystemMode.STARTUP.name
+    reached = np.flatnonzero(progress[run] * 100.0 >= 95.0)
+    if len(reached):
+        mode[startup_step + reached[0] + 1:] = SystemMode.REGULATING.name
+
+    # Per-step series of the closed loop; defaults as SystemState()
+    v_cap = np.zeros((n_cases, n_steps))
+    firing = np.full((n_cases, n_steps), 150.0)
+    control_output = np.zeros((n_cases, n_steps))
+    u = np.zeros((n_cases, n_steps))
+    ripple_amplitude = np.zeros((n_cases, n_steps))
+
+    loop = _closed_loop_scalar if n_cases == 1 else _closed_loop_batch
+    loop(A, B, targets, gain, ripple_fraction, output_ratio, ripple_sin,
+         progress, control, dt, startup_step,
+         v_cap, firing, control_output, u, ripple_amplitude)
+
+    # Outputs as compute_step and run_startup
+    started = np.zeros(n_steps, dtype=bool)
+    started[run] = True
+    v_output = -np.abs(v_cap * output_ratio[:, None])
+    i_output = np.abs(v_output) / r_load[:, None]
+    ripple_pp_pct = np.divide(ripple_amplitude * ripple_filtered[:, None],
+                              np.abs(v_output), out=np.zeros_like(v_output),
+                              where=v_output != 0) * 100.0
+    out = {
+        'time': np.where(started, t_grid, 0.0) + np.zeros((n_cases, 1)),
+        'voltage_kv': v_output / 1000.0,
+        'current_a': i_output,
+        'power_mw': np.abs(v_output) * i_output / 1e6,
+        'firing_angle_deg': firing,
+        'sig_hi_v': np.where(started, np.clip(4.0 + control_output * 0.5, 0.0, 10.0), 0.0),
+        'setpoint_kv': -(np.abs(targets)[:, None] * progress),
+        'soft_start_pct': progress * 100.0 + np.zeros((n_cases, 1)),
+        'v_unfiltered_kv': u / 1000.0,
+        'v_filtered_kv': -np.abs(v_cap) / 1000.0,
+        'ripple_pp_pct': ripple_pp_pct,
+        'ripple_rms_pct': ripple_pp_pct / 2.83,
+        'hvps_voltage_monitor_kv': v_output / 1000.0,
+        'hvps_current_monitor_a': i_output,
+        'inductor2_sawtooth_monitor_kv': np.where(started, _sawtooth_monitor(t_grid), 0.0)
+                                         + np.zeros((n_cases, 1)),
+        'transformer1_current_monitor_a': np.where(
+            started, np.stack([_transformer1_monitor(m, t_grid) for m in model_of_case]), 0.0),
+    }
+
+    return [SimulationResult(dt=dt, duration=duration, mode=list(mode),
+                             **{name: series[n] for name, series in out.items()})
+            for n in range(n_cases)]
+
+
+def compare_monitor_channels(reference: SimulationResult,
+                             surrogate: SimulationResult) -> Dict[str, float]:
+    """Largest difference of each monitor channel, relative to its full scale."""
+    errors = {}
+    for name in MONITOR_CHANNELS:
+        ref = getattr(reference, name)
+        scale = max(float(np.max(np.abs(ref))), 1e-12)
+        errors[name] = float(np.max(np.abs(getattr(surrogate, name) - ref))) / scale
+    return errors
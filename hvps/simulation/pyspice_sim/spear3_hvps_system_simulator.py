@@ -241,6 +241,14 @@ class PySpiceCircuitModel:
         self.C_filter = 8e-6  # 8 µF (real system value)
         self.R_isolation = 500.0  # 500Ω (PEP-II innovation)
         self.R_load = 3500.0  # 77kV / 22A = 3.5kΩ
+        self.R_esr = 0.1  # Small inductor ESR
+        
+        # Source: 12-pulse rectifier with transformer ratio and ripple
+        self.v_line_rms = 12470  # 12.47 kV input
+        self.transformer_ratio = 8.1  # Fine-tuned ratio to achieve -77 kV output
+        self.ripple_freq = 720.0  # 720 Hz fundamental
+        self.ripple_fraction = 0.06  # 6% of DC value
+        self.ripple_filtered = 0.1  # Fraction of ripple left after the filter
         
         # Circuit state for continuous simulation
         self.v_capacitor = 0.0
@@ -256,17 +264,14 @@ class PySpiceCircuitModel:
         # 12-pulse rectifier DC output (enhanced model)
         # Real 12-pulse: V_dc = 1.35 * V_line * cos(α) for ideal case
         # With transformer ratio and system parameters
-        v_line_rms = 12470  # 12.47 kV input
-        transformer_ratio = 8.1  # Fine-tuned ratio to achieve -77 kV output
         
         # Effective DC voltage from rectifier
         cos_alpha = np.cos(alpha_rad)
-        v_dc_ideal = 1.35 * v_line_rms * transformer_ratio * cos_alpha
+        v_dc_ideal = 1.35 * self.v_line_rms * self.transformer_ratio * cos_alpha
         
         # Add 12-pulse ripple (6% of DC value, time-dependent)
-        ripple_freq = 720.0  # 720 Hz fundamental
-        ripple_amplitude = v_dc_ideal * 0.06  # Reduced for better filtering
-        v_dc_with_ripple = v_dc_ideal + ripple_amplitude * np.sin(2 * np.pi * ripple_freq * t)
+        ripple_amplitude = v_dc_ideal * self.ripple_fraction  # Reduced for better filtering
+        v_dc_with_ripple = v_dc_ideal + ripple_amplitude * np.sin(2 * np.pi * self.ripple_freq * t)
         
         # LC filter differential equations
         # L * di/dt = V_in - V_C - i*R
@@ -275,7 +280,7 @@ class PySpiceCircuitModel:
         v_in = v_dc_with_ripple
         
         # Update inductor current
-        di_dt = (v_in - self.v_capacitor - self.i_inductor * 0.1) / self.L_total  # Small ESR
+        di_dt = (v_in - self.v_capacitor - self.i_inductor * self.R_esr) / self.L_total
         self.i_inductor += di_dt * dt
         
         # Update capacitor voltage
@@ -300,7 +305,7 @@ class PySpiceCircuitModel:
         # Calculate ripple
         # For now, use simplified ripple calculation
         # In real implementation, would track ripple over multiple cycles
-        ripple_pp_v = ripple_amplitude * 0.1  # Filtered ripple
+        ripple_pp_v = ripple_amplitude * self.ripple_filtered  # Filtered ripple
         ripple_pp_pct = (ripple_pp_v / abs(v_output)) * 100.0 if v_output != 0 else 0
         ripple_rms_pct = ripple_pp_pct / 2.83  # Approximate RMS for sinusoidal
         
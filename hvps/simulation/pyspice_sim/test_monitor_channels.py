@@ -6,11 +6,18 @@ Generates all plots including the new monitor channel visualizations.
 
 import sys
 import os
+import time
 sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 
 from spear3_hvps_system_simulator import SPEAR3SystemSimulator
+from spear3_hvps_state_space import run_startup_batch, compare_monitor_channels
 import plotting_enhanced
 
+# Largest monitor channel error of the surrogate, fraction of full scale.
+# The two runs agree to rounding (a few 1e-15), so this only trips when the
+# extracted matrices no longer match the circuit.
+SURROGATE_TOL = 1e-9
+
 def main():
     """Test enhanced PySpice simulation with monitor channels and generate all plots."""
     
@@ -69,8 +76,29 @@ def main():
     # Print detailed summary
     print(f"\n{result.summary()}")
     
+    # Check the state-space surrogate against the reference run
+    print(f"\n⚡ State-space surrogate check:")
+    run_startup_batch([77.0], duration=10.0)    # extract and cache the matrices
+    t0 = time.perf_counter()
+    fast = run_startup_batch([77.0], duration=10.0)[0]
+    t_fast = time.perf_counter() - t0
+    t0 = time.perf_counter()
+    sim.run_startup(target_kv=77.0, duration=10.0)
+    t_ref = time.perf_counter() - t0
+    failed = []
+    for name, err in compare_monitor_channels(result, fast).items():
+        print(f"   {name}: max error {err:.2e} of full scale")
+        if not err < SURROGATE_TOL:
+            failed.append(name)
+    print(f"   Reference {t_ref:.3f} s, surrogate {t_fast:.3f} s")
+    if failed:
+        print(f"\n❌ Surrogate differs from the reference by {SURROGATE_TOL:.0e} "
+              f"or more on: {', '.join(failed)}")
+        return 1
+
     print(f"\n🎉 Enhanced PySpice simulation with 4 monitor channels: COMPLETE!")
+    return 0
 
 
 if __name__ == "__main__":
-    main()
+    sys.exit(main())
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""
+Compile the calibration spreadsheets in this directory into rfCal.lut.
+
+The loops and fault tools read the measured calibrations through rfLut
+(llrf/legacyLLRF/rfLut.h) instead of breakpoint tables copied into the
+databases by hand.  This script pulls the measured points out of the
+workbooks, checks them and writes all the tables into one binary file in
+the layout of rfLutSpline.h.  A new calibration is a new workbook or cell
+range here, a rebuild and rfLutLoad on the IOC; no database changes.
+
+The workbooks are laid out for people, so each table below names its
+cells.  Only the cached values are read, so a formula cell gives the value
+the spreadsheet last computed.  Needs nothing beyond the standard library.
+
+Usage:
+    rfCalTables.py [-d dir] [-o rfCal.lut] [-l]
+"""
+
+import argparse
+import hashlib
+import os
+import re
+import struct
+import sys
+import zipfile
+import xml.etree.ElementTree as ET
+
+LUT_MAGIC = b'RFLT'
+LUT_VERSION = 1                 # RF_LUT_VERSION in rfLutSpline.h
+LUT_HEADER = '>4sIII32s'        # magic, version, # tables, checksum, stamp
+LUT_TABLE = '>32s16s16s64sI'    # name, x units, y units, source, # points
+
+# Table name, workbook, x cells, y cells, x units, y units
+CELL_TABLES = [
+    ('TUNE_DAC',        'tuneModeDacCalibration.xlsx',  'A9:A28',  'E9:E28',
+     'counts', 'mW'),
+    ('DRIVE_AMP_014',   'driveAmpCalibration.xlsx',     'E42:E57', 'L42:L57',
+     'dBm', 'W'),
+    ('DRIVE_AMP_013',   'driveAmpCalibration.xlsx',     'E42:E57', 'O42:O57',
+     'dBm', 'W'),
+    ('DRIVE_AMP_UPPER', 'driveAmpCalibration.xlsx',     'E42:E57', 'R42:R57',
+     'dBm', 'W'),
+    ('KLYSOUTREFL',     'reflectedPowerCalibrations.xlsx', 'K6:K8',   'Q6:Q8',
+     'ampl', 'kW'),
+    ('CAV1REFL',        'reflectedPowerCalibrations.xlsx', 'K10:K13', 'Q10:Q13',
+     'ampl', 'kW'),
+    ('CAV2REFL',        'reflectedPowerCalibrations.xlsx', 'K15:K19', 'Q15:Q19',
+     'ampl', 'kW'),
+    ('CAV3REFL',        'reflectedPowerCalibrations.xlsx', 'K21:K25', 'Q21:Q25',
+     'ampl', 'kW'),
+    ('CAV4REFL',        'reflectedPowerCalibrations.xlsx', 'K27:K31', 'Q27:Q31',
+     'ampl', 'kW'),
+]
+
+# The coupler workbook holds total coupling factors, not curves, so these
+# are straight lines in dB over the IQA input range: y = x + coupling.
+# Table name, workbook, coupling cell, x range (dBm)
+COUPLING_TABLES = [
+    ('KLYSFRWD_IQA_PS', 'klystronCouplerDriveAmpCalibrations.xlsx', 'D72',
+     (-40.0, 20.0)),
+    ('KLYSFRWD_IQA',    'klystronCouplerDriveAmpCalibrations.xlsx', 'F72',
+     (-40.0, 20.0)),
+    ('KLYSFRWD_METER',  'klystronCouplerDriveAmpCalibrations.xlsx', 'H72',
+     (-40.0, 20.0)),
+]
+
+NS = {'m': 'http://schemas.openxmlformats.org/spreadsheetml/2006/main'}
+
+
+class CalError(Exception):
+    pass
+
+
+def read_sheet(path):
+    """Cached values of the first sheet of a workbook, by cell name."""
+    with zipfile.ZipFile(path) as z:
+        strings = []
+        if 'xl/sharedStrings.xml' in z.namelist():
+            root = ET.fromstring(z.read('xl/sharedStrings.xml'))
+            for si in root.findall('m:si', NS):
+                strings.append(''.join(t.text or ''
+                                       for t in si.iter('{%s}t' % NS['m'])))
+        sheet = ET.fromstring(z.read('xl/worksheets/sheet1.xml'))
+    cells = {}
+    for c in sheet.iter('{%s}c' % NS['m']):
+        v = c.find('m:v', NS)
+        if v is None or v.text is None:
+            continue
+        cells[c.get('r')] = strings[int(v.text)] if c.get('t') == 's' else v.text
+    return cells
+
+
+def cell_range(spec):
+    """Cell names of a one-column or one-row range such as 'E42:E57'."""
+    m = re.fullmatch(r'([A-Z]+)(\d+):([A-Z]+)(\d+)', spec)
+    if not m:
+        raise CalError('bad range %s' % spec)
+    c0, r0, c1, r1 = m.group(1), int(m.group(2)), m.group(3), int(m.group(4))
+    if c0 == c1:
+        return ['%s%d' % (c0, r) for r in range(r0, r1 + 1)]
+    if r0 == r1 and len(c0) == 1 and len(c1) == 1:
+        return ['%s%d' % (chr(c), r0) for c in range(ord(c0), ord(c1) + 1)]
+    raise CalError('range %s is not one row or column' % spec)
+
+
+def number(cells, name, where):
+    try:
+        return float(cells[name])
+    except (KeyError, ValueError):
+        raise CalError('%s: %s is not a number' % (where, name))
+
+
+def check(name, x, y):
+    """Sort by x and check that the table can be interpolated."""
+    if len(x) < 2:
+        raise CalError('%s: fewer than 2 points' % name)
+    pts = sorted(zip(x, y))
+    x = [p[0] for p in pts]
+    y = [p[1] for p in pts]
+    for a, b in zip(x, x[1:]):
+        if b <= a:
+            raise CalError('%s: repeated x %g' % (name, a))
+    rising = all(b > a for a, b in zip(y, y[1:]))
+    falling = all(b < a for a, b in zip(y, y[1:]))
+    if not (rising or falling):
+        print('rfCalTables: warning: %s is not monotone, cannot be inverted'
+              % name, file=sys.stderr)
+    return x, y
+
+
+def compile_tables(cal_dir):
+    sheets = {}
+    digest = hashlib.sha1()
+    books = sorted({t[1] for t in CELL_TABLES + COUPLING_TABLES})
+    for book in books:
+        path = os.path.join(cal_dir, book)
+        with open(path, 'rb') as f:
+            digest.update(f.read())
+        sheets[book] = read_sheet(path)
+
+    tables = []
+    for name, book, xs, ys, xu, yu in CELL_TABLES:
+        cx, cy = cell_range(xs), cell_range(ys)
+        if len(cx) != len(cy):
+            raise CalError('%s: %s and %s differ in length' % (name, xs, ys))
+        where = '%s %s' % (book, name)
+        x = [number(sheets[book], c, where) for c in cx]
+        y = [number(sheets[book], c, where) for c in cy]
+        x, y = check(name, x, y)
+        tables.append((name, xu, yu, '%s!%s,%s' % (book, xs, ys), x, y))
+    for name, book, cell, (x0, x1) in COUPLING_TABLES:
+        k = number(sheets[book], cell, '%s %s' % (book, name))
+        tables.append((name, 'dBm', 'dBm', '%s!%s' % (book, cell),
+                       [x0, x1], [x0 + k, x1 + k]))
+    return tables, 'sha1:' + digest.hexdigest()[:24]
+
+
+def fnv1a(data):
+    h = 0x811c9dc5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xffffffff
+    return h
+
+
+def pack(tables, stamp):
+    body = b''
+    for name, xu, yu, source, x, y in tables:
+        body += struct.pack(LUT_TABLE, name.encode(), xu.encode(), yu.encode(),
+                            source.encode()[:63], len(x))
+        body += struct.pack('>%dd' % len(x), *x)
+        body += struct.pack('>%dd' % len(y), *y)
+    return struct.pack(LUT_HEADER, LUT_MAGIC, LUT_VERSION, len(tables),
+                       fnv1a(body), stamp.encode()) + body
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('-d', '--dir', default=os.path.dirname(os.path.abspath(__file__)),
+                        help='directory of the workbooks')
+    parser.add_argument('-o', '--output', default='rfCal.lut')
+    parser.add_argument('-l', '--list', action='store_true',
+                        help='print the tables as they are written')
+    args = parser.parse_args()
+
+    try:
+        tables, stamp = compile_tables(args.dir)
+    except (CalError, OSError, KeyError, zipfile.BadZipFile) as e:
+        print('rfCalTables: %s' % e, file=sys.stderr)
+        return 1
+
+    data = pack(tables, stamp)
+    tmp = args.output + '.tmp'
+    with open(tmp, 'wb') as f:
+        f.write(data)
+    os.replace(tmp, args.output)
+
+    print('rfCalTables: %d tables, %d bytes, %s -> %s'
+          % (len(tables), len(data), stamp, args.output))
+    if args.list:
+        for name, xu, yu, source, x, y in tables:
+            print('  %-16s %2d points %8s -> %-6s %s' % (name, len(x), xu, yu, source))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
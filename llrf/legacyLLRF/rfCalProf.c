@@ -0,0 +1,469 @@
+/*=============================================================================
+
+  Abs:  RFP Calibration Profiler
+
+  Name: rfCalProf.c
+         Public:
+           rfCalProfReport - print the last run of every station
+           rfCalProfOpen   - find or create the profiler of a station
+           rfCalProfStart  - a calibration run starts
+           rfCalProfStage  - the run enters a stage
+           rfCalProfBegin  - start timing a piece of work
+           rfCalProfEnd    - stop timing a piece of work
+           rfCalProfTally  - count an operation
+           rfCalProfFinish - the run is over
+           rfCalProfTotal  - run time so far
+           rfCalProfTimes  - seconds in a piece, per stage
+           rfCalProfCounts - # of an operation, per stage
+           rfCalProfWrite  - write the run report file
+         Private:
+           rfCalProfInit   - create the table lock
+           rfCalProfSince  - seconds since a timestamp
+           rfCalProfClose  - close the current stage
+           rfCalProfOther  - stage time outside the timed pieces
+           rfCalProfPrint  - print the run table
+
+  Rem:  The calibration takes about three minutes and reports only the
+        stage it is in.  The profiler splits each stage into DAC loads,
+        delays, RFP RAM transfers, averaging and the rest (pvPuts of
+        offsets, IQ&A reads, ...), and counts TAKE_DATA, LOD, QUADLOD,
+        GET_IQ and P2RF_UpdateSetPt.  An acquisition is one TAKE_DATA
+        (arm, wait for the data, optional LOD); it overlaps the loads and
+        delays inside it and is kept apart from them.
+
+        Times are from epicsTimeGetCurrent, which on vxWorks steps once
+        per clock tick.  A single transfer or average is shorter than a
+        tick, so their per-stage sums are only good over the hundreds of
+        acquisitions a stage makes, not one by one.
+
+        Stages are numbered by the caller so a stage keeps its place in
+        the waveforms when a run is aborted early.  Results stay until
+        the next run starts.
+
+        IOC shell:
+          rfCalProfReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfCalProf.h"
+
+#define RF_CALPROF_STN_LEN    16
+
+typedef struct
+{
+  char           name[RF_CALPROF_NAME_LEN];
+  int            used;
+  double         total;      /* time in the stage                         */
+  double         sec[RF_CALPROF_NPARTS];
+  double         acq_max;
+  unsigned long  count[RF_CALPROF_NCOUNTS];
+} rfCalProfStg;
+
+typedef struct
+{
+  char           stn[RF_CALPROF_STN_LEN];
+  epicsMutexId   lock;
+  int            running;
+  int            status;     /* calibration status at the finish          */
+  int            stage;      /* current stage, -1 before the first        */
+  int            nstage;     /* highest stage entered + 1                 */
+  unsigned long  runs;
+  double         total;      /* run time, once finished                   */
+  epicsTimeStamp start;      /* of the run                                */
+  epicsTimeStamp entered;    /* of the current stage                      */
+  epicsTimeStamp begun[RF_CALPROF_NPARTS];
+  int            timing[RF_CALPROF_NPARTS];
+  rfCalProfStg   stg[RF_CALPROF_MAX_STAGES];
+} rfCalProfStn;
+
+static rfCalProfStn *rfCalProfTable[RF_CALPROF_MAX_STATIONS];
+static int           rfCalProfNstn      = 0;
+static epicsMutexId  rfCalProfTableLock = NULL;
+static epicsThreadOnceId rfCalProfOnce = EPICS_THREAD_ONCE_INIT;
+
+static const char   *rfCalProfPartName[RF_CALPROF_NPARTS] =
+  {"load", "settle", "xfer", "avg", "acq"};
+
+/*----------------------------------------------------------------------------*/
+
+static void rfCalProfInit(void *arg)
+{
+  rfCalProfTableLock = epicsMutexMustCreate();
+}
+
+static rfCalProfStn *rfCalProfGetStn(int id)
+{
+  if ((id < 0) || (id >= rfCalProfNstn)) return NULL;
+  return rfCalProfTable[id];
+}
+
+static double rfCalProfSince(const epicsTimeStamp *then)
+{
+  epicsTimeStamp now;
+
+  epicsTimeGetCurrent(&now);
+  return epicsTimeDiffInSeconds(&now, then);
+}
+
+/* Caller holds the lock */
+static void rfCalProfClose(rfCalProfStn *ps)
+{
+  if (ps->stage >= 0) ps->stg[ps->stage].total += rfCalProfSince(&ps->entered);
+}
+
+/* Seconds of a stage not in a load, delay, transfer or average */
+static double rfCalProfOther(const rfCalProfStg *pg)
+{
+  double other = pg->total;
+  int    part;
+
+  for (part = RF_CALPROF_LOAD; part <= RF_CALPROF_AVG; part++)
+    other -= pg->sec[part];
+  return (other > 0.0) ? other : 0.0;
+}
+
+/* Caller holds the lock */
+static void rfCalProfPrint(FILE *fp, rfCalProfStn *ps)
+{
+  rfCalProfStg  all, *pg;
+  char          time[40];
+  double        total;
+  int           s, i;
+
+  total = ps->running ? rfCalProfSince(&ps->start) : ps->total;
+  epicsTimeToStrftime(time, sizeof(time), "%b %d, %Y %H:%M:%S", &ps->start);
+  fprintf(fp, "%s calibration of %s, %.1f sec, %s, status %d\n",
+          ps->stn, time, total, ps->running ? "running" : "done", ps->status);
+  fprintf(fp, "%-16s %7s %7s %7s %7s %7s %7s %6s %7s %7s %6s %5s %6s %6s\n",
+          "stage", "sec", "load", "settle", "xfer", "avg", "other", "takes",
+          "acq ms", "max ms", "lod", "qlod", "getiq", "update");
+  memset(&all, 0, sizeof(all));
+  for (s = 0; s <= ps->nstage; s++)
+  {
+    pg = &ps->stg[s];
+    if (s == ps->nstage)
+    {
+      pg = &all;
+      strcpy(pg->name, "TOTAL");
+    }
+    else if (!pg->used) continue;
+    fprintf(fp, "%-16s %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %6lu %7.1f %7.1f "
+            "%6lu %5lu %6lu %6lu\n", pg->name, pg->total,
+            pg->sec[RF_CALPROF_LOAD], pg->sec[RF_CALPROF_SETTLE],
+            pg->sec[RF_CALPROF_XFER], pg->sec[RF_CALPROF_AVG],
+            rfCalProfOther(pg), pg->count[RF_CALPROF_TAKES],
+            pg->count[RF_CALPROF_TAKES] ? 1e3 * pg->sec[RF_CALPROF_ACQ] /
+                                          pg->count[RF_CALPROF_TAKES] : 0.0,
+            1e3 * pg->acq_max, pg->count[RF_CALPROF_LODS],
+            pg->count[RF_CALPROF_QUADLODS], pg->count[RF_CALPROF_GETIQS],
+            pg->count[RF_CALPROF_UPDATES]);
+    all.total += pg->total;
+    for (i = 0; i < RF_CALPROF_NPARTS; i++) all.sec[i] += pg->sec[i];
+    for (i = 0; i < RF_CALPROF_NCOUNTS; i++) all.count[i] += pg->count[i];
+    if (pg->acq_max > all.acq_max) all.acq_max = pg->acq_max;
+  }
+  if (all.total > 0.0)
+  {
+    fprintf(fp, "share of stage time:");
+    for (i = RF_CALPROF_LOAD; i <= RF_CALPROF_AVG; i++)
+      fprintf(fp, " %s %.0f%%", rfCalProfPartName[i],
+              100.0 * all.sec[i] / all.total);
+    fprintf(fp, " other %.0f%%\n", 100.0 * rfCalProfOther(&all) / all.total);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfCalProfOpen(const char *stn)
+{
+  rfCalProfStn *ps;
+  int           id;
+
+  if (!stn) stn = "";
+  epicsThreadOnce(&rfCalProfOnce, rfCalProfInit, NULL);
+  epicsMutexMustLock(rfCalProfTableLock);
+  for (id = 0; id < rfCalProfNstn; id++)
+    if (!strncmp(stn, rfCalProfTable[id]->stn, RF_CALPROF_STN_LEN - 1)) break;
+  if (id == rfCalProfNstn)
+  {
+    ps = NULL;
+    if (rfCalProfNstn < RF_CALPROF_MAX_STATIONS)
+      ps = (rfCalProfStn *)calloc(1, sizeof(*ps));
+    if (ps)
+    {
+      sprintf(ps->stn, "%.*s", RF_CALPROF_STN_LEN - 1, stn);
+      ps->lock  = epicsMutexMustCreate();
+      ps->stage = -1;
+      rfCalProfTable[rfCalProfNstn++] = ps;
+    }
+    else
+    {
+      epicsPrintf("rfCalProfOpen: No room for station %s\n", stn);
+      id = RF_CALPROF_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfCalProfTableLock);
+  return id;
+}
+
+/*
+ * Clears the last run.
+ */
+int rfCalProfStart(int id)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+
+  if (!ps) return RF_CALPROF_ERROR;
+  epicsMutexMustLock(ps->lock);
+  memset(ps->stg,    0, sizeof(ps->stg));
+  memset(ps->timing, 0, sizeof(ps->timing));
+  ps->stage   = -1;
+  ps->nstage  = 0;
+  ps->status  = 0;
+  ps->total   = 0.0;
+  ps->running = 1;
+  ps->runs++;
+  epicsTimeGetCurrent(&ps->start);
+  epicsMutexUnlock(ps->lock);
+  return RF_CALPROF_OK;
+}
+
+/*
+ * Time from here to the next stage or the finish goes to this stage.
+ * Entering a stage again adds to it.
+ */
+int rfCalProfStage(int id, int stage, const char *name)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+  rfCalProfStg *pg;
+
+  if (!ps || (stage < 0) || (stage >= RF_CALPROF_MAX_STAGES))
+    return RF_CALPROF_ERROR;
+  epicsMutexMustLock(ps->lock);
+  if (ps->running)
+  {
+    rfCalProfClose(ps);
+    pg = &ps->stg[stage];
+    if (!pg->used)
+    {
+      sprintf(pg->name, "%.*s", RF_CALPROF_NAME_LEN - 1, name ? name : "");
+      pg->used = 1;
+    }
+    ps->stage = stage;
+    if (stage >= ps->nstage) ps->nstage = stage + 1;
+    epicsTimeGetCurrent(&ps->entered);
+  }
+  epicsMutexUnlock(ps->lock);
+  return RF_CALPROF_OK;
+}
+
+void rfCalProfBegin(int id, int part)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+
+  if (!ps || (part < 0) || (part >= RF_CALPROF_NPARTS)) return;
+  epicsMutexMustLock(ps->lock);
+  if (ps->running)
+  {
+    epicsTimeGetCurrent(&ps->begun[part]);
+    ps->timing[part] = 1;
+  }
+  epicsMutexUnlock(ps->lock);
+}
+
+/*
+ * The time goes to the stage current at the end.
+ */
+void rfCalProfEnd(int id, int part)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+  rfCalProfStg *pg;
+  double        sec;
+
+  if (!ps || (part < 0) || (part >= RF_CALPROF_NPARTS)) return;
+  epicsMutexMustLock(ps->lock);
+  if (ps->running && ps->timing[part] && (ps->stage >= 0))
+  {
+    pg             = &ps->stg[ps->stage];
+    sec            = rfCalProfSince(&ps->begun[part]);
+    pg->sec[part] += sec;
+    if ((part == RF_CALPROF_ACQ) && (sec > pg->acq_max)) pg->acq_max = sec;
+  }
+  ps->timing[part] = 0;
+  epicsMutexUnlock(ps->lock);
+}
+
+void rfCalProfTally(int id, int count)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+
+  if (!ps || (count < 0) || (count >= RF_CALPROF_NCOUNTS)) return;
+  epicsMutexMustLock(ps->lock);
+  if (ps->running && (ps->stage >= 0)) ps->stg[ps->stage].count[count]++;
+  epicsMutexUnlock(ps->lock);
+}
+
+int rfCalProfFinish(int id, int status)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+
+  if (!ps) return RF_CALPROF_ERROR;
+  epicsMutexMustLock(ps->lock);
+  if (ps->running)
+  {
+    rfCalProfClose(ps);
+    ps->total   = rfCalProfSince(&ps->start);
+    ps->status  = status;
+    ps->stage   = -1;
+    ps->running = 0;
+  }
+  epicsMutexUnlock(ps->lock);
+  return RF_CALPROF_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+
+double rfCalProfTotal(int id)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+  double        total;
+
+  if (!ps) return 0.0;
+  epicsMutexMustLock(ps->lock);
+  total = ps->running ? rfCalProfSince(&ps->start) : ps->total;
+  epicsMutexUnlock(ps->lock);
+  return total;
+}
+
+/*
+ * sec[stage] for stages 0 to nstage-1, part is RF_CALPROF_LOAD to
+ * RF_CALPROF_ACQ_MAX.  Stages not entered are 0.
+ */
+int rfCalProfTimes(int id, int part, int nstage, float *sec)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+  rfCalProfStg *pg;
+  int           s;
+
+  if (!ps || (part < 0) || (part > RF_CALPROF_ACQ_MAX))
+    return RF_CALPROF_ERROR;
+  if (nstage > RF_CALPROF_MAX_STAGES) nstage = RF_CALPROF_MAX_STAGES;
+  epicsMutexMustLock(ps->lock);
+  for (s = 0; s < nstage; s++)
+  {
+    pg = &ps->stg[s];
+    if      (part == RF_CALPROF_STAGE)   sec[s] = pg->total;
+    else if (part == RF_CALPROF_OTHER)   sec[s] = rfCalProfOther(pg);
+    else if (part == RF_CALPROF_ACQ_MAX) sec[s] = pg->acq_max;
+    else                                 sec[s] = pg->sec[part];
+  }
+  epicsMutexUnlock(ps->lock);
+  return RF_CALPROF_OK;
+}
+
+int rfCalProfCounts(int id, int count, int nstage, int *counts)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+  int           s;
+
+  if (!ps || (count < 0) || (count >= RF_CALPROF_NCOUNTS))
+    return RF_CALPROF_ERROR;
+  if (nstage > RF_CALPROF_MAX_STAGES) nstage = RF_CALPROF_MAX_STAGES;
+  epicsMutexMustLock(ps->lock);
+  for (s = 0; s < nstage; s++) counts[s] = (int)ps->stg[s].count[count];
+  epicsMutexUnlock(ps->lock);
+  return RF_CALPROF_OK;
+}
+
+/*
+ * Writes the report of the last run to dir/CALPROF_<stn>_<yyyymmdd_hhmmss>
+ * of the run start, and returns that name in file (len characters).
+ */
+int rfCalProfWrite(int id, const char *dir, char *file, int len)
+{
+  rfCalProfStn *ps = rfCalProfGetStn(id);
+  FILE         *fp;
+  char          stamp[20];
+  int           status = RF_CALPROF_OK;
+
+  if (!ps || !dir || !file || (len < 1)) return RF_CALPROF_ERROR;
+  epicsMutexMustLock(ps->lock);
+  epicsTimeToStrftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &ps->start);
+  file[0] = '\0';
+  if (strlen(dir) + strlen(ps->stn) + strlen(stamp) + 11 > (size_t)len)
+  {
+    epicsPrintf("rfCalProfWrite: %s report name too long\n", ps->stn);
+    status = RF_CALPROF_ERROR;
+  }
+  else
+  {
+    sprintf(file, "%s/CALPROF_%s_%s", dir, ps->stn, stamp);
+    if ((fp = fopen(file, "w")) != NULL)
+    {
+      rfCalProfPrint(fp, ps);
+      fclose(fp);
+    }
+    else
+    {
+      epicsPrintf("rfCalProfWrite: Unable to create %s\n", file);
+      status = RF_CALPROF_ERROR;
+    }
+  }
+  epicsMutexUnlock(ps->lock);
+  return status;
+}
+
+void rfCalProfReport(int level)
+{
+  rfCalProfStn *ps;
+  int           i;
+
+  printf("%d calibration profilers\n", rfCalProfNstn);
+  for (i = 0; i < rfCalProfNstn; i++)
+  {
+    ps = rfCalProfTable[i];
+    epicsMutexMustLock(ps->lock);
+    if (level > 0 && ps->runs)
+      rfCalProfPrint(stdout, ps);
+    else
+      printf("%-8s %lu runs, last %.1f sec%s\n", ps->stn, ps->runs,
+             ps->running ? rfCalProfSince(&ps->start) : ps->total,
+             ps->running ? " so far" : "");
+    epicsMutexUnlock(ps->lock);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfCalProfReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfCalProfReportArgs[] = {&rfCalProfReportArg0};
+static const iocshFuncDef rfCalProfReportDef =
+  {"rfCalProfReport", 1, rfCalProfReportArgs};
+static void rfCalProfReportCall(const iocshArgBuf *args)
+{
+  rfCalProfReport(args[0].ival);
+}
+
+static void rfCalProfRegistrar(void)
+{
+  iocshRegister(&rfCalProfReportDef, rfCalProfReportCall);
+}
+epicsExportRegistrar(rfCalProfRegistrar);
@@ -0,0 +1,79 @@
+/*=============================================================================
+
+  Abs:  RFP Calibration Profiler
+
+  Name: rfCalProf.h
+
+  Prev: None
+
+  Rem:  P2RF_Calib marks the stage it is in and brackets the pieces of
+        work it wants timed; the profiler keeps, per stage, the time in
+        each piece and counts of the hardware operations.  At the end
+        of a run the stages can be read back per piece for waveform PVs
+        and written to a report file.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_CALPROF_H
+#define RF_CALPROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_CALPROF_OK           0
+#define RF_CALPROF_ERROR      (-1)
+
+#define RF_CALPROF_MAX_STATIONS 4     /* # profilers per IOC                 */
+#define RF_CALPROF_MAX_STAGES   32    /* # stages per calibration            */
+#define RF_CALPROF_NAME_LEN     16    /* stage name length                   */
+
+/* Timed pieces, the first four don't overlap */
+#define RF_CALPROF_LOAD         0     /* octal and quad DAC loads            */
+#define RF_CALPROF_SETTLE       1     /* delays for settling and loading     */
+#define RF_CALPROF_XFER         2     /* RFP RAM to buffer transfers         */
+#define RF_CALPROF_AVG          3     /* averaging the buffer                */
+#define RF_CALPROF_ACQ          4     /* acquisitions (TAKE_DATA)            */
+#define RF_CALPROF_NPARTS       5
+/* Read back only */
+#define RF_CALPROF_STAGE        5     /* whole stage                         */
+#define RF_CALPROF_OTHER        6     /* stage less LOAD, SETTLE, XFER, AVG  */
+#define RF_CALPROF_ACQ_MAX      7     /* longest acquisition                 */
+
+/* Counted operations */
+#define RF_CALPROF_TAKES        0     /* TAKE_DATA                           */
+#define RF_CALPROF_LODS         1     /* LOD                                 */
+#define RF_CALPROF_QUADLODS     2     /* QUADLOD                             */
+#define RF_CALPROF_GETIQS       3     /* GET_IQ                              */
+#define RF_CALPROF_UPDATES      4     /* P2RF_UpdateSetPt                    */
+#define RF_CALPROF_NCOUNTS      5
+
+/* IOC shell */
+void   rfCalProfReport (int level);
+
+/* Calibration */
+int    rfCalProfOpen   (const char *stn);
+int    rfCalProfStart  (int id);
+int    rfCalProfStage  (int id, int stage, const char *name);
+void   rfCalProfBegin  (int id, int part);
+void   rfCalProfEnd    (int id, int part);
+void   rfCalProfTally  (int id, int count);
+int    rfCalProfFinish (int id, int status);
+
+/* Results */
+double rfCalProfTotal  (int id);
+int    rfCalProfTimes  (int id, int part, int nstage, float *sec);
+int    rfCalProfCounts (int id, int count, int nstage, int *counts);
+int    rfCalProfWrite  (int id, const char *dir, char *file, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_CALPROF_H */
@@ -0,0 +1,369 @@
+/*=============================================================================
+
+  Abs:  Loop State Checkpoints for Bumpless Restart
+
+  Name: rfCkpt.c
+         Public:
+           rfCkptLoad   - load the newest good record if fresh enough
+           rfCkptOpen   - open the checkpoint of a loop
+           rfCkptReport - print every checkpoint
+           rfCkptSave   - save a record
+         Private:
+           rfCkptInit   - create the lock
+           rfCkptCrc    - CRC-32 of a slot
+           rfCkptCrcAdd - add bytes to a CRC-32
+           rfCkptCheck  - check a slot
+           rfCkptNewest - find the newest good slot
+           rfCkptWrite  - make a slot durable
+
+  Rem:  When the IOC restarts, the HVPS, DAC and tuner loops lose their
+        internal state (the previous counts and controls, the tolerance
+        counts and the state they were in) and start cold: the HVPS
+        voltage is reset to its readback, the DAC loop forgets it was
+        controlling and the tuner loop waits up to LOOP_SLOW_PERIOD
+        before it runs.  Each loop now saves that state every cycle and
+        resumes from it when it comes back.
+
+        A checkpoint file holds two slots, each a header and one record.
+        A save writes the slot not holding the newest record, header
+        last, so the other slot stays whole whatever happens during the
+        save.  The header carries a sequence number, the time of the
+        save and a CRC-32 over header and record; a load takes the good
+        slot with the highest sequence number.  A slot torn by a crash,
+        or written by a build with a different record, fails the CRC,
+        version or size check and is ignored.
+
+        On Linux the file is memory mapped, so a save costs a copy into
+        the page cache and survives the IOC process dying at any point.
+        It reaches the disk with the kernel's normal writeback (msync
+        MS_ASYNC); a host that loses power may come back with an older
+        record, which the age check then refuses.  On other targets the
+        slot is written to the file with stdio on every save.
+
+        The file is <dir>/CKPT_<stn>_<name>, with any ':' in the name
+        replaced by '_'.  A loop with no directory (no CKPT macro) has
+        no checkpoint and always starts cold.
+
+        IOC shell:
+          rfCkptReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <epicsTypes.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfCkpt.h"
+
+#define RF_CKPT_MAGIC         0x52464350   /* "RFCP"                         */
+#define RF_CKPT_VERSION       1
+#define RF_CKPT_STATUS_LEN    32
+
+typedef struct
+{
+  epicsUInt32    magic;
+  epicsUInt32    version;
+  epicsUInt32    seq;        /* save count, newest slot has the highest   */
+  epicsUInt32    size;       /* record bytes                              */
+  epicsUInt32    sec;        /* time of the save                          */
+  epicsUInt32    nsec;
+  epicsUInt32    crc;        /* over the header up to here and the record */
+  epicsUInt32    spare;
+} rfCkptHead;
+
+typedef struct
+{
+  char           name[RF_CKPT_NAME_LEN];
+  char           file[RF_CKPT_FILE_LEN];
+  char          *base;       /* two slots, mapped or a copy of the file   */
+  int            size;       /* record bytes                              */
+  int            slot;       /* bytes in one slot                         */
+  epicsUInt32    seq;        /* sequence number of the newest record      */
+  int            saves;
+  int            errors;
+  char           status[RF_CKPT_STATUS_LEN];  /* result of the last load  */
+  double         age;
+#ifndef __linux__
+  FILE          *fp;
+#endif
+} rfCkptLoop;
+
+static rfCkptLoop    rfCkptTable[RF_CKPT_MAX_LOOPS];
+static int           rfCkptCount = 0;
+static epicsMutexId  rfCkptLock  = NULL;
+static epicsThreadOnceId rfCkptOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfCkptInit(void *arg)
+{
+  rfCkptLock = epicsMutexMustCreate();
+}
+
+static epicsUInt32 rfCkptCrcAdd(epicsUInt32 crc, const void *buf, int len)
+{
+  const unsigned char *p = (const unsigned char *)buf;
+  int                  bit;
+
+  while (len-- > 0)
+  {
+    crc ^= *p++;
+    for (bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+  }
+  return crc;
+}
+
+/*
+ * CRC-32 of the header fields before crc and of the record after it.
+ */
+static epicsUInt32 rfCkptCrc(const rfCkptHead *ph, int size)
+{
+  epicsUInt32 crc;
+
+  crc = rfCkptCrcAdd(0xffffffff, ph,
+                     (int)((const char *)&ph->crc - (const char *)ph));
+  crc = rfCkptCrcAdd(crc, ph + 1, size);
+  return ~crc;
+}
+
+/*
+ * Returns the header of slot i if it holds a good record.
+ */
+static rfCkptHead *rfCkptCheck(rfCkptLoop *pc, int i)
+{
+  rfCkptHead *ph;
+
+  ph = (rfCkptHead *)(pc->base + i * pc->slot);
+  if ((ph->magic != RF_CKPT_MAGIC) || (ph->version != RF_CKPT_VERSION) ||
+      (ph->size  != (epicsUInt32)pc->size) ||
+      (ph->crc   != rfCkptCrc(ph, pc->size))) return NULL;
+  return ph;
+}
+
+static rfCkptHead *rfCkptNewest(rfCkptLoop *pc)
+{
+  rfCkptHead *ph0, *ph1;
+
+  ph0 = rfCkptCheck(pc, 0);
+  ph1 = rfCkptCheck(pc, 1);
+  if (!ph0) return ph1;
+  if (!ph1) return ph0;
+  return ((epicsInt32)(ph1->seq - ph0->seq) > 0) ? ph1 : ph0;
+}
+
+static int rfCkptWrite(rfCkptLoop *pc, int i)
+{
+#ifdef __linux__
+  if (msync(pc->base, 2 * pc->slot, MS_ASYNC)) return RF_CKPT_ERROR;
+#else
+  if (fseek(pc->fp, (long)i * pc->slot, SEEK_SET) ||
+      (fwrite(pc->base + i * pc->slot, pc->slot, 1, pc->fp) != 1) ||
+      fflush(pc->fp)) return RF_CKPT_ERROR;
+#endif
+  return RF_CKPT_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Returns RF_CKPT_ERROR quietly when dir is NULL or empty.
+ */
+int rfCkptOpen(const char *dir, const char *stn, const char *name, int size)
+{
+  rfCkptLoop *pc;
+  rfCkptHead *ph;
+  char        full[RF_CKPT_NAME_LEN];
+  char       *p;
+  int         id;
+#ifdef __linux__
+  int         fd;
+#endif
+
+  if (!dir || !*dir || !name) return RF_CKPT_ERROR;
+  if ((size <= 0) || (size > RF_CKPT_MAX_SIZE))
+  {
+    epicsPrintf("rfCkptOpen: Bad record size %d for %s\n", size, name);
+    return RF_CKPT_ERROR;
+  }
+  if (stn && *stn) sprintf(full, "%.*s_%.*s", 8, stn,
+                           RF_CKPT_NAME_LEN - 10, name);
+  else             sprintf(full, "%.*s", RF_CKPT_NAME_LEN - 1, name);
+  for (p = full; *p; p++) if (*p == ':') *p = '_';
+  epicsThreadOnce(&rfCkptOnce, rfCkptInit, NULL);
+  epicsMutexMustLock(rfCkptLock);
+  for (id = 0; id < rfCkptCount; id++)
+    if (!strcmp(full, rfCkptTable[id].name)) break;
+  if (id < rfCkptCount)
+  {
+    epicsMutexUnlock(rfCkptLock);
+    return (rfCkptTable[id].size == size) ? id : RF_CKPT_ERROR;
+  }
+  if (rfCkptCount >= RF_CKPT_MAX_LOOPS)
+  {
+    epicsMutexUnlock(rfCkptLock);
+    epicsPrintf("rfCkptOpen: No room for %s\n", full);
+    return RF_CKPT_ERROR;
+  }
+  pc = &rfCkptTable[rfCkptCount];
+  memset(pc, 0, sizeof(*pc));
+  strcpy(pc->name, full);
+  sprintf(pc->file, "%.*s/CKPT_%s", RF_CKPT_FILE_LEN - RF_CKPT_NAME_LEN - 7,
+          dir, full);
+  pc->size = size;
+  pc->slot = sizeof(rfCkptHead) + ((size + 7) & ~7);
+#ifdef __linux__
+  fd = open(pc->file, O_RDWR | O_CREAT, 0644);
+  if ((fd < 0) || ftruncate(fd, 2 * pc->slot) ||
+      ((pc->base = (char *)mmap(NULL, 2 * pc->slot, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, fd, 0)) == MAP_FAILED))
+  {
+    if (fd >= 0) close(fd);
+    epicsMutexUnlock(rfCkptLock);
+    epicsPrintf("rfCkptOpen: Cannot map %s\n", pc->file);
+    return RF_CKPT_ERROR;
+  }
+  close(fd);
+#else
+  pc->base = (char *)calloc(2, pc->slot);
+  if (pc->base &&
+      (((pc->fp = fopen(pc->file, "r+b")) != NULL) ||
+       ((pc->fp = fopen(pc->file, "w+b")) != NULL)))
+  {
+    if (fread(pc->base, pc->slot, 2, pc->fp) != 2) clearerr(pc->fp);
+  }
+  else
+  {
+    free(pc->base);
+    epicsMutexUnlock(rfCkptLock);
+    epicsPrintf("rfCkptOpen: Cannot open %s\n", pc->file);
+    return RF_CKPT_ERROR;
+  }
+#endif
+  if ((ph = rfCkptNewest(pc)) != NULL) pc->seq = ph->seq;
+  strcpy(pc->status, "not loaded");
+  id = rfCkptCount++;
+  epicsMutexUnlock(rfCkptLock);
+  return id;
+}
+
+/*
+ * Call once per cycle.  Only the owning loop may save.
+ */
+int rfCkptSave(int id, const void *rec)
+{
+  rfCkptLoop    *pc;
+  rfCkptHead    *ph;
+  epicsTimeStamp now;
+  int            i;
+
+  if ((id < 0) || (id >= rfCkptCount) || !rec) return RF_CKPT_ERROR;
+  pc = &rfCkptTable[id];
+  /* Write over the slot not holding the newest record */
+  i  = (pc->seq + 1) & 1;
+  ph = (rfCkptHead *)(pc->base + i * pc->slot);
+  memcpy(ph + 1, rec, pc->size);
+  epicsTimeGetCurrent(&now);
+  ph->version = RF_CKPT_VERSION;
+  ph->seq     = pc->seq + 1;
+  ph->size    = pc->size;
+  ph->sec     = now.secPastEpoch;
+  ph->nsec    = now.nsec;
+  ph->magic   = RF_CKPT_MAGIC;
+  ph->crc     = rfCkptCrc(ph, pc->size);
+  pc->seq++;
+  pc->saves++;
+  if (rfCkptWrite(pc, i) != RF_CKPT_OK)
+  {
+    if (pc->errors++ == 0)
+      epicsPrintf("rfCkptSave: Cannot write %s\n", pc->file);
+    return RF_CKPT_ERROR;
+  }
+  return RF_CKPT_OK;
+}
+
+/*
+ * Returns RF_CKPT_ERROR, and leaves rec alone, when there is no good
+ * record or the newest one is older than maxAge seconds.
+ */
+int rfCkptLoad(int id, void *rec, double maxAge)
+{
+  rfCkptLoop    *pc;
+  rfCkptHead    *ph;
+  epicsTimeStamp now, then;
+
+  if ((id < 0) || (id >= rfCkptCount) || !rec) return RF_CKPT_ERROR;
+  pc = &rfCkptTable[id];
+  if ((ph = rfCkptNewest(pc)) == NULL)
+  {
+    strcpy(pc->status, "no good record");
+    return RF_CKPT_ERROR;
+  }
+  epicsTimeGetCurrent(&now);
+  then.secPastEpoch = ph->sec;
+  then.nsec         = ph->nsec;
+  pc->age = epicsTimeDiffInSeconds(&now, &then);
+  if ((pc->age < 0.0) || (pc->age > maxAge))
+  {
+    strcpy(pc->status, "too old");
+    return RF_CKPT_ERROR;
+  }
+  memcpy(rec, ph + 1, pc->size);
+  strcpy(pc->status, "loaded");
+  return RF_CKPT_OK;
+}
+
+void rfCkptReport(int level)
+{
+  rfCkptLoop *pc;
+  int         i;
+
+  printf("%d checkpoints\n", rfCkptCount);
+  for (i = 0; i < rfCkptCount; i++)
+  {
+    pc = &rfCkptTable[i];
+    printf("  %-28s %10d saves %6d errors  %s", pc->name, pc->saves,
+           pc->errors, pc->status);
+    if (pc->age != 0.0) printf(" (%.1f s old)", pc->age);
+    printf("\n");
+    if (level > 0) printf("    %s, %d byte record\n", pc->file, pc->size);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfCkptReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfCkptReportArgs[] = {&rfCkptReportArg0};
+static const iocshFuncDef rfCkptReportDef =
+  {"rfCkptReport", 1, rfCkptReportArgs};
+static void rfCkptReportCall(const iocshArgBuf *args)
+{
+  rfCkptReport(args[0].ival);
+}
+
+static void rfCkptRegistrar(void)
+{
+  iocshRegister(&rfCkptReportDef, rfCkptReportCall);
+}
+epicsExportRegistrar(rfCkptRegistrar);
@@ -0,0 +1,51 @@
+/*=============================================================================
+
+  Abs:  Loop State Checkpoints for Bumpless Restart
+
+  Name: rfCkpt.h
+
+  Prev: None
+
+  Rem:  A loop opens one checkpoint with the size of its record, saves
+        the record every cycle and, when it starts, loads the last one
+        saved if it is no older than the age it asks for.  The loop
+        itself decides whether the record still agrees with the
+        hardware before resuming from it.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_CKPT_H
+#define RF_CKPT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_CKPT_OK            0
+#define RF_CKPT_ERROR       (-1)
+
+#define RF_CKPT_MAX_LOOPS     48    /* # checkpoints per IOC               */
+#define RF_CKPT_MAX_SIZE      256   /* bytes in one record                 */
+#define RF_CKPT_NAME_LEN      40    /* loop name incl. station             */
+#define RF_CKPT_FILE_LEN      128   /* checkpoint file path                */
+
+/* IOC shell */
+void   rfCkptReport (int level);
+
+/* Loops */
+int    rfCkptOpen   (const char *dir, const char *stn, const char *name,
+                     int size);
+int    rfCkptSave   (int id, const void *rec);
+int    rfCkptLoad   (int id, void *rec, double maxAge);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_CKPT_H */
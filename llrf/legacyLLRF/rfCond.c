@@ -0,0 +1,153 @@
+/*=============================================================================
+
+  Abs:  Conditioning Trend Forecasts for the HVPS Process State
+
+  Name: rfCond.c
+         Public:
+           rfCondReset    - empty a trend
+           rfCondAdd      - add a reading at the current time
+           rfCondForecast - rate of rise and forecast of a trend
+           rfCondScale    - step scale from the forecast headroom
+           rfCondDelta    - voltage step for a step scale
+         Private:
+           rfCondNow      - current time in seconds
+
+  Rem:  While processing, rf_hvps_loop used to step the HVPS voltage up
+        by a fixed amount on every cycle until the worst cavity vacuum
+        or gap voltage went MAJOR, then back down.  Vacuum bursts were
+        only seen once they had reached the limit.
+
+        The process state now keeps a trend of the worst cavity vacuum
+        (in decades) and of the worst gap voltage, fits a straight line
+        to the last RF_COND_WINDOW readings and forecasts each a short
+        horizon ahead.  The headroom of a forecast is its distance
+        below the MAJOR limit, over a margin (decades of vacuum, or a
+        fraction of the gap voltage limit).  The smaller headroom sets
+        the step scale:
+
+        o scale >= 1    room to spare: step up faster, up to step_max
+        o 0 < scale < 1 closing in: step up by the scale
+        o scale <= 0    the forecast crosses the limit: step down,
+                        before the reading itself goes MAJOR
+
+        The reactive back-off on MAJOR is kept by the sequence.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <math.h>
+
+#include <epicsTime.h>
+
+#include "rfCond.h"
+
+#define RF_COND_PREDOWN_FRAC  0.5    /* part of the down step taken early   */
+
+static double rfCondNow(void)
+{
+  epicsTimeStamp now;
+
+  epicsTimeGetCurrent(&now);
+  return now.secPastEpoch + now.nsec * 1e-9;
+}
+
+void rfCondReset(rfCondTrend *pt, int logy)
+{
+  pt->n    = 0;
+  pt->next = 0;
+  pt->logy = logy;
+}
+
+/*
+ * Readings that can't be logged (a vacuum of zero from a gauge that is
+ * off) are dropped.
+ */
+int rfCondAdd(rfCondTrend *pt, double value)
+{
+  if (pt->logy)
+  {
+    if (!(value > 0.0)) return RF_COND_ERROR;
+    value = log10(value);
+  }
+
+  pt->t[pt->next] = rfCondNow();
+  pt->y[pt->next] = value;
+  pt->next = (pt->next + 1) % RF_COND_WINDOW;
+  if (pt->n < RF_COND_WINDOW) pt->n++;
+  return RF_COND_OK;
+}
+
+/*
+ * Least squares line through the trend.  Times are taken relative to
+ * the newest reading so the sums stay well conditioned.  The forecast
+ * is the line at horizon seconds past the newest reading, in the units
+ * of the readings (not logged).
+ */
+int rfCondForecast(const rfCondTrend *pt, double horizon,
+                   double *rate, double *forecast)
+{
+  double t0, st = 0, sy = 0, stt = 0, sty = 0, dt, den, slope, icpt;
+  int    i, newest;
+
+  if (pt->n < RF_COND_MIN_POINTS) return RF_COND_ERROR;
+
+  newest = (pt->next + RF_COND_WINDOW - 1) % RF_COND_WINDOW;
+  t0     = pt->t[newest];
+  for (i = 0; i < pt->n; i++)
+  {
+    dt   = pt->t[i] - t0;
+    st  += dt;
+    sy  += pt->y[i];
+    stt += dt * dt;
+    sty += dt * pt->y[i];
+  }
+  den = pt->n * stt - st * st;
+  if (den <= 0.0) return RF_COND_ERROR;
+  slope = (pt->n * sty - st * sy) / den;
+  icpt  = (sy - slope * st) / pt->n;
+
+  *rate     = slope;
+  *forecast = icpt + slope * horizon;
+  if (pt->logy) *forecast = pow(10.0, *forecast);
+  return RF_COND_OK;
+}
+
+/*
+ * A limit <= 0 (no limit, or no trend yet) leaves that reading out; with
+ * neither the scale is 1, the old fixed step.
+ */
+double rfCondScale(double vacm_fcst, double vacm_limit, double decades,
+                   double gapv_fcst, double gapv_limit, double fraction,
+                   double step_max)
+{
+  double scale = step_max, room;
+  int    used  = 0;
+
+  if ((vacm_limit > 0.0) && (vacm_fcst > 0.0) && (decades > 0.0))
+  {
+    room = (log10(vacm_limit) - log10(vacm_fcst)) / decades;
+    if (room < scale) scale = room;
+    used = 1;
+  }
+  if ((gapv_limit > 0.0) && (fraction > 0.0))
+  {
+    room = (gapv_limit - gapv_fcst) / (fraction * gapv_limit);
+    if (room < scale) scale = room;
+    used = 1;
+  }
+  if (!used)        return 1.0;
+  if (scale < -1.0) scale = -1.0;
+  return scale;
+}
+
+double rfCondDelta(double scale, double up, double down)
+{
+  if (scale > 0.0) return up * scale;
+  return down * (-scale) * RF_COND_PREDOWN_FRAC;
+}
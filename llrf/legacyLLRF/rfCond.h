@@ -0,0 +1,56 @@
+/*=============================================================================
+
+  Abs:  Conditioning Trend Forecasts for the HVPS Process State
+
+  Name: rfCond.h
+
+  Prev: None
+
+  Rem:  A trend holds the last RF_COND_WINDOW samples of one reading and
+        gives its rate of rise and a straight-line forecast a short
+        horizon ahead.  Vacuum trends are kept in decades (log10).
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_COND_H
+#define RF_COND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_COND_OK           0
+#define RF_COND_ERROR      (-1)
+
+#define RF_COND_WINDOW       16     /* # samples in a trend fit             */
+#define RF_COND_MIN_POINTS   4      /* # samples before a forecast is made  */
+
+typedef struct
+{
+  double t[RF_COND_WINDOW];         /* sample times (sec.)                  */
+  double y[RF_COND_WINDOW];         /* samples, log10 for a log trend       */
+  int    n;                         /* # samples held                       */
+  int    next;                      /* slot of the next sample              */
+  int    logy;                      /* keep log10 of the readings           */
+} rfCondTrend;
+
+void   rfCondReset   (rfCondTrend *pt, int logy);
+int    rfCondAdd     (rfCondTrend *pt, double value);
+int    rfCondForecast(const rfCondTrend *pt, double horizon,
+                      double *rate, double *forecast);
+double rfCondScale   (double vacm_fcst, double vacm_limit, double decades,
+                      double gapv_fcst, double gapv_limit, double fraction,
+                      double step_max);
+double rfCondDelta   (double scale, double up, double down);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_COND_H */
@@ -0,0 +1,411 @@
+/*=============================================================================
+
+  Abs:  Station Cavity Detuning and Load Angle Estimator
+
+  Name: rfDetune.c
+         Public:
+           rfDetuneReport - print the estimates of every station
+           rfDetuneOpen   - find or create the estimator of a station
+           rfDetuneEnable - let the estimator drive the tuner loops
+           rfDetuneCal    - load angle offset, tuner gain and minimum
+                            forward amplitude of a cavity
+           rfDetuneBlock  - estimate all cavities from one block of I & Q
+           rfDetuneGet    - latest estimate of a cavity
+           rfDetuneRate   - blocks per second
+           rfDetuneFlag   - set a tuner loop event flag on each estimate
+           rfDetuneDelta  - fresh posn delta and noise for a tuner loop
+         Private:
+           rfDetuneInit   - create the table lock
+           rfDetuneSums   - phasor sums of a cavity per sub-block
+           rfDetuneNow    - current time in seconds
+
+  Rem:  rf_tuner_loop took posn delta and the load angle severity from
+        calc records, one cavity per record chain, each waiting on its
+        own phase measurement.  This estimator takes forward (f),
+        reflected (r) and probe (p) I & Q waveforms of all cavities of a
+        station in one block and, per cavity:
+
+          load angle    arg(sum p.conj(f))
+          detune angle  arg((1 + G) / (1 - G)),  G = sum r.conj(f) / sum |f|^2
+          posn delta    gain * (offset - load angle)
+          noise         |gain| * std. error of the load angle over
+                        RF_DETUNE_NSUB sub-blocks
+
+        Angles come from phasor sums, so there is no per-sample trig:
+        the inner loops are multiply-adds over contiguous float arrays
+        with independent accumulators, which the compiler can vectorize,
+        and only ncav * (RF_DETUNE_NSUB + 2) atan2 calls are made per
+        block.
+
+        Each estimate raises the event flags of the tuner loops that
+        registered with rfDetuneFlag(), while the estimator is enabled,
+        so a loop sees a fresh measurement for every block instead of
+        every record chain cycle.
+
+        IOC shell:
+          rfDetuneReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <seqCom.h>          /* seq_efSet prototype                 */
+#include <epicsExport.h>
+
+#include "rfDetune.h"
+
+#define RF_DETUNE_STN_LEN     16
+#define RF_DETUNE_RATE_AVG    0.1    /* weight of a new block interval      */
+
+#define RF_DETUNE_DEG         (180.0 / 3.14159265358979323846)
+
+typedef struct
+{
+  double        offset;      /* load angle setpoint (deg)                 */
+  double        gain;        /* posn change per degree                    */
+  double        amin;        /* minimum rms forward amplitude             */
+  double        detune;      /* estimates                                 */
+  double        ldang;
+  double        delta;
+  double        noise;
+  double        ampl;        /* rms forward amplitude                     */
+  double        time;        /* time of the estimate                      */
+  int           status;
+  void         *ssId;        /* tuner loop to notify, or NULL             */
+  int           ef;
+} rfDetuneCav;
+
+typedef struct
+{
+  char          stn[RF_DETUNE_STN_LEN];
+  epicsMutexId  lock;
+  int           enabled;
+  double        last;        /* time of the last block                    */
+  double        interval;    /* average block interval                    */
+  unsigned long blocks;
+  rfDetuneCav   cav[RF_DETUNE_MAX_CAVS];
+} rfDetuneStn;
+
+/* Phasor sums of one sub-block */
+typedef struct
+{
+  double        pfr, pfi;    /* sum p.conj(f)                             */
+  double        rfr, rfi;    /* sum r.conj(f)                             */
+  double        ff;          /* sum |f|^2                                 */
+} rfDetuneSum;
+
+static rfDetuneStn  *rfDetuneTable[RF_DETUNE_MAX_STATIONS];
+static int           rfDetuneCount     = 0;
+static epicsMutexId  rfDetuneTableLock = NULL;
+static epicsThreadOnceId rfDetuneOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfDetuneInit(void *arg)
+{
+  rfDetuneTableLock = epicsMutexMustCreate();
+}
+
+static double rfDetuneNow(void)
+{
+  epicsTimeStamp now;
+
+  epicsTimeGetCurrent(&now);
+  return now.secPastEpoch + now.nsec * 1e-9;
+}
+
+static rfDetuneStn *rfDetuneGetStn(int id)
+{
+  if ((id < 0) || (id >= rfDetuneCount)) return NULL;
+  return rfDetuneTable[id];
+}
+
+static double rfDetuneWrap(double deg)
+{
+  while (deg >   180.0) deg -= 360.0;
+  while (deg <= -180.0) deg += 360.0;
+  return deg;
+}
+
+/*
+ * Sums of m samples starting at each sub-block.  Single precision
+ * accumulators keep the loop vectorizable; a sub-block is short enough
+ * that they don't lose anything that matters to an angle.
+ */
+static void rfDetuneSums(int m, const float *fi, const float *fq,
+                         const float *ri, const float *rq,
+                         const float *pi, const float *pq,
+                         rfDetuneSum *sum)
+{
+  float pfr, pfi, rfr, rfi, ff;
+  int   s, k, base;
+
+  for (s = 0; s < RF_DETUNE_NSUB; s++)
+  {
+    base = s * m;
+    pfr = pfi = rfr = rfi = ff = 0.0f;
+    for (k = base; k < base + m; k++)
+    {
+      pfr += pi[k] * fi[k] + pq[k] * fq[k];
+      pfi += pq[k] * fi[k] - pi[k] * fq[k];
+      rfr += ri[k] * fi[k] + rq[k] * fq[k];
+      rfi += rq[k] * fi[k] - ri[k] * fq[k];
+      ff  += fi[k] * fi[k] + fq[k] * fq[k];
+    }
+    sum[s].pfr = pfr;
+    sum[s].pfi = pfi;
+    sum[s].rfr = rfr;
+    sum[s].rfi = rfi;
+    sum[s].ff  = ff;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfDetuneOpen(const char *stn)
+{
+  rfDetuneStn *ps;
+  int          id;
+
+  if (!stn) stn = "";
+  epicsThreadOnce(&rfDetuneOnce, rfDetuneInit, NULL);
+  epicsMutexMustLock(rfDetuneTableLock);
+  for (id = 0; id < rfDetuneCount; id++)
+    if (!strncmp(stn, rfDetuneTable[id]->stn, RF_DETUNE_STN_LEN - 1)) break;
+  if (id == rfDetuneCount)
+  {
+    ps = NULL;
+    if (rfDetuneCount < RF_DETUNE_MAX_STATIONS)
+      ps = (rfDetuneStn *)calloc(1, sizeof(*ps));
+    if (ps)
+    {
+      sprintf(ps->stn, "%.*s", RF_DETUNE_STN_LEN - 1, stn);
+      ps->lock = epicsMutexMustCreate();
+      rfDetuneTable[rfDetuneCount++] = ps;
+    }
+    else
+    {
+      epicsPrintf("rfDetuneOpen: No room for station %s\n", stn);
+      id = RF_DETUNE_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfDetuneTableLock);
+  return id;
+}
+
+int rfDetuneEnable(int id, int enable)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+
+  if (!ps) return RF_DETUNE_ERROR;
+  ps->enabled = enable;
+  return RF_DETUNE_OK;
+}
+
+int rfDetuneCal(int id, int cav, double offset, double gain, double amin)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+
+  if (!ps || (cav < 0) || (cav >= RF_DETUNE_MAX_CAVS)) return RF_DETUNE_ERROR;
+  epicsMutexMustLock(ps->lock);
+  ps->cav[cav].offset = offset;
+  ps->cav[cav].gain   = gain;
+  ps->cav[cav].amin   = amin;
+  epicsMutexUnlock(ps->lock);
+  return RF_DETUNE_OK;
+}
+
+/*
+ * Waveforms are [ncav][stride] arrays; the first n samples of each row
+ * are used, less any remainder after RF_DETUNE_NSUB sub-blocks.
+ */
+int rfDetuneBlock(int id, int ncav, int n, int stride,
+                  const float *fi, const float *fq,
+                  const float *ri, const float *rq,
+                  const float *pi, const float *pq)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+  rfDetuneCav *pc;
+  rfDetuneSum  sum[RF_DETUNE_NSUB], tot;
+  double       now, ang, dev, var, gr, gi;
+  int          m = n / RF_DETUNE_NSUB, c, s, off;
+
+  if (!ps || (m < 1) || (ncav < 1)) return RF_DETUNE_ERROR;
+  if (ncav > RF_DETUNE_MAX_CAVS) ncav = RF_DETUNE_MAX_CAVS;
+  now = rfDetuneNow();
+  epicsMutexMustLock(ps->lock);
+  for (c = 0; c < ncav; c++)
+  {
+    pc  = &ps->cav[c];
+    off = c * stride;
+    rfDetuneSums(m, fi + off, fq + off, ri + off, rq + off, pi + off,
+                 pq + off, sum);
+    memset(&tot, 0, sizeof(tot));
+    for (s = 0; s < RF_DETUNE_NSUB; s++)
+    {
+      tot.pfr += sum[s].pfr;
+      tot.pfi += sum[s].pfi;
+      tot.rfr += sum[s].rfr;
+      tot.rfi += sum[s].rfi;
+      tot.ff  += sum[s].ff;
+    }
+    pc->time = now;
+    pc->ampl = sqrt(tot.ff / (m * RF_DETUNE_NSUB));
+    if ((tot.ff <= 0.0) || (pc->ampl < pc->amin))
+    {
+      pc->status = RF_DETUNE_STATUS_LOWPWR;
+      continue;
+    }
+    pc->ldang  = atan2(tot.pfi, tot.pfr) * RF_DETUNE_DEG;
+    gr         = tot.rfr / tot.ff;
+    gi         = tot.rfi / tot.ff;
+    pc->detune = rfDetuneWrap((atan2(gi, 1.0 + gr) - atan2(-gi, 1.0 - gr)) *
+                              RF_DETUNE_DEG);
+    for (var = 0.0, s = 0; s < RF_DETUNE_NSUB; s++)
+    {
+      ang  = atan2(sum[s].pfi, sum[s].pfr) * RF_DETUNE_DEG;
+      dev  = rfDetuneWrap(ang - pc->ldang);
+      var += dev * dev;
+    }
+    var      /= (RF_DETUNE_NSUB - 1);
+    pc->delta = pc->gain * rfDetuneWrap(pc->offset - pc->ldang);
+    pc->noise = fabs(pc->gain) * sqrt(var / RF_DETUNE_NSUB);
+    pc->status = (pc->gain != 0.0) ? RF_DETUNE_STATUS_GOOD :
+                                     RF_DETUNE_STATUS_NOCAL;
+  }
+  if (ps->blocks == 1)
+    ps->interval  = now - ps->last;
+  else if (ps->blocks > 1)
+    ps->interval += RF_DETUNE_RATE_AVG * ((now - ps->last) - ps->interval);
+  ps->last = now;
+  ps->blocks++;
+  if (ps->enabled)
+    for (c = 0; c < ncav; c++)
+      if (ps->cav[c].ssId && (ps->cav[c].status == RF_DETUNE_STATUS_GOOD))
+        seq_efSet((SS_ID)ps->cav[c].ssId, ps->cav[c].ef);
+  epicsMutexUnlock(ps->lock);
+  return RF_DETUNE_OK;
+}
+
+int rfDetuneGet(int id, int cav, double *detune, double *ldang,
+                double *delta, double *noise, int *status)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+  rfDetuneCav *pc;
+
+  if (!ps || (cav < 0) || (cav >= RF_DETUNE_MAX_CAVS)) return RF_DETUNE_ERROR;
+  epicsMutexMustLock(ps->lock);
+  pc      = &ps->cav[cav];
+  *detune = pc->detune;
+  *ldang  = pc->ldang;
+  *delta  = pc->delta;
+  *noise  = pc->noise;
+  *status = pc->status;
+  epicsMutexUnlock(ps->lock);
+  return RF_DETUNE_OK;
+}
+
+double rfDetuneRate(int id)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+
+  if (!ps || (ps->interval <= 0.0)) return 0.0;
+  return 1.0 / ps->interval;
+}
+
+int rfDetuneFlag(int id, int cav, void *ssId, int ef)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+
+  if (!ps || (cav < 0) || (cav >= RF_DETUNE_MAX_CAVS)) return RF_DETUNE_ERROR;
+  epicsMutexMustLock(ps->lock);
+  ps->cav[cav].ssId = ssId;
+  ps->cav[cav].ef   = ef;
+  epicsMutexUnlock(ps->lock);
+  return RF_DETUNE_OK;
+}
+
+/*
+ * Only a good estimate less than RF_DETUNE_STALE old is returned.
+ */
+int rfDetuneDelta(int id, int cav, float *delta, float *noise)
+{
+  rfDetuneStn *ps = rfDetuneGetStn(id);
+  rfDetuneCav *pc;
+  int          status = RF_DETUNE_ERROR;
+
+  if (!ps || (cav < 0) || (cav >= RF_DETUNE_MAX_CAVS)) return RF_DETUNE_ERROR;
+  epicsMutexMustLock(ps->lock);
+  pc = &ps->cav[cav];
+  if ((pc->status == RF_DETUNE_STATUS_GOOD) &&
+      (rfDetuneNow() - pc->time < RF_DETUNE_STALE))
+  {
+    *delta = (float)pc->delta;
+    *noise = (float)pc->noise;
+    status = RF_DETUNE_OK;
+  }
+  epicsMutexUnlock(ps->lock);
+  return status;
+}
+
+void rfDetuneReport(int level)
+{
+  static const char *statusName[] = {"NONE", "GOOD", "LOWPWR", "NOCAL"};
+  rfDetuneStn       *ps;
+  rfDetuneCav       *pc;
+  int                i, c;
+
+  printf("%d detune estimators\n", rfDetuneCount);
+  for (i = 0; i < rfDetuneCount; i++)
+  {
+    ps = rfDetuneTable[i];
+    epicsMutexMustLock(ps->lock);
+    printf("%-8s %s %lu blocks %.2f/sec\n", ps->stn,
+           ps->enabled ? "driving loops" : "monitor only", ps->blocks,
+           (ps->interval > 0.0) ? 1.0 / ps->interval : 0.0);
+    for (c = 0; c < RF_DETUNE_MAX_CAVS; c++)
+    {
+      pc = &ps->cav[c];
+      printf("  CAV%d %-6s detune %7.2f ldang %7.2f delta %9.4f +- %.4f\n",
+             c + 1, statusName[pc->status], pc->detune, pc->ldang,
+             pc->delta, pc->noise);
+      if (level > 0)
+        printf("%8s offset %7.2f gain %9.4f ampl %g (min %g)%s\n", "",
+               pc->offset, pc->gain, pc->ampl, pc->amin,
+               pc->ssId ? " loop registered" : "");
+    }
+    epicsMutexUnlock(ps->lock);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfDetuneReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfDetuneReportArgs[] = {&rfDetuneReportArg0};
+static const iocshFuncDef rfDetuneReportDef =
+  {"rfDetuneReport", 1, rfDetuneReportArgs};
+static void rfDetuneReportCall(const iocshArgBuf *args)
+{
+  rfDetuneReport(args[0].ival);
+}
+
+static void rfDetuneRegistrar(void)
+{
+  iocshRegister(&rfDetuneReportDef, rfDetuneReportCall);
+}
+epicsExportRegistrar(rfDetuneRegistrar);
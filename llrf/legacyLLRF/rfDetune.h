@@ -0,0 +1,69 @@
+/*=============================================================================
+
+  Abs:  Station Cavity Detuning and Load Angle Estimator
+
+  Name: rfDetune.h
+
+  Prev: seqCom.h              (SS_ID typedef, only for rfDetuneFlag)
+
+  Rem:  One estimator per station works on blocks of forward, reflected
+        and probe I & Q for all cavities at once and gives, per cavity,
+        the detuning angle, the load angle, the tuner position change
+        (posn delta) that brings the load angle to its offset, and the
+        standard error of that change.  Angles are in degrees; the posn
+        delta is in the units of the tuner gain (mm per degree).
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_DETUNE_H
+#define RF_DETUNE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_DETUNE_OK           0
+#define RF_DETUNE_ERROR      (-1)
+
+#define RF_DETUNE_MAX_STATIONS 4    /* # estimators per IOC                 */
+#define RF_DETUNE_MAX_CAVS     4    /* # cavities per station               */
+#define RF_DETUNE_NSUB         8    /* # sub-blocks for the noise estimate  */
+#define RF_DETUNE_STALE        5.0  /* sec. before an estimate is stale     */
+
+/* Statuses, these MUST match pvs {STN}:CAV{CAV}TUNR:EST:STATUS */
+#define RF_DETUNE_STATUS_NONE    0  /* no block yet                         */
+#define RF_DETUNE_STATUS_GOOD    1
+#define RF_DETUNE_STATUS_LOWPWR  2  /* forward below the minimum amplitude  */
+#define RF_DETUNE_STATUS_NOCAL   3  /* no tuner gain                        */
+
+/* IOC shell */
+void   rfDetuneReport (int level);
+
+/* Estimator */
+int    rfDetuneOpen   (const char *stn);
+int    rfDetuneEnable (int id, int enable);
+int    rfDetuneCal    (int id, int cav, double offset, double gain,
+                       double amin);
+int    rfDetuneBlock  (int id, int ncav, int n, int stride,
+                       const float *fi, const float *fq,
+                       const float *ri, const float *rq,
+                       const float *pi, const float *pq);
+int    rfDetuneGet    (int id, int cav, double *detune, double *ldang,
+                       double *delta, double *noise, int *status);
+double rfDetuneRate   (int id);
+
+/* Tuner loops */
+int    rfDetuneFlag   (int id, int cav, void *ssId, int ef);
+int    rfDetuneDelta  (int id, int cav, float *delta, float *noise);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_DETUNE_H */
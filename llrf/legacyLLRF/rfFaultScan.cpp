@@ -0,0 +1,504 @@
+/*=============================================================================
+
+  Abs:  Batch Analyzer for Station Fault Files
+
+  Name: rfFaultScan.cpp
+         main              - parse options, scan, analyze and print
+         rfFaultScanDir    - collect FAULT<module>_<n> files into faults
+         rfFaultLoad       - map a file and decode its samples
+         rfFaultAnalyze    - features and class of one fault
+         rfFaultWorker     - analyze faults from the shared queue
+         Kernels:
+           rfFaultAmp      - amplitude of an I & Q pair
+           rfFaultMean     - mean of a span
+           rfFaultBelow    - first sample below a level
+           rfFaultPeak     - largest sample of a span and where
+
+  Rem:  rf_statesFF writes one file per module buffer and fault number
+        (see faultroot in rf_states.st), e.g. /dat/FAULTRfpSI_3, and the
+        fault number wraps at NUMFAULTS.  This tool reads whole
+        directories of them, groups the files of each fault by directory
+        and fault number, and prints one line per fault:
+
+          time of the fault (newest file of the group)
+          collapse  sample where the station amplitude (RfpSI/SQ) falls
+                    below RF_FAULT_COLLAPSE of its pre-fault level
+          dphi      largest station phase excursion before the collapse
+          refl      reflected amplitude (Iqa2Amp) peak over its pre-fault
+                    level before the collapse, and its lead
+          arc       first non-zero AIM sample and its bits
+          class     ARC, REFL, PHASE, DROP (collapse without any of the
+                    above), NOTRIP or INCOMPLETE (no station I & Q)
+
+        Leads are in samples before the collapse, or in us with -r.
+        A file more than RF_FAULT_STALE seconds older than the newest of
+        its group is left over from an earlier fault with that number
+        and is not used.
+
+        The files are the module history buffers as the module drivers
+        write them: text with one or more numbers per line, or raw
+        16-bit samples (big-endian as written by the VME IOCs; -l for
+        little-endian, -f for 32-bit floats).  Text is recognised from
+        the start of the file.
+
+        Files are memory mapped and faults are analyzed by -j threads
+        (default: all processors).  The kernels are plain loops over
+        contiguous float arrays that the compiler vectorizes at -O3.
+
+        Usage:
+          rfFaultScan [-j threads] [-r rate_hz] [-l] [-f] [-v] dir ...
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define RF_FAULT_BASE       0.25   /* leading fraction that is pre-fault    */
+#define RF_FAULT_COLLAPSE   0.5    /* amplitude fraction of a collapse      */
+#define RF_FAULT_PHASE      20.0   /* phase excursion of a PHASE trip (deg) */
+#define RF_FAULT_REFL       3.0    /* reflected peak of a REFL trip         */
+#define RF_FAULT_STALE      180.0  /* sec. - MAXFFWAIT in rf_states.st      */
+#define RF_FAULT_TEXT_PROBE 256    /* bytes looked at to recognise text     */
+
+#define RF_FAULT_DEG        (180.0 / 3.14159265358979323846)
+
+/* Module buffers that are used, by faultroot name */
+enum rfFaultChan
+{
+  RF_FAULT_CH_STN_I = 0,   /* FAULTRfpSI_   station I                    */
+  RF_FAULT_CH_STN_Q,       /* FAULTRfpSQ_   station Q                    */
+  RF_FAULT_CH_REFL,        /* FAULTIqa2Amp_ reflected amplitude          */
+  RF_FAULT_CH_AIM,         /* FAULTAim_     AIM history                  */
+  RF_FAULT_NCHAN
+};
+
+static const char *rfFaultChanName[RF_FAULT_NCHAN] =
+  {"RfpSI", "RfpSQ", "Iqa2Amp", "Aim"};
+
+enum rfFaultFormat
+{
+  RF_FAULT_I16_BE,
+  RF_FAULT_I16_LE,
+  RF_FAULT_F32
+};
+
+struct rfFaultFile
+{
+  std::string path;
+  std::string module;
+  time_t      mtime;
+};
+
+struct rfFault
+{
+  std::string              dir;
+  int                      num;
+  time_t                   time;
+  std::vector<rfFaultFile> files;
+  /* Results */
+  int                      nused;
+  long                     collapse;   /* sample, -1 none                */
+  long                     nsamp;
+  double                   dphi;       /* deg                            */
+  double                   refl;       /* peak / pre-fault level         */
+  long                     refl_lead;  /* samples before collapse        */
+  long                     arc_lead;   /* samples before collapse        */
+  unsigned                 arc_bits;   /* first non-zero AIM sample      */
+  bool                     arc;
+  const char              *cls;
+};
+
+static int               rfFaultVerbose = 0;
+static rfFaultFormat     rfFaultFmt     = RF_FAULT_I16_BE;
+
+/*----------------------------------------------------------------------------*/
+/* Kernels */
+
+static void rfFaultAmp(const float *i, const float *q, float *a, long n)
+{
+  for (long k = 0; k < n; k++) a[k] = sqrtf(i[k] * i[k] + q[k] * q[k]);
+}
+
+static double rfFaultMean(const float *a, long n)
+{
+  float sum = 0.0f;
+
+  for (long k = 0; k < n; k++) sum += a[k];
+  return (n > 0) ? sum / n : 0.0;
+}
+
+static long rfFaultBelow(const float *a, long from, long n, float level)
+{
+  for (long k = from; k < n; k++)
+    if (a[k] < level) return k;
+  return -1;
+}
+
+static long rfFaultPeak(const float *a, long n, float *peak)
+{
+  long  at  = 0;
+  float big = (n > 0) ? a[0] : 0.0f;
+
+  for (long k = 1; k < n; k++)
+    if (a[k] > big) { big = a[k]; at = k; }
+  *peak = big;
+  return at;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static bool rfFaultIsText(const unsigned char *p, size_t len)
+{
+  size_t n = std::min(len, (size_t)RF_FAULT_TEXT_PROBE);
+
+  for (size_t k = 0; k < n; k++)
+    if (!strchr("0123456789+-.eE \t\r\n,", p[k]) || !p[k]) return false;
+  return (n > 0);
+}
+
+static void rfFaultText(const char *p, size_t len, std::vector<float> &out)
+{
+  char   tok[64];
+  size_t k = 0, n;
+
+  while (k < len)
+  {
+    while ((k < len) && strchr(" \t\r\n,", p[k])) k++;
+    for (n = 0; (k < len) && !strchr(" \t\r\n,", p[k]); k++)
+      if (n < sizeof(tok) - 1) tok[n++] = p[k];
+    if (n == 0) continue;
+    tok[n] = '\0';
+    out.push_back((float)strtod(tok, NULL));
+  }
+}
+
+/*
+ * Returns false, with a message, if the file can't be read.
+ */
+static bool rfFaultLoad(const std::string &path, std::vector<float> &out)
+{
+  struct stat           st;
+  const unsigned char  *p;
+  void                 *map;
+  size_t                len, n, k;
+  int                   fd;
+
+  out.clear();
+  if ((fd = open(path.c_str(), O_RDONLY)) < 0)
+  {
+    fprintf(stderr, "rfFaultScan: %s: %s\n", path.c_str(), strerror(errno));
+    return false;
+  }
+  if ((fstat(fd, &st) < 0) || (st.st_size == 0))
+  {
+    close(fd);
+    return false;
+  }
+  len = (size_t)st.st_size;
+  map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "rfFaultScan: %s: %s\n", path.c_str(), strerror(errno));
+    return false;
+  }
+  madvise(map, len, MADV_SEQUENTIAL);
+  p = (const unsigned char *)map;
+  if (rfFaultIsText(p, len))
+  {
+    rfFaultText((const char *)p, len, out);
+  }
+  else if (rfFaultFmt == RF_FAULT_F32)
+  {
+    n = len / sizeof(float);
+    out.resize(n);
+    if (n > 0) memcpy(&out[0], p, n * sizeof(float));
+  }
+  else
+  {
+    n = len / 2;
+    out.resize(n);
+    if (rfFaultFmt == RF_FAULT_I16_BE)
+      for (k = 0; k < n; k++)
+        out[k] = (float)(short)((p[2 * k] << 8) | p[2 * k + 1]);
+    else
+      for (k = 0; k < n; k++)
+        out[k] = (float)(short)((p[2 * k + 1] << 8) | p[2 * k]);
+  }
+  munmap(map, len);
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * FAULT<module>_<n> -> module, n.  False for any other name.
+ */
+static bool rfFaultName(const char *name, std::string &module, int &num)
+{
+  const char *us = strrchr(name, '_');
+  char       *end;
+
+  if (strncmp(name, "FAULT", 5) || !us || (us == name + 5)) return false;
+  num = (int)strtol(us + 1, &end, 10);
+  if ((end == us + 1) || *end || (num < 1)) return false;
+  module.assign(name + 5, us - (name + 5));
+  return true;
+}
+
+static int rfFaultScanDir(const char *dir, std::vector<rfFault> &faults)
+{
+  std::map<int, size_t> index;
+  struct dirent        *de;
+  struct stat           st;
+  rfFaultFile           file;
+  std::string           module;
+  DIR                  *dp;
+  int                   num, nfiles = 0;
+
+  if (!(dp = opendir(dir)))
+  {
+    fprintf(stderr, "rfFaultScan: %s: %s\n", dir, strerror(errno));
+    return 0;
+  }
+  while ((de = readdir(dp)))
+  {
+    if (!rfFaultName(de->d_name, module, num)) continue;
+    file.path   = std::string(dir) + "/" + de->d_name;
+    file.module = module;
+    if ((stat(file.path.c_str(), &st) < 0) || !S_ISREG(st.st_mode)) continue;
+    file.mtime  = st.st_mtime;
+    if (!index.count(num))
+    {
+      index[num] = faults.size();
+      faults.push_back(rfFault());
+      faults.back().dir  = dir;
+      faults.back().num  = num;
+      faults.back().time = 0;
+    }
+    rfFault &f = faults[index[num]];
+    f.files.push_back(file);
+    f.time = std::max(f.time, file.mtime);
+    nfiles++;
+  }
+  closedir(dp);
+  return nfiles;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static void rfFaultAnalyze(rfFault &f)
+{
+  std::vector<float> chan[RF_FAULT_NCHAN], amp;
+  long               nbase, n, k, lead;
+  double             level, bi, bq, dot, crs, ang;
+  float              peak;
+
+  f.nused    = 0;
+  f.collapse = -1;
+  f.nsamp    = 0;
+  f.dphi     = 0.0;
+  f.refl     = 0.0;
+  f.refl_lead = -1;
+  f.arc_lead = -1;
+  f.arc_bits = 0;
+  f.arc      = false;
+  for (size_t j = 0; j < f.files.size(); j++)
+  {
+    const rfFaultFile &file = f.files[j];
+
+    if (difftime(f.time, file.mtime) > RF_FAULT_STALE) continue;
+    f.nused++;
+    for (int c = 0; c < RF_FAULT_NCHAN; c++)
+      if (file.module == rfFaultChanName[c]) rfFaultLoad(file.path, chan[c]);
+  }
+  n = (long)std::min(chan[RF_FAULT_CH_STN_I].size(),
+                     chan[RF_FAULT_CH_STN_Q].size());
+  if (n < 4)
+  {
+    f.cls = "INCOMPLETE";
+    return;
+  }
+  f.nsamp = n;
+  nbase   = std::max(1L, (long)(n * RF_FAULT_BASE));
+  const float *si = &chan[RF_FAULT_CH_STN_I][0];
+  const float *sq = &chan[RF_FAULT_CH_STN_Q][0];
+
+  /* Amplitude collapse */
+  amp.resize(n);
+  rfFaultAmp(si, sq, &amp[0], n);
+  level      = rfFaultMean(&amp[0], nbase);
+  f.collapse = rfFaultBelow(&amp[0], nbase, n,
+                            (float)(level * RF_FAULT_COLLAPSE));
+
+  /* Phase excursion from the pre-fault phasor, up to the collapse */
+  bi = rfFaultMean(si, nbase);
+  bq = rfFaultMean(sq, nbase);
+  lead = (f.collapse >= 0) ? f.collapse : n;
+  for (k = nbase; k < lead; k++)
+  {
+    dot = si[k] * bi + sq[k] * bq;
+    crs = sq[k] * bi - si[k] * bq;
+    ang = fabs(atan2(crs, dot)) * RF_FAULT_DEG;
+    if (ang > f.dphi) f.dphi = ang;
+  }
+
+  /* Reflected spike before the collapse */
+  std::vector<float> &rf = chan[RF_FAULT_CH_REFL];
+  if ((long)rf.size() > nbase)
+  {
+    long m = std::min((long)rf.size(), lead);
+    double base = fabs(rfFaultMean(&rf[0], nbase));
+    if (m > nbase)
+    {
+      k = nbase + rfFaultPeak(&rf[nbase], m - nbase, &peak);
+      if (base > 0.0) f.refl = peak / base;
+      f.refl_lead = lead - k;
+    }
+  }
+
+  /* Arc - first non-zero AIM sample */
+  std::vector<float> &aim = chan[RF_FAULT_CH_AIM];
+  for (k = 0; k < (long)aim.size(); k++)
+  {
+    if (aim[k] == 0.0f) continue;
+    f.arc      = true;
+    f.arc_bits = (unsigned)aim[k] & 0xffff;
+    f.arc_lead = lead - k;
+    break;
+  }
+
+  if      (f.collapse < 0)                          f.cls = "NOTRIP";
+  else if (f.arc && (f.arc_lead >= 0))              f.cls = "ARC";
+  else if (f.refl >= RF_FAULT_REFL)                 f.cls = "REFL";
+  else if (f.dphi >= RF_FAULT_PHASE)                f.cls = "PHASE";
+  else                                              f.cls = "DROP";
+}
+
+static void rfFaultWorker(std::vector<rfFault> *faults,
+                          std::atomic<size_t> *next)
+{
+  size_t j;
+
+  while ((j = (*next)++) < faults->size()) rfFaultAnalyze((*faults)[j]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static bool rfFaultEarlier(const rfFault &a, const rfFault &b)
+{
+  return (a.time != b.time) ? (a.time < b.time) : (a.num < b.num);
+}
+
+static void rfFaultLead(long lead, double rate, char *buf)
+{
+  if (lead < 0)       strcpy(buf, "-");
+  else if (rate > 0)  sprintf(buf, "%.1fus", lead * 1e6 / rate);
+  else                sprintf(buf, "%ld", lead);
+}
+
+static void rfFaultUsage(void)
+{
+  fprintf(stderr,
+    "usage: rfFaultScan [-j threads] [-r rate_hz] [-l] [-f] [-v] dir ...\n"
+    "  -j  analysis threads (default: all processors)\n"
+    "  -r  sample rate, to print leads in us\n"
+    "  -l  binary files are little-endian 16-bit\n"
+    "  -f  binary files are 32-bit floats\n"
+    "  -v  list the files of each fault\n");
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<rfFault>     faults;
+  std::vector<std::thread> pool;
+  std::atomic<size_t>      next(0);
+  struct timespec          t0, t1;
+  double                   rate = 0.0;
+  unsigned                 nthreads = std::thread::hardware_concurrency();
+  int                      opt, nfiles = 0;
+  char                     when[32], collapse[24], lead[24], refl[48];
+  char                     arc[48];
+
+  while ((opt = getopt(argc, argv, "j:r:lfvh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'j': nthreads   = (unsigned)atoi(optarg);     break;
+      case 'r': rate       = atof(optarg);               break;
+      case 'l': rfFaultFmt = RF_FAULT_I16_LE;            break;
+      case 'f': rfFaultFmt = RF_FAULT_F32;               break;
+      case 'v': rfFaultVerbose = 1;                      break;
+      default:  rfFaultUsage();                          return 1;
+    }
+  }
+  if (optind >= argc)
+  {
+    rfFaultUsage();
+    return 1;
+  }
+  if (nthreads < 1) nthreads = 1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int a = optind; a < argc; a++)
+    nfiles += rfFaultScanDir(argv[a], faults);
+  nthreads = std::min(nthreads, (unsigned)std::max((size_t)1, faults.size()));
+  for (unsigned t = 0; t < nthreads; t++)
+    pool.push_back(std::thread(rfFaultWorker, &faults, &next));
+  for (unsigned t = 0; t < nthreads; t++) pool[t].join();
+  std::sort(faults.begin(), faults.end(), rfFaultEarlier);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  printf("%-19s %-3s %5s %9s %6s %12s %16s  %s\n", "time", "num", "files",
+         "collapse", "dphi", "refl/lead", "arc/lead", "class");
+  for (size_t j = 0; j < faults.size(); j++)
+  {
+    const rfFault &f = faults[j];
+
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&f.time));
+    if (f.collapse >= 0) sprintf(collapse, "%ld", f.collapse);
+    else                 strcpy(collapse, "-");
+    rfFaultLead(f.refl_lead, rate, lead);
+    snprintf(refl, sizeof(refl), "%.1f/%s", f.refl, lead);
+    if (f.arc)
+    {
+      rfFaultLead(f.arc_lead, rate, lead);
+      snprintf(arc, sizeof(arc), "0x%04x/%s", f.arc_bits, lead);
+    }
+    else strcpy(arc, "-");
+    printf("%-19s %3d %2d/%-2d %9s %6.1f %12s %16s  %s\n", when, f.num,
+           f.nused, (int)f.files.size(), collapse, f.dphi, refl, arc, f.cls);
+    if (rfFaultVerbose)
+      for (size_t k = 0; k < f.files.size(); k++)
+        printf("    %s%s\n", f.files[k].path.c_str(),
+               (difftime(f.time, f.files[k].mtime) > RF_FAULT_STALE) ?
+               " (stale)" : "");
+  }
+  fprintf(stderr, "%d files, %d faults, %u threads, %.3f sec\n", nfiles,
+          (int)faults.size(), nthreads,
+          (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+  return 0;
+}
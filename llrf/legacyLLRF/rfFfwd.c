@@ -0,0 +1,336 @@
+/*=============================================================================
+
+  Abs:  Tuner Feed-Forward from Beam Current and Forward Power
+
+  Name: rfFfwd.c
+         Public:
+           rfFfwdReport   - print the model of every tuner loop
+           rfFfwdClear    - forget what a model (or all) has learned
+           rfFfwdOpen     - find or register the model of a tuner loop
+           rfFfwdLearn    - add a settled position from a good cycle
+           rfFfwdStep     - position change predicted since the last mark
+           rfFfwdMark     - the tuner is positioned for these inputs
+           rfFfwdGet      - coefficients and residual
+         Private:
+           rfFfwdInit     - create the lock
+           rfFfwdReset    - start a model over
+
+  Rem:  The tuner loop only reacts to the measured load angle, and it
+        needs a measurement after the tuner stops, so it falls behind
+        the detuning of injection and HVPS ramps.  Most of that detuning
+        follows the beam current and the klystron forward power, so
+        each loop learns
+
+          posn = c0 + cb * beam + cp * pwr
+
+        by recursive least squares with forgetting (RF_FFWD_LAMBDA) from
+        the position its good cycles settle on, sm_posn + posn delta.
+        c0 soaks up the slow thermal drift.  The loop feeds forward
+
+          cb * (beam - beam0) + cp * (pwr - pwr0)
+
+        from the inputs it was last positioned for (the mark) once
+        RF_FFWD_MIN_LEARN cycles are learned.  A coefficient that is not
+        RF_FFWD_SIGNIF standard errors from zero is left out, so inputs
+        that have not moved since the model started don't drive the
+        tuner.  The model only forgets on cycles where an input has moved
+        by RF_FFWD_MOVED since the last one, so it still has the ramp
+        coefficients after hours at a fixed current; c0 is instead let
+        drift by RF_FFWD_DRIFT every cycle.
+
+        IOC shell:
+          rfFfwdReport(1)
+          rfFfwdClear("")         forget all models
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfFfwd.h"
+
+#define RF_FFWD_NPAR          3      /* c0, cb, cp                          */
+#define RF_FFWD_LAMBDA        0.995  /* forgetting factor per good cycle    */
+#define RF_FFWD_P0            1.0e4  /* starting covariance (diagonal)      */
+#define RF_FFWD_SIGNIF        2.0    /* # std. errors for a used coeff.     */
+#define RF_FFWD_RESID_AVG     0.05   /* weight of a new squared residual    */
+#define RF_FFWD_MOVED         0.01   /* input change that forgets (fraction) */
+#define RF_FFWD_DRIFT         0.01   /* c0 variance added per cycle (resid2) */
+
+typedef struct
+{
+  char          name[RF_FFWD_NAME_LEN];
+  double        c[RF_FFWD_NPAR];                /* coefficients            */
+  double        p[RF_FFWD_NPAR][RF_FFWD_NPAR];  /* scaled covariance       */
+  double        resid2;      /* average squared prediction error          */
+  double        beam0;       /* inputs at the mark                        */
+  double        pwr0;
+  double        beaml;       /* inputs of the last learned cycle          */
+  double        pwrl;
+  int           marked;
+  unsigned long learned;
+  unsigned long steps;
+} rfFfwdModel;
+
+static rfFfwdModel   rfFfwdTable[RF_FFWD_MAX_MODELS];
+static int           rfFfwdCount = 0;
+static epicsMutexId  rfFfwdLock  = NULL;
+static epicsThreadOnceId rfFfwdOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfFfwdInit(void *arg)
+{
+  rfFfwdLock = epicsMutexMustCreate();
+}
+
+static void rfFfwdReset(rfFfwdModel *pm)
+{
+  int i;
+
+  memset(pm->c, 0, sizeof(pm->c));
+  memset(pm->p, 0, sizeof(pm->p));
+  for (i = 0; i < RF_FFWD_NPAR; i++) pm->p[i][i] = RF_FFWD_P0;
+  pm->resid2  = 0.0;
+  pm->beaml   = 0.0;
+  pm->pwrl    = 0.0;
+  pm->marked  = 0;
+  pm->learned = 0;
+  pm->steps   = 0;
+}
+
+/* Is coefficient i far enough from zero to use */
+static int rfFfwdUsed(const rfFfwdModel *pm, int i)
+{
+  return (pm->c[i] * pm->c[i] >
+          RF_FFWD_SIGNIF * RF_FFWD_SIGNIF * pm->resid2 * pm->p[i][i]);
+}
+
+static rfFfwdModel *rfFfwdGetModel(int id)
+{
+  if ((id < 0) || (id >= rfFfwdCount)) return NULL;
+  return &rfFfwdTable[id];
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfFfwdOpen(const char *stn, const char *name)
+{
+  char full[RF_FFWD_NAME_LEN];
+  int  id;
+
+  sprintf(full, "%.*s:%.*s", 15, stn ? stn : "",
+          RF_FFWD_NAME_LEN - 17, name ? name : "");
+  epicsThreadOnce(&rfFfwdOnce, rfFfwdInit, NULL);
+  epicsMutexMustLock(rfFfwdLock);
+  for (id = 0; id < rfFfwdCount; id++)
+    if (!strcmp(full, rfFfwdTable[id].name)) break;
+  if (id == rfFfwdCount)
+  {
+    if (rfFfwdCount < RF_FFWD_MAX_MODELS)
+    {
+      strcpy(rfFfwdTable[id].name, full);
+      rfFfwdReset(&rfFfwdTable[id]);
+      rfFfwdCount++;
+    }
+    else
+    {
+      epicsPrintf("rfFfwdOpen: No room for %s\n", full);
+      id = RF_FFWD_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfFfwdLock);
+  return id;
+}
+
+/*
+ * One recursive least squares update towards posn at (beam, pwr).  The
+ * tuner is then positioned for these inputs, so they are the new mark.
+ */
+int rfFfwdLearn(int id, double beam, double pwr, double posn)
+{
+  rfFfwdModel *pm = rfFfwdGetModel(id);
+  double       x[RF_FFWD_NPAR], px[RF_FFWD_NPAR], k[RF_FFWD_NPAR];
+  double       err, den, trace, lambda;
+  int          i, j, moved;
+
+  if (!pm) return RF_FFWD_ERROR;
+  x[0] = 1.0;
+  x[1] = beam;
+  x[2] = pwr;
+  epicsMutexMustLock(rfFfwdLock);
+  /*
+   * Forget (lambda < 1) only when an input has moved, and not once P has
+   * grown back to its starting size; otherwise this is plain RLS.
+   */
+  moved = (fabs(beam - pm->beaml) > RF_FFWD_MOVED * fabs(pm->beaml)) ||
+          (fabs(pwr  - pm->pwrl)  > RF_FFWD_MOVED * fabs(pm->pwrl));
+  for (trace = 0.0, i = 0; i < RF_FFWD_NPAR; i++) trace += pm->p[i][i];
+  lambda = (moved && (trace < RF_FFWD_NPAR * RF_FFWD_P0)) ?
+           RF_FFWD_LAMBDA : 1.0;
+  err = posn;
+  for (i = 0; i < RF_FFWD_NPAR; i++)
+  {
+    err  -= pm->c[i] * x[i];
+    px[i] = 0.0;
+    for (j = 0; j < RF_FFWD_NPAR; j++) px[i] += pm->p[i][j] * x[j];
+  }
+  for (den = lambda, i = 0; i < RF_FFWD_NPAR; i++) den += x[i] * px[i];
+  for (i = 0; i < RF_FFWD_NPAR; i++)
+  {
+    k[i]      = px[i] / den;
+    pm->c[i] += k[i] * err;
+  }
+  for (i = 0; i < RF_FFWD_NPAR; i++)
+    for (j = 0; j < RF_FFWD_NPAR; j++)
+      pm->p[i][j] = (pm->p[i][j] - k[i] * px[j]) / lambda;
+  pm->p[0][0] += RF_FFWD_DRIFT;
+  /* The first predictions are from an empty model, so don't count them */
+  if (pm->learned >= RF_FFWD_NPAR)
+    pm->resid2 += RF_FFWD_RESID_AVG * (err * err - pm->resid2);
+  pm->learned++;
+  pm->beaml  = beam;
+  pm->pwrl   = pwr;
+  pm->beam0  = beam;
+  pm->pwr0   = pwr;
+  pm->marked = 1;
+  epicsMutexUnlock(rfFfwdLock);
+  return RF_FFWD_OK;
+}
+
+/*
+ * Returns RF_FFWD_ERROR, with step 0, until the model has learned
+ * enough and has a mark.
+ */
+int rfFfwdStep(int id, double beam, double pwr, float *step)
+{
+  rfFfwdModel *pm = rfFfwdGetModel(id);
+  double       delta = 0.0;
+  int          status = RF_FFWD_ERROR;
+
+  *step = 0.0;
+  if (!pm) return RF_FFWD_ERROR;
+  epicsMutexMustLock(rfFfwdLock);
+  if (pm->marked && (pm->learned >= RF_FFWD_MIN_LEARN))
+  {
+    if (rfFfwdUsed(pm, 1)) delta += pm->c[1] * (beam - pm->beam0);
+    if (rfFfwdUsed(pm, 2)) delta += pm->c[2] * (pwr  - pm->pwr0);
+    *step  = (float)delta;
+    status = RF_FFWD_OK;
+  }
+  epicsMutexUnlock(rfFfwdLock);
+  return status;
+}
+
+int rfFfwdMark(int id, double beam, double pwr)
+{
+  rfFfwdModel *pm = rfFfwdGetModel(id);
+
+  if (!pm) return RF_FFWD_ERROR;
+  epicsMutexMustLock(rfFfwdLock);
+  pm->beam0  = beam;
+  pm->pwr0   = pwr;
+  pm->marked = 1;
+  pm->steps++;
+  epicsMutexUnlock(rfFfwdLock);
+  return RF_FFWD_OK;
+}
+
+/*
+ * Coefficients that are not used are returned as 0.
+ */
+int rfFfwdGet(int id, double *beam_coef, double *pwr_coef, double *resid)
+{
+  rfFfwdModel *pm = rfFfwdGetModel(id);
+
+  if (!pm) return RF_FFWD_ERROR;
+  epicsMutexMustLock(rfFfwdLock);
+  *beam_coef = rfFfwdUsed(pm, 1) ? pm->c[1] : 0.0;
+  *pwr_coef  = rfFfwdUsed(pm, 2) ? pm->c[2] : 0.0;
+  *resid     = sqrt(pm->resid2);
+  epicsMutexUnlock(rfFfwdLock);
+  return RF_FFWD_OK;
+}
+
+int rfFfwdClear(const char *name)
+{
+  int id, n = 0;
+
+  epicsThreadOnce(&rfFfwdOnce, rfFfwdInit, NULL);
+  if (!name) name = "";
+  epicsMutexMustLock(rfFfwdLock);
+  for (id = 0; id < rfFfwdCount; id++)
+  {
+    if (name[0] && strcmp(name, rfFfwdTable[id].name)) continue;
+    rfFfwdReset(&rfFfwdTable[id]);
+    n++;
+  }
+  epicsMutexUnlock(rfFfwdLock);
+  return n ? RF_FFWD_OK : RF_FFWD_ERROR;
+}
+
+void rfFfwdReport(int level)
+{
+  rfFfwdModel *pm;
+  int          id;
+
+  printf("%d feed-forward models\n", rfFfwdCount);
+  epicsThreadOnce(&rfFfwdOnce, rfFfwdInit, NULL);
+  epicsMutexMustLock(rfFfwdLock);
+  for (id = 0; id < rfFfwdCount; id++)
+  {
+    pm = &rfFfwdTable[id];
+    printf("%-24s beam %10.4g%s pwr %10.4g%s resid %8.4g %lu learned %lu"
+           " moves\n", pm->name,
+           pm->c[1], rfFfwdUsed(pm, 1) ? " " : "*",
+           pm->c[2], rfFfwdUsed(pm, 2) ? " " : "*",
+           sqrt(pm->resid2), pm->learned, pm->steps);
+    if (level > 0)
+      printf("%24s c0 %g mark beam %g pwr %g\n", "", pm->c[0], pm->beam0,
+             pm->pwr0);
+  }
+  epicsMutexUnlock(rfFfwdLock);
+  if (rfFfwdCount) printf("* not significant - not fed forward\n");
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfFfwdReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfFfwdReportArgs[] = {&rfFfwdReportArg0};
+static const iocshFuncDef rfFfwdReportDef =
+  {"rfFfwdReport", 1, rfFfwdReportArgs};
+static void rfFfwdReportCall(const iocshArgBuf *args)
+{
+  rfFfwdReport(args[0].ival);
+}
+
+static const iocshArg rfFfwdClearArg0 = {"name", iocshArgString};
+static const iocshArg *rfFfwdClearArgs[] = {&rfFfwdClearArg0};
+static const iocshFuncDef rfFfwdClearDef =
+  {"rfFfwdClear", 1, rfFfwdClearArgs};
+static void rfFfwdClearCall(const iocshArgBuf *args)
+{
+  rfFfwdClear(args[0].sval);
+}
+
+static void rfFfwdRegistrar(void)
+{
+  iocshRegister(&rfFfwdReportDef, rfFfwdReportCall);
+  iocshRegister(&rfFfwdClearDef,  rfFfwdClearCall);
+}
+epicsExportRegistrar(rfFfwdRegistrar);
@@ -0,0 +1,53 @@
+/*=============================================================================
+
+  Abs:  Tuner Feed-Forward from Beam Current and Forward Power
+
+  Name: rfFfwd.h
+
+  Prev: None
+
+  Rem:  One model per tuner loop ("STN:NAME") learns the settled tuner
+        position against beam current and klystron forward power from
+        the loop's own good cycles.  Between measurements the loop asks
+        for the change in position that the inputs predict since the
+        tuner was last positioned.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_FFWD_H
+#define RF_FFWD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_FFWD_OK           0
+#define RF_FFWD_ERROR      (-1)
+
+#define RF_FFWD_MAX_MODELS   32     /* # tuner models per IOC              */
+#define RF_FFWD_NAME_LEN     40     /* model name length incl. station     */
+#define RF_FFWD_MIN_LEARN    20     /* # good cycles before feeding forward */
+
+/* IOC shell */
+void   rfFfwdReport (int level);
+int    rfFfwdClear  (const char *name);
+
+/* Tuner loops */
+int    rfFfwdOpen   (const char *stn, const char *name);
+int    rfFfwdLearn  (int id, double beam, double pwr, double posn);
+int    rfFfwdStep   (int id, double beam, double pwr, float *step);
+int    rfFfwdMark   (int id, double beam, double pwr);
+int    rfFfwdGet    (int id, double *beam_coef, double *pwr_coef,
+                     double *resid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_FFWD_H */
@@ -0,0 +1,360 @@
+/*=============================================================================
+
+  Abs:  Station First-Fault Latch
+
+  Name: rfFirst.c
+         Public:
+           rfFirstReport  - print the latched order of every station
+           rfFirstOpen    - find or create the latch of a station
+           rfFirstSource  - register a fault input
+           rfFirstInput   - a fault input changed
+           rfFirstCount   - # inputs in the latch
+           rfFirstGet     - input, time and delay after the first by rank
+           rfFirstFormat  - first-out, its time and the order as strings
+         Private:
+           rfFirstInit    - create the table lock
+           rfFirstAfter   - seconds between two timestamps
+           rfFirstDelay   - short string for a delay
+
+  Rem:  rf_states only records that a fault tripped the station, to the
+        second.  The station trips on a summary of several latched
+        inputs, so the one that fired first is lost.  The latch keeps,
+        per input, the timestamp of the record that saw it go active,
+        as delivered with the monitor, not the time the sequence got to
+        it.  Order is by those timestamps, so it is as good as the
+        record timestamps (ns with a hardware or event system TSE) and
+        does not depend on monitor delivery order.
+
+        An episode starts on the first input to go active once all are
+        clear, and collects every input that goes active until all are
+        clear again.  An input is latched once per episode, at its first
+        edge.  The last episode stays readable while the station is
+        reset until the next one starts.
+
+        The latch is fed by its own state set (rf_statesFirst) so the
+        trip path in rf_states never waits on it.
+
+        IOC shell:
+          rfFirstReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfFirst.h"
+
+#define RF_FIRST_STN_LEN      16
+
+typedef struct
+{
+  char           name[RF_FIRST_NAME_LEN];
+  int            active;
+  int            latched;    /* went active in this episode               */
+  epicsTimeStamp edge;       /* record time of the first edge             */
+  unsigned long  seq;        /* arrival order, for equal times            */
+} rfFirstSrc;
+
+typedef struct
+{
+  char           stn[RF_FIRST_STN_LEN];
+  epicsMutexId   lock;
+  int            nsrc;
+  int            armed;      /* all clear - next edge starts an episode   */
+  unsigned long  seq;
+  unsigned long  episodes;
+  int            order[RF_FIRST_MAX_SRCS];  /* latched inputs by time     */
+  int            count;
+  rfFirstSrc     src[RF_FIRST_MAX_SRCS];
+} rfFirstStn;
+
+static rfFirstStn   *rfFirstTable[RF_FIRST_MAX_STATIONS];
+static int           rfFirstNstn      = 0;
+static epicsMutexId  rfFirstTableLock = NULL;
+static epicsThreadOnceId rfFirstOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfFirstInit(void *arg)
+{
+  rfFirstTableLock = epicsMutexMustCreate();
+}
+
+static rfFirstStn *rfFirstGetStn(int id)
+{
+  if ((id < 0) || (id >= rfFirstNstn)) return NULL;
+  return rfFirstTable[id];
+}
+
+/* Seconds from t0 to t1, without losing the ns to a large epoch */
+static double rfFirstAfter(const epicsTimeStamp *t0, const epicsTimeStamp *t1)
+{
+  return ((double)t1->secPastEpoch - (double)t0->secPastEpoch) +
+         ((double)t1->nsec - (double)t0->nsec) * 1e-9;
+}
+
+static void rfFirstDelay(double sec, char *buf)
+{
+  if      (sec < 1e-6) sprintf(buf, "%.0fns", sec * 1e9);
+  else if (sec < 1e-3) sprintf(buf, "%.1fus", sec * 1e6);
+  else if (sec < 1.0)  sprintf(buf, "%.1fms", sec * 1e3);
+  else                 sprintf(buf, "%.1fs",  sec);
+}
+
+/* Is input a before input b */
+static int rfFirstBefore(const rfFirstSrc *a, const rfFirstSrc *b)
+{
+  double after = rfFirstAfter(&b->edge, &a->edge);
+
+  if (after != 0.0) return (after < 0.0);
+  return (a->seq < b->seq);
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfFirstOpen(const char *stn)
+{
+  rfFirstStn *ps;
+  int         id;
+
+  if (!stn) stn = "";
+  epicsThreadOnce(&rfFirstOnce, rfFirstInit, NULL);
+  epicsMutexMustLock(rfFirstTableLock);
+  for (id = 0; id < rfFirstNstn; id++)
+    if (!strncmp(stn, rfFirstTable[id]->stn, RF_FIRST_STN_LEN - 1)) break;
+  if (id == rfFirstNstn)
+  {
+    ps = NULL;
+    if (rfFirstNstn < RF_FIRST_MAX_STATIONS)
+      ps = (rfFirstStn *)calloc(1, sizeof(*ps));
+    if (ps)
+    {
+      sprintf(ps->stn, "%.*s", RF_FIRST_STN_LEN - 1, stn);
+      ps->lock  = epicsMutexMustCreate();
+      ps->armed = 1;
+      rfFirstTable[rfFirstNstn++] = ps;
+    }
+    else
+    {
+      epicsPrintf("rfFirstOpen: No room for station %s\n", stn);
+      id = RF_FIRST_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfFirstTableLock);
+  return id;
+}
+
+/*
+ * Returns the input number, the same for the same name.
+ */
+int rfFirstSource(int id, const char *name)
+{
+  rfFirstStn *ps = rfFirstGetStn(id);
+  int         src;
+
+  if (!ps || !name) return RF_FIRST_ERROR;
+  epicsMutexMustLock(ps->lock);
+  for (src = 0; src < ps->nsrc; src++)
+    if (!strncmp(name, ps->src[src].name, RF_FIRST_NAME_LEN - 1)) break;
+  if (src == ps->nsrc)
+  {
+    if (ps->nsrc < RF_FIRST_MAX_SRCS)
+    {
+      sprintf(ps->src[src].name, "%.*s", RF_FIRST_NAME_LEN - 1, name);
+      ps->nsrc++;
+    }
+    else
+    {
+      epicsPrintf("rfFirstSource: No room for %s:%s\n", ps->stn, name);
+      src = RF_FIRST_ERROR;
+    }
+  }
+  epicsMutexUnlock(ps->lock);
+  return src;
+}
+
+/*
+ * ts is the timestamp of the record value that shows the change.
+ */
+int rfFirstInput(int id, int src, int active, const epicsTimeStamp *ts)
+{
+  rfFirstStn *ps = rfFirstGetStn(id);
+  rfFirstSrc *pi;
+  int         i, j, any;
+
+  if (!ps || (src < 0) || (src >= ps->nsrc) || !ts) return RF_FIRST_ERROR;
+  epicsMutexMustLock(ps->lock);
+  pi         = &ps->src[src];
+  pi->active = (active != 0);
+  if (pi->active && ps->armed)
+  {
+    for (i = 0; i < ps->nsrc; i++) ps->src[i].latched = 0;
+    ps->count = 0;
+    ps->armed = 0;
+    ps->episodes++;
+  }
+  if (pi->active && !pi->latched)
+  {
+    pi->latched = 1;
+    pi->edge    = *ts;
+    pi->seq     = ++ps->seq;
+    /* Insert by time - a late monitor can carry an earlier edge */
+    for (i = ps->count; i > 0; i--)
+    {
+      if (!rfFirstBefore(pi, &ps->src[ps->order[i - 1]])) break;
+      ps->order[i] = ps->order[i - 1];
+    }
+    ps->order[i] = src;
+    ps->count++;
+  }
+  for (any = 0, j = 0; j < ps->nsrc; j++) any |= ps->src[j].active;
+  if (!any) ps->armed = 1;
+  epicsMutexUnlock(ps->lock);
+  return RF_FIRST_OK;
+}
+
+int rfFirstCount(int id)
+{
+  rfFirstStn *ps = rfFirstGetStn(id);
+
+  if (!ps) return 0;
+  return ps->count;
+}
+
+/*
+ * Rank 0 is the first-out; after is the delay from it in seconds.  name
+ * must hold RF_FIRST_NAME_LEN characters.
+ */
+int rfFirstGet(int id, int rank, char *name, epicsTimeStamp *ts, double *after)
+{
+  rfFirstStn *ps = rfFirstGetStn(id);
+  rfFirstSrc *pi;
+  int         status = RF_FIRST_ERROR;
+
+  if (!ps) return RF_FIRST_ERROR;
+  epicsMutexMustLock(ps->lock);
+  if ((rank >= 0) && (rank < ps->count))
+  {
+    pi     = &ps->src[ps->order[rank]];
+    strcpy(name, pi->name);
+    *ts    = pi->edge;
+    *after = rfFirstAfter(&ps->src[ps->order[0]].edge, &pi->edge);
+    status = RF_FIRST_OK;
+  }
+  epicsMutexUnlock(ps->lock);
+  return status;
+}
+
+/*
+ * EPICS strings (RF_FIRST_STR_LEN) for the first-out name, its time to
+ * the ns, and the order, e.g. "KARC VACM+1.2us CONT+3.4ms".  Inputs that
+ * don't fit in the order are left off and counted at its end, e.g.
+ * "VACM KARC+1.2ms XARC+350us +3 more", so a full order never looks
+ * complete.  With nothing latched the strings are "NONE" and empty.
+ */
+int rfFirstFormat(int id, char *first, char *time, char *order)
+{
+  rfFirstStn *ps = rfFirstGetStn(id);
+  rfFirstSrc *pi;
+  char        item[2 * RF_FIRST_STR_LEN], delay[RF_FIRST_STR_LEN];
+  char        more[RF_FIRST_STR_LEN];
+  int         i, left;
+
+  strcpy(first, "NONE");
+  time[0]  = '\0';
+  order[0] = '\0';
+  if (!ps) return RF_FIRST_ERROR;
+  epicsMutexMustLock(ps->lock);
+  for (i = 0; i < ps->count; i++)
+  {
+    pi = &ps->src[ps->order[i]];
+    if (i == 0)
+    {
+      strcpy(first, pi->name);
+      epicsTimeToStrftime(time, RF_FIRST_STR_LEN, "%b %d, %Y %H:%M:%S.%09f",
+                          &pi->edge);
+      strcpy(item, pi->name);
+    }
+    else
+    {
+      rfFirstDelay(rfFirstAfter(&ps->src[ps->order[0]].edge, &pi->edge),
+                   delay);
+      sprintf(item, " %s+%s", pi->name, delay);
+    }
+    /* Keep room for the count of the inputs after this one */
+    left = ps->count - i - 1;
+    more[0] = '\0';
+    if (left > 0) sprintf(more, " +%d more", left);
+    if (strlen(order) + strlen(item) + strlen(more) >= RF_FIRST_STR_LEN)
+    {
+      sprintf(order + strlen(order), " +%d more", left + 1);
+      break;
+    }
+    strcat(order, item);
+  }
+  epicsMutexUnlock(ps->lock);
+  return RF_FIRST_OK;
+}
+
+void rfFirstReport(int level)
+{
+  rfFirstStn *ps;
+  rfFirstSrc *pi;
+  char        time[RF_FIRST_STR_LEN], delay[RF_FIRST_STR_LEN];
+  int         i, j;
+
+  printf("%d first-fault latches\n", rfFirstNstn);
+  for (i = 0; i < rfFirstNstn; i++)
+  {
+    ps = rfFirstTable[i];
+    epicsMutexMustLock(ps->lock);
+    printf("%-8s %lu episodes, %s\n", ps->stn, ps->episodes,
+           ps->armed ? "all clear" : "in a fault");
+    for (j = 0; j < ps->count; j++)
+    {
+      pi = &ps->src[ps->order[j]];
+      epicsTimeToStrftime(time, sizeof(time), "%b %d, %Y %H:%M:%S.%09f",
+                          &pi->edge);
+      rfFirstDelay(rfFirstAfter(&ps->src[ps->order[0]].edge, &pi->edge),
+                   delay);
+      printf("  %d %-7s %s +%s\n", j + 1, pi->name, time, delay);
+    }
+    if (level > 0)
+      for (j = 0; j < ps->nsrc; j++)
+        printf("  %-7s %s\n", ps->src[j].name,
+               ps->src[j].active ? "ACTIVE" : "clear");
+    epicsMutexUnlock(ps->lock);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfFirstReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfFirstReportArgs[] = {&rfFirstReportArg0};
+static const iocshFuncDef rfFirstReportDef =
+  {"rfFirstReport", 1, rfFirstReportArgs};
+static void rfFirstReportCall(const iocshArgBuf *args)
+{
+  rfFirstReport(args[0].ival);
+}
+
+static void rfFirstRegistrar(void)
+{
+  iocshRegister(&rfFirstReportDef, rfFirstReportCall);
+}
+epicsExportRegistrar(rfFirstRegistrar);
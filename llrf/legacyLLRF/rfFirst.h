@@ -0,0 +1,53 @@
+/*=============================================================================
+
+  Abs:  Station First-Fault Latch
+
+  Name: rfFirst.h
+
+  Prev: epicsTime.h           (epicsTimeStamp)
+
+  Rem:  Fault inputs of a station are registered by name and report each
+        change with the timestamp of the record that saw it.  The latch
+        orders the inputs that went active since all were last clear;
+        the first of them is the first-out.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_FIRST_H
+#define RF_FIRST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_FIRST_OK           0
+#define RF_FIRST_ERROR      (-1)
+
+#define RF_FIRST_MAX_STATIONS 4     /* # latches per IOC                   */
+#define RF_FIRST_MAX_SRCS     8     /* # fault inputs per station          */
+#define RF_FIRST_NAME_LEN     8     /* input name length                   */
+#define RF_FIRST_STR_LEN      40    /* EPICS string length                 */
+
+/* IOC shell */
+void   rfFirstReport (int level);
+
+/* Latch */
+int    rfFirstOpen   (const char *stn);
+int    rfFirstSource (int id, const char *name);
+int    rfFirstInput  (int id, int src, int active, const epicsTimeStamp *ts);
+int    rfFirstCount  (int id);
+int    rfFirstGet    (int id, int rank, char *name, epicsTimeStamp *ts,
+                      double *after);
+int    rfFirstFormat (int id, char *first, char *time, char *order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_FIRST_H */
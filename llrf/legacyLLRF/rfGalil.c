@@ -0,0 +1,621 @@
+/*=============================================================================
+
+  Abs:  Galil DMC-41x3 Tuner Motion Controller Driver
+
+  Name: rfGalil.c
+         Public:
+           rfGalilConfig   - configure a controller and start its task
+           rfGalilScale    - set engineering units per count of an axis
+           rfGalilReport   - print controller and axis state
+           rfGalilFind     - controller index from name
+           rfGalilAxis     - axis index from axis letter
+           rfGalilMove     - queue an absolute move
+           rfGalilStatus   - latest position, done-moving, alarm of an axis
+           rfGalilWaitDone - wait for motion complete on an axis
+           rfGalilDoneFlag - set a sequence event flag on motion complete
+         Private:
+           rfGalilTask     - controller task (moves, status, events)
+           rfGalilConnect  - open the TCP connection
+           rfGalilCommand  - one command line round trip
+           rfGalilMoves    - send all queued moves in one command line
+           rfGalilPoll     - read all axis positions and switches at once
+
+  Rem:  The cavity tuner loop (rf_tuner_loop.st) normally moves the tuner
+        through a motor record and busy-waits on DMOV, so every move costs
+        a record process and a CA round trip per cavity, and motion
+        complete is only seen at the DMOV poll rate.  This driver talks
+        to the controller directly instead:
+
+        o Moves are queued per axis; only the latest target is kept.
+          Each poll cycle sends every queued move for every idle axis as
+          one "PA a,b,,d;BG ABD" command line.
+        o Status of all axes comes back from one "TPABCD;TSABCD" round
+          trip.  The axes are listed, since a bare TP or TS answers for
+          every axis of the controller, not just the ones configured.
+        o An axis that was commanded and is no longer in motion completes
+          its move: waiters in rfGalilWaitDone() are released and the
+          sequence event flag set by rfGalilDoneFlag() is raised.
+
+        Command replies end with ':' for success and '?' for an error,
+        after which the controller discards the rest of the line; the
+        error text is then read with TC1.
+
+        IOC shell:
+          rfGalilConfig("RRRS", "192.168.42.2", 23, 4, 50)
+          rfGalilScale ("RRRS", "A", 0.0001)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <alarm.h>           /* *_ALARM status and severity defines */
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <osiSock.h>
+#include <iocsh.h>
+#include <seqCom.h>          /* seq_efSet prototype                 */
+#include <epicsExport.h>
+
+#include "rfGalil.h"
+
+#define RF_GALIL_NAME_LEN     40
+#define RF_GALIL_LINE_LEN     256  /* command and reply buffer length      */
+#define RF_GALIL_TIMEOUT      1.0  /* reply timeout in seconds             */
+#define RF_GALIL_RETRY        5.0  /* reconnect delay in seconds           */
+#define RF_GALIL_STALE_POLLS  20   /* # poll periods before status is stale*/
+
+typedef struct
+{
+  char          letter;      /* controller axis letter A..H               */
+  double        scale;       /* engineering units per count               */
+  double        target;      /* latest queued target in counts            */
+  int           pending;     /* target queued but not yet begun           */
+  int           busy;        /* move begun and not yet complete           */
+  int           cmd_error;   /* controller error code of the last move    */
+  double        posn;        /* TP position in counts                     */
+  int           ts;          /* TS switch byte                            */
+  unsigned long moves;       /* # moves begun                             */
+  unsigned long dones;       /* # motion-complete events                  */
+  epicsEventId  done;        /* signalled on motion complete              */
+  void         *ssId;        /* sequence state set to notify, or NULL     */
+  int           ef;          /* sequence event flag to set                */
+} rfGalilAxisBlk;
+
+typedef struct
+{
+  char           name[RF_GALIL_NAME_LEN];
+  char           host[RF_GALIL_NAME_LEN];
+  int            port;
+  int            naxes;
+  double         poll;       /* poll period in seconds                    */
+  SOCKET         sock;
+  epicsMutexId   lock;       /* guards the axis blocks and counters       */
+  epicsEventId   wake;       /* wakes the task early when a move queues   */
+  epicsTimeStamp stamp;      /* time of the last good status poll         */
+  int            valid;      /* stamp holds a good status poll            */
+  unsigned long  polls;
+  unsigned long  errors;
+  rfGalilAxisBlk axis[RF_GALIL_MAX_AXES];
+} rfGalilBlk;
+
+static rfGalilBlk *rfGalilTable[RF_GALIL_MAX_CTRL];
+static int         rfGalilCount = 0;
+
+/*----------------------------------------------------------------------------*/
+
+static rfGalilBlk *rfGalilGet(int id)
+{
+  if ((id < 0) || (id >= rfGalilCount)) return NULL;
+  return rfGalilTable[id];
+}
+
+static void rfGalilDisconnect(rfGalilBlk *pg)
+{
+  if (pg->sock != INVALID_SOCKET)
+  {
+    epicsSocketDestroy(pg->sock);
+    pg->sock = INVALID_SOCKET;
+  }
+  epicsMutexMustLock(pg->lock);
+  pg->valid = 0;
+  epicsMutexUnlock(pg->lock);
+}
+
+static int rfGalilConnect(rfGalilBlk *pg)
+{
+  struct sockaddr_in addr;
+
+  if (aToIPAddr(pg->host, (unsigned short)pg->port, &addr) != 0)
+  {
+    epicsPrintf("rfGalil %s: Bad controller address %s\n",
+                pg->name, pg->host);
+    return RF_GALIL_ERROR;
+  }
+  pg->sock = epicsSocketCreate(AF_INET, SOCK_STREAM, 0);
+  if (pg->sock == INVALID_SOCKET) return RF_GALIL_ERROR;
+  if (connect(pg->sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+  {
+    epicsSocketDestroy(pg->sock);
+    pg->sock = INVALID_SOCKET;
+    return RF_GALIL_ERROR;
+  }
+  epicsPrintf("rfGalil %s: Connected to %s:%d\n",
+              pg->name, pg->host, pg->port);
+  return RF_GALIL_OK;
+}
+
+/*
+ * Send one command line and read the replies to its ';'-separated
+ * commands.  Returns the number of successful replies (':'), or
+ * RF_GALIL_ERROR on a socket error or timeout.  *failed is set when
+ * the controller answered '?'; the rest of the line is then discarded
+ * by the controller and no more replies are expected.
+ */
+static int rfGalilCommand(rfGalilBlk *pg, const char *cmd, int ncmds,
+                          char *reply, int size, int *failed)
+{
+  char           line[RF_GALIL_LINE_LEN];
+  int            len, used = 0, ok = 0, i, n;
+  fd_set         fds;
+  struct timeval tmo;
+
+  *failed  = 0;
+  reply[0] = '\0';
+  len = sprintf(line, "%.*s\r", (int)sizeof(line) - 2, cmd);
+  if (send(pg->sock, line, len, 0) != len) return RF_GALIL_ERROR;
+
+  while ((ok < ncmds) && !*failed)
+  {
+    FD_ZERO(&fds);
+    FD_SET(pg->sock, &fds);
+    tmo.tv_sec  = (long)RF_GALIL_TIMEOUT;
+    tmo.tv_usec = (long)((RF_GALIL_TIMEOUT - tmo.tv_sec) * 1e6);
+    if (select(pg->sock + 1, &fds, NULL, NULL, &tmo) <= 0)
+      return RF_GALIL_ERROR;
+    n = recv(pg->sock, line, sizeof(line), 0);
+    if (n <= 0) return RF_GALIL_ERROR;
+    for (i = 0; i < n; i++)
+    {
+      if      (line[i] == ':') ok++;
+      else if (line[i] == '?') *failed = 1;
+      else if (used < size - 1) reply[used++] = line[i];
+    }
+  }
+  reply[used] = '\0';
+  return ok;
+}
+
+/*
+ * Parse up to max comma/space separated numbers from a TP or TS reply.
+ */
+static int rfGalilParse(const char *text, double *value, int max)
+{
+  char *end;
+  int   n = 0;
+
+  while ((n < max) && *text)
+  {
+    while (*text && (isspace((int)*text) || (*text == ','))) text++;
+    if (!*text) break;
+    value[n] = strtod(text, &end);
+    if (end == text) break;
+    text = end;
+    n++;
+  }
+  return n;
+}
+
+static void rfGalilNotify(rfGalilAxisBlk *pa)
+{
+  pa->busy = 0;
+  pa->dones++;
+  epicsEventSignal(pa->done);
+  if (pa->ssId) seq_efSet((SS_ID)pa->ssId, pa->ef);
+}
+
+/*
+ * Begin every queued move on every idle axis in one command line.
+ * A move queued on an axis still in motion waits for the next cycle.
+ */
+static int rfGalilMoves(rfGalilBlk *pg)
+{
+  char   cmd[RF_GALIL_LINE_LEN], reply[RF_GALIL_LINE_LEN];
+  char   posns[RF_GALIL_LINE_LEN], axes[RF_GALIL_MAX_AXES + 1];
+  int    mask = 0, last = -1, i, nax = 0, status, failed;
+  double code;
+
+  posns[0] = '\0';
+  epicsMutexMustLock(pg->lock);
+  for (i = 0; i < pg->naxes; i++)
+  {
+    rfGalilAxisBlk *pa = &pg->axis[i];
+    if (pa->pending && !(pa->ts & RF_GALIL_TS_MOVING)) last = i;
+  }
+  for (i = 0; i <= last; i++)
+  {
+    rfGalilAxisBlk *pa = &pg->axis[i];
+    if (i > 0) strcat(posns, ",");
+    if (pa->pending && !(pa->ts & RF_GALIL_TS_MOVING))
+    {
+      sprintf(posns + strlen(posns), "%.0f", pa->target);
+      axes[nax++]  = pa->letter;
+      mask        |= 1 << i;
+      pa->pending  = 0;
+      pa->busy     = 1;
+      pa->moves++;
+    }
+  }
+  epicsMutexUnlock(pg->lock);
+  if (!mask) return RF_GALIL_OK;
+
+  axes[nax] = '\0';
+  sprintf(cmd, "PA %s;BG %s", posns, axes);
+  status = rfGalilCommand(pg, cmd, 2, reply, sizeof(reply), &failed);
+  if (status == RF_GALIL_ERROR)
+  {
+    /*
+     * The line may never have reached the controller.  Queue the moves
+     * again, to the latest target of each axis, so they are sent after
+     * the reconnect instead of completing unsent in the next poll.
+     * Sending an absolute move twice does no harm.
+     */
+    epicsMutexMustLock(pg->lock);
+    for (i = 0; i < pg->naxes; i++)
+    {
+      if (mask & (1 << i))
+      {
+        pg->axis[i].pending = 1;
+        pg->axis[i].busy    = 0;
+        pg->axis[i].moves--;
+      }
+    }
+    epicsMutexUnlock(pg->lock);
+    return RF_GALIL_ERROR;
+  }
+  if (!failed) return RF_GALIL_OK;
+  /*
+   * The controller rejected the line, most likely a limit switch or a
+   * motor that is off.  Log the reason and complete the moves so that
+   * nobody waits on them; the switch status shows up in the next poll.
+   */
+  code = 0;
+  if (rfGalilCommand(pg, "TC1", 1, reply, sizeof(reply), &failed) > 0)
+    rfGalilParse(reply, &code, 1);
+  epicsPrintf("rfGalil %s: %s rejected -%s\n", pg->name, cmd, reply);
+  epicsMutexMustLock(pg->lock);
+  pg->errors++;
+  for (i = 0; i < pg->naxes; i++)
+  {
+    if (mask & (1 << i))
+    {
+      pg->axis[i].cmd_error = (int)code;
+      rfGalilNotify(&pg->axis[i]);
+    }
+  }
+  epicsMutexUnlock(pg->lock);
+  return RF_GALIL_OK;
+}
+
+/*
+ * Read the positions and switches of all axes in one round trip and
+ * complete the moves of every commanded axis that has stopped.
+ */
+static int rfGalilPoll(rfGalilBlk *pg)
+{
+  char   cmd[RF_GALIL_LINE_LEN], reply[RF_GALIL_LINE_LEN];
+  char   axes[RF_GALIL_MAX_AXES + 1];
+  double value[2 * RF_GALIL_MAX_AXES];
+  int    i, failed;
+
+  for (i = 0; i < pg->naxes; i++) axes[i] = pg->axis[i].letter;
+  axes[pg->naxes] = '\0';
+  sprintf(cmd, "TP%s;TS%s", axes, axes);
+  if (rfGalilCommand(pg, cmd, 2, reply, sizeof(reply), &failed) != 2)
+    return RF_GALIL_ERROR;
+  if (rfGalilParse(reply, value, 2 * pg->naxes) != 2 * pg->naxes)
+    return RF_GALIL_ERROR;
+
+  epicsMutexMustLock(pg->lock);
+  for (i = 0; i < pg->naxes; i++)
+  {
+    rfGalilAxisBlk *pa = &pg->axis[i];
+    pa->posn = value[i];
+    pa->ts   = (int)value[pg->naxes + i];
+    if (pa->busy && !pa->pending && !(pa->ts & RF_GALIL_TS_MOVING))
+    {
+      pa->cmd_error = 0;
+      rfGalilNotify(pa);
+    }
+  }
+  epicsTimeGetCurrent(&pg->stamp);
+  pg->valid = 1;
+  pg->polls++;
+  epicsMutexUnlock(pg->lock);
+  return RF_GALIL_OK;
+}
+
+static void rfGalilTask(void *arg)
+{
+  rfGalilBlk *pg = (rfGalilBlk *)arg;
+
+  for (;;)
+  {
+    if (pg->sock == INVALID_SOCKET)
+    {
+      if (rfGalilConnect(pg) != RF_GALIL_OK)
+      {
+        epicsThreadSleep(RF_GALIL_RETRY);
+        continue;
+      }
+    }
+    if ((rfGalilMoves(pg) != RF_GALIL_OK) || (rfGalilPoll(pg) != RF_GALIL_OK))
+    {
+      epicsPrintf("rfGalil %s: Lost connection to %s:%d\n",
+                  pg->name, pg->host, pg->port);
+      epicsMutexMustLock(pg->lock);
+      pg->errors++;
+      epicsMutexUnlock(pg->lock);
+      rfGalilDisconnect(pg);
+      continue;
+    }
+    epicsEventWaitWithTimeout(pg->wake, pg->poll);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfGalilConfig(const char *name, const char *host, int port,
+                  int naxes, int poll_ms)
+{
+  rfGalilBlk *pg;
+  int         i;
+
+  if (!name || !host || (rfGalilFind(name) >= 0) ||
+      (rfGalilCount >= RF_GALIL_MAX_CTRL))
+  {
+    epicsPrintf("rfGalilConfig: Bad or duplicate controller %s\n",
+                name ? name : "");
+    return RF_GALIL_ERROR;
+  }
+  if (port    <= 0) port    = RF_GALIL_PORT;
+  if (poll_ms <= 0) poll_ms = RF_GALIL_POLL_MS;
+  if ((naxes <= 0) || (naxes > RF_GALIL_MAX_AXES)) naxes = 4;
+  if (osiSockAttach() == 0) return RF_GALIL_ERROR;
+
+  pg = (rfGalilBlk *)calloc(1, sizeof(*pg));
+  if (!pg) return RF_GALIL_ERROR;
+  strncpy(pg->name, name, sizeof(pg->name) - 1);
+  strncpy(pg->host, host, sizeof(pg->host) - 1);
+  pg->port  = port;
+  pg->naxes = naxes;
+  pg->poll  = poll_ms / 1000.0;
+  pg->sock  = INVALID_SOCKET;
+  pg->lock  = epicsMutexMustCreate();
+  pg->wake  = epicsEventMustCreate(epicsEventEmpty);
+  for (i = 0; i < naxes; i++)
+  {
+    pg->axis[i].letter = (char)('A' + i);
+    pg->axis[i].scale  = 1.0;
+    pg->axis[i].done   = epicsEventMustCreate(epicsEventEmpty);
+  }
+  rfGalilTable[rfGalilCount++] = pg;
+  epicsThreadCreate(pg->name, epicsThreadPriorityMedium,
+                    epicsThreadGetStackSize(epicsThreadStackMedium),
+                    rfGalilTask, pg);
+  return RF_GALIL_OK;
+}
+
+int rfGalilScale(const char *name, const char *axis, double scale)
+{
+  int id = rfGalilFind(name);
+  int ax = rfGalilAxis(id, axis);
+
+  if ((ax < 0) || (scale == 0.0))
+  {
+    epicsPrintf("rfGalilScale: Bad controller, axis or scale\n");
+    return RF_GALIL_ERROR;
+  }
+  rfGalilTable[id]->axis[ax].scale = scale;
+  return RF_GALIL_OK;
+}
+
+void rfGalilReport(const char *name, int level)
+{
+  int i, j;
+
+  for (i = 0; i < rfGalilCount; i++)
+  {
+    rfGalilBlk *pg = rfGalilTable[i];
+    if (name && *name && strcmp(name, pg->name)) continue;
+    printf("%s: %s:%d %s, polls %lu, errors %lu\n", pg->name, pg->host,
+           pg->port, (pg->sock == INVALID_SOCKET) ? "disconnected" :
+           "connected", pg->polls, pg->errors);
+    if (level < 1) continue;
+    for (j = 0; j < pg->naxes; j++)
+    {
+      rfGalilAxisBlk *pa = &pg->axis[j];
+      printf("  %c: posn %.0f ts 0x%02x target %.0f%s%s moves %lu "
+             "dones %lu error %d\n", pa->letter, pa->posn, pa->ts,
+             pa->target, pa->pending ? " pending" : "",
+             pa->busy ? " busy" : "", pa->moves, pa->dones, pa->cmd_error);
+    }
+  }
+}
+
+int rfGalilFind(const char *name)
+{
+  int i;
+
+  if (!name) return RF_GALIL_ERROR;
+  for (i = 0; i < rfGalilCount; i++)
+    if (!strcmp(name, rfGalilTable[i]->name)) return i;
+  return RF_GALIL_ERROR;
+}
+
+int rfGalilAxis(int id, const char *axis)
+{
+  rfGalilBlk *pg = rfGalilGet(id);
+  int         ax;
+
+  if (!pg || !axis || !*axis) return RF_GALIL_ERROR;
+  ax = toupper((int)axis[0]) - 'A';
+  if ((ax < 0) || (ax >= pg->naxes)) return RF_GALIL_ERROR;
+  return ax;
+}
+
+/*
+ * Queue an absolute move.  A newer target replaces one that has not
+ * been begun yet, so a slow axis never builds up a backlog.
+ */
+int rfGalilMove(int id, int axis, double posn)
+{
+  rfGalilBlk *pg = rfGalilGet(id);
+
+  if (!pg || (axis < 0) || (axis >= pg->naxes)) return RF_GALIL_ERROR;
+  epicsMutexMustLock(pg->lock);
+  pg->axis[axis].target  = posn / pg->axis[axis].scale;
+  pg->axis[axis].pending = 1;
+  epicsMutexUnlock(pg->lock);
+  epicsEventTryWait(pg->axis[axis].done);
+  epicsEventSignal(pg->wake);
+  return RF_GALIL_OK;
+}
+
+/*
+ * Latest status of an axis in motor record terms: readback position,
+ * done-moving, and an alarm status and severity that
+ * TUNER_LOOP_POSN_STATUS can interpret.
+ */
+int rfGalilStatus(int id, int axis, float *posn, int *dmov,
+                  int *stat, int *sevr)
+{
+  rfGalilBlk     *pg = rfGalilGet(id);
+  rfGalilAxisBlk *pa;
+  epicsTimeStamp  now;
+  int             status = RF_GALIL_OK;
+
+  if (!pg || (axis < 0) || (axis >= pg->naxes)) return RF_GALIL_ERROR;
+  pa = &pg->axis[axis];
+  epicsTimeGetCurrent(&now);
+  epicsMutexMustLock(pg->lock);
+  *posn = (float)(pa->posn * pa->scale);
+  *dmov = !(pa->pending || pa->busy || (pa->ts & RF_GALIL_TS_MOVING));
+  if (!pg->valid ||
+      (epicsTimeDiffInSeconds(&now, &pg->stamp) >
+       RF_GALIL_STALE_POLLS * pg->poll))
+  {
+    *stat  = COMM_ALARM;
+    *sevr  = INVALID_ALARM;
+    status = RF_GALIL_ERROR;
+  }
+  else if (pa->ts & RF_GALIL_TS_MOTOR_OFF)
+  {
+    *stat = STATE_ALARM;
+    *sevr = INVALID_ALARM;
+  }
+  else if (!(pa->ts & RF_GALIL_TS_FLS_OFF) || !(pa->ts & RF_GALIL_TS_RLS_OFF))
+  {
+    *stat = HW_LIMIT_ALARM;
+    *sevr = MAJOR_ALARM;
+  }
+  else if ((pa->ts & RF_GALIL_TS_ERR_LIMIT) || pa->cmd_error)
+  {
+    *stat = STATE_ALARM;
+    *sevr = MINOR_ALARM;
+  }
+  else
+  {
+    *stat = NO_ALARM;
+    *sevr = NO_ALARM;
+  }
+  epicsMutexUnlock(pg->lock);
+  return status;
+}
+
+int rfGalilWaitDone(int id, int axis, double timeout)
+{
+  rfGalilBlk *pg = rfGalilGet(id);
+  int         dmov, stat, sevr;
+  float       posn;
+
+  if (!pg || (axis < 0) || (axis >= pg->naxes)) return RF_GALIL_ERROR;
+  rfGalilStatus(id, axis, &posn, &dmov, &stat, &sevr);
+  if (dmov) return RF_GALIL_OK;
+  if (epicsEventWaitWithTimeout(pg->axis[axis].done, timeout) !=
+      epicsEventWaitOK) return RF_GALIL_ERROR;
+  return RF_GALIL_OK;
+}
+
+int rfGalilDoneFlag(int id, int axis, void *ssId, int ef)
+{
+  rfGalilBlk *pg = rfGalilGet(id);
+
+  if (!pg || (axis < 0) || (axis >= pg->naxes)) return RF_GALIL_ERROR;
+  epicsMutexMustLock(pg->lock);
+  pg->axis[axis].ssId = ssId;
+  pg->axis[axis].ef   = ef;
+  epicsMutexUnlock(pg->lock);
+  return RF_GALIL_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfGalilConfigArg0 = {"name",    iocshArgString};
+static const iocshArg rfGalilConfigArg1 = {"host",    iocshArgString};
+static const iocshArg rfGalilConfigArg2 = {"port",    iocshArgInt};
+static const iocshArg rfGalilConfigArg3 = {"naxes",   iocshArgInt};
+static const iocshArg rfGalilConfigArg4 = {"poll_ms", iocshArgInt};
+static const iocshArg *rfGalilConfigArgs[] =
+  {&rfGalilConfigArg0, &rfGalilConfigArg1, &rfGalilConfigArg2,
+   &rfGalilConfigArg3, &rfGalilConfigArg4};
+static const iocshFuncDef rfGalilConfigDef =
+  {"rfGalilConfig", 5, rfGalilConfigArgs};
+static void rfGalilConfigCall(const iocshArgBuf *args)
+{
+  rfGalilConfig(args[0].sval, args[1].sval, args[2].ival,
+                args[3].ival, args[4].ival);
+}
+
+static const iocshArg rfGalilScaleArg0 = {"name",  iocshArgString};
+static const iocshArg rfGalilScaleArg1 = {"axis",  iocshArgString};
+static const iocshArg rfGalilScaleArg2 = {"scale", iocshArgDouble};
+static const iocshArg *rfGalilScaleArgs[] =
+  {&rfGalilScaleArg0, &rfGalilScaleArg1, &rfGalilScaleArg2};
+static const iocshFuncDef rfGalilScaleDef =
+  {"rfGalilScale", 3, rfGalilScaleArgs};
+static void rfGalilScaleCall(const iocshArgBuf *args)
+{
+  rfGalilScale(args[0].sval, args[1].sval, args[2].dval);
+}
+
+static const iocshArg rfGalilReportArg0 = {"name",  iocshArgString};
+static const iocshArg rfGalilReportArg1 = {"level", iocshArgInt};
+static const iocshArg *rfGalilReportArgs[] =
+  {&rfGalilReportArg0, &rfGalilReportArg1};
+static const iocshFuncDef rfGalilReportDef =
+  {"rfGalilReport", 2, rfGalilReportArgs};
+static void rfGalilReportCall(const iocshArgBuf *args)
+{
+  rfGalilReport(args[0].sval, args[1].ival);
+}
+
+static void rfGalilRegistrar(void)
+{
+  iocshRegister(&rfGalilConfigDef, rfGalilConfigCall);
+  iocshRegister(&rfGalilScaleDef,  rfGalilScaleCall);
+  iocshRegister(&rfGalilReportDef, rfGalilReportCall);
+}
+epicsExportRegistrar(rfGalilRegistrar);
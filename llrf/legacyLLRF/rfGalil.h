@@ -0,0 +1,66 @@
+/*=============================================================================
+
+  Abs:  Galil DMC-41x3 Tuner Motion Controller Interface
+
+  Name: rfGalil.h
+
+  Prev: seqCom.h              (SS_ID typedef, only for rfGalilDoneFlag)
+
+  Rem:  One controller drives the tuners of all cavities of a station,
+        one axis per cavity.  A single driver task per controller owns
+        the TCP connection and, once per poll period, does one round
+        trip for all queued absolute moves and one for the status of
+        all axes.  Positions are in engineering units (counts * scale).
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_GALIL_H
+#define RF_GALIL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_GALIL_OK           0
+#define RF_GALIL_ERROR      (-1)
+
+#define RF_GALIL_MAX_CTRL     4    /* # controllers per IOC                */
+#define RF_GALIL_MAX_AXES     8    /* # axes per controller (DMC-41x3 = 4) */
+#define RF_GALIL_PORT         23   /* default controller TCP port          */
+#define RF_GALIL_POLL_MS      50   /* default status poll period in msec   */
+
+/* Bits of the TS (tell switches) status byte of each axis */
+#define RF_GALIL_TS_LATCHED   0x01 /* position latched                     */
+#define RF_GALIL_TS_HOME      0x02 /* home switch                          */
+#define RF_GALIL_TS_RLS_OFF   0x04 /* reverse limit switch inactive        */
+#define RF_GALIL_TS_FLS_OFF   0x08 /* forward limit switch inactive        */
+#define RF_GALIL_TS_MOTOR_OFF 0x20 /* motor off                            */
+#define RF_GALIL_TS_ERR_LIMIT 0x40 /* position error exceeds error limit   */
+#define RF_GALIL_TS_MOVING    0x80 /* axis in motion                       */
+
+/* IOC shell configuration */
+int  rfGalilConfig (const char *name, const char *host, int port,
+                    int naxes, int poll_ms);
+int  rfGalilScale  (const char *name, const char *axis, double scale);
+void rfGalilReport (const char *name, int level);
+
+/* Sequence interface - controllers and axes are referenced by index */
+int  rfGalilFind    (const char *name);
+int  rfGalilAxis    (int id, const char *axis);
+int  rfGalilMove    (int id, int axis, double posn);
+int  rfGalilStatus  (int id, int axis, float *posn, int *dmov,
+                     int *stat, int *sevr);
+int  rfGalilWaitDone(int id, int axis, double timeout);
+int  rfGalilDoneFlag(int id, int axis, void *ssId, int ef);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_GALIL_H */
@@ -0,0 +1,647 @@
+/*=============================================================================
+
+  Abs:  Compressed In-IOC Time-Series History
+
+  Name: rfHist.c
+         Public:
+           rfHistConfig   - set storage per series for series opened later
+           rfHistReport   - print series sizes and compression
+           rfHistQuery    - print stats and a decimated view of a series
+           rfHistOpen     - find or create a series
+           rfHistFind     - find a series
+           rfHistAdd      - record a value at the current time
+           rfHistAddAt    - record a value at a given time
+           rfHistNow      - current time in seconds past the EPICS epoch
+           rfHistStats    - min/max/mean/count over a time range
+           rfHistDecimate - min/max/mean waveforms over a time range
+         Private:
+           rfHistInit     - create the table lock
+           rfHistPut      - append bits to a block
+           rfHistGet      - read bits from a block
+           rfHistEncode   - append one sample to a block
+           rfHistNext     - decode the next sample of a block
+
+  Rem:  The database history records behind {STN}:HVPS:VOLT:LOOP and
+        {STN}:STN:VOLT:HIST are fixed length, so nothing older than
+        the record length can be seen without the archiver.  This
+        module keeps loop inputs, outputs and statuses in the IOC at
+        loop rate for as long as their storage lasts.
+
+        Float loop values take 14 to 45 bits a sample, the noisier the
+        more, so at 2 Hz a 512 KB series holds 12 to 37 hours of them.
+        Statuses that seldom change take under 10 bits, 2.5 days.
+        rfHistReport(1) shows the bits per sample and the hours held of
+        every series; rfHistConfig sets the storage for more.
+
+        Each series is a ring of fixed size blocks.  Samples in a block
+        are compressed as in Facebook's Gorilla store:
+
+        o Time: milliseconds from the block start, as the difference of
+          successive deltas.  At a steady 0.5 s cycle that is 1 bit.
+            0                      dod == 0
+            10   + 7 bits          -63   .. 64
+            110  + 9 bits          -255  .. 256
+            1110 + 12 bits         -2047 .. 2048
+            1111 + 32 bits         otherwise
+        o Value: the double XOR the previous one.  An unchanged value is
+          1 bit; a change that fits the previous leading/trailing zero
+          window is 2 bits plus the window.
+            0                      same value
+            10   + window bits     fits previous window
+            11   + 5 bits leading zeros + 6 bits length-1 + bits
+
+        Each block header also keeps the time span, count, min, max and
+        sum of its samples.  A range query uses the headers of blocks
+        fully inside the range and decodes only the blocks at its ends,
+        and a decimated waveform only decodes blocks that straddle a
+        bucket boundary.
+
+        When the ring is full the oldest block is reused.
+
+        IOC shell:
+          rfHistConfig(1024)             KB per series, before iocInit
+          rfHistReport(1)
+          rfHistQuery("RRRS:HVPS:VOLT:LOOP", 86400, 24)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfHist.h"
+
+#define RF_HIST_BLOCK_DATA   1024   /* data bytes per block                */
+#define RF_HIST_SAMPLE_BITS  113    /* max bits of one encoded sample      */
+#define RF_HIST_BLOCK_SPAN   1.0e6  /* max seconds in one block (32 bit ms)*/
+#define RF_HIST_QUERY_NPTS   100    /* max buckets printed by rfHistQuery  */
+
+typedef unsigned long long rfHistWord;
+
+typedef struct
+{
+  double        t0;          /* time of the first sample                  */
+  double        t1;          /* time of the last sample                   */
+  unsigned long count;       /* # samples                                 */
+  double        min;
+  double        max;
+  double        sum;
+  long          prev_ms;     /* encoder: last time offset in ms           */
+  long          prev_delta;  /* encoder: last time delta in ms            */
+  rfHistWord    prev_bits;   /* encoder: last value                       */
+  int           prev_lead;   /* encoder: leading zeros of the last window */
+  int           prev_sig;    /* encoder: width of the last window         */
+  unsigned long nbits;       /* # data bits used                          */
+  unsigned char data[RF_HIST_BLOCK_DATA];
+} rfHistBlock;
+
+typedef struct
+{
+  const rfHistBlock *pb;
+  unsigned long      pos;    /* bit position                              */
+  unsigned long      index;  /* # samples decoded                         */
+  long               ms;
+  long               delta;
+  rfHistWord         bits;
+  int                lead;
+  int                sig;
+} rfHistCursor;
+
+typedef struct
+{
+  char          name[RF_HIST_NAME_LEN];
+  epicsMutexId  lock;
+  rfHistBlock  *block;
+  int           nblocks;
+  int           head;        /* index of the newest block                 */
+  int           used;        /* # blocks holding samples                  */
+  unsigned long total;       /* # samples ever recorded                   */
+} rfHistSeries;
+
+static rfHistSeries *rfHistTable[RF_HIST_MAX_SERIES];
+static int           rfHistCount  = 0;
+static int           rfHistKbytes = RF_HIST_KBYTES;
+static epicsMutexId  rfHistTableLock = NULL;
+static epicsThreadOnceId rfHistOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfHistInit(void *arg)
+{
+  rfHistTableLock = epicsMutexMustCreate();
+}
+
+static void rfHistPut(rfHistBlock *pb, rfHistWord value, int nbits)
+{
+  int i;
+
+  for (i = nbits - 1; i >= 0; i--, pb->nbits++)
+  {
+    if ((value >> i) & 1)
+      pb->data[pb->nbits >> 3] |=  (unsigned char)(0x80 >> (pb->nbits & 7));
+    else
+      pb->data[pb->nbits >> 3] &= (unsigned char)~(0x80 >> (pb->nbits & 7));
+  }
+}
+
+static rfHistWord rfHistGet(rfHistCursor *pc, int nbits)
+{
+  rfHistWord value = 0;
+
+  for (; nbits > 0; nbits--, pc->pos++)
+    value = (value << 1) |
+            ((pc->pb->data[pc->pos >> 3] >> (7 - (pc->pos & 7))) & 1);
+  return value;
+}
+
+static rfHistWord rfHistBits(double value)
+{
+  rfHistWord bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static double rfHistValue(rfHistWord bits)
+{
+  double value;
+
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static void rfHistStart(rfHistBlock *pb, double time, double value)
+{
+  memset(pb, 0, sizeof(*pb) - sizeof(pb->data));
+  pb->t0 = pb->t1 = time;
+  pb->min = pb->max = pb->sum = value;
+  pb->count     = 1;
+  pb->prev_bits = rfHistBits(value);
+  rfHistPut(pb, pb->prev_bits, 64);
+}
+
+/*
+ * Append a sample after the first one of a block.  The caller has made
+ * sure there is room for RF_HIST_SAMPLE_BITS.
+ */
+static void rfHistEncode(rfHistBlock *pb, double time, double value)
+{
+  long       ms, delta, dod;
+  rfHistWord bits, xor;
+  int        lead, trail, sig;
+
+  ms    = (long)floor((time - pb->t0) * 1000.0 + 0.5);
+  if (ms < pb->prev_ms) ms = pb->prev_ms;
+  delta = ms - pb->prev_ms;
+  dod   = delta - pb->prev_delta;
+  if (dod == 0)
+    rfHistPut(pb, 0, 1);
+  else if ((dod >= -63) && (dod <= 64))
+  {
+    rfHistPut(pb, 2, 2);
+    rfHistPut(pb, (rfHistWord)(dod + 63), 7);
+  }
+  else if ((dod >= -255) && (dod <= 256))
+  {
+    rfHistPut(pb, 6, 3);
+    rfHistPut(pb, (rfHistWord)(dod + 255), 9);
+  }
+  else if ((dod >= -2047) && (dod <= 2048))
+  {
+    rfHistPut(pb, 14, 4);
+    rfHistPut(pb, (rfHistWord)(dod + 2047), 12);
+  }
+  else
+  {
+    rfHistPut(pb, 15, 4);
+    rfHistPut(pb, (rfHistWord)(unsigned long)dod & 0xffffffffUL, 32);
+  }
+  pb->prev_ms    = ms;
+  pb->prev_delta = delta;
+
+  bits = rfHistBits(value);
+  xor  = bits ^ pb->prev_bits;
+  if (xor == 0)
+    rfHistPut(pb, 0, 1);
+  else
+  {
+    for (lead = 0;  !((xor >> (63 - lead)) & 1); lead++);
+    for (trail = 0; !((xor >> trail) & 1);       trail++);
+    if (lead > 31) lead = 31;
+    if (pb->prev_sig && (lead >= pb->prev_lead) &&
+        (trail >= 64 - pb->prev_lead - pb->prev_sig))
+    {
+      rfHistPut(pb, 2, 2);
+      rfHistPut(pb, xor >> (64 - pb->prev_lead - pb->prev_sig),
+                pb->prev_sig);
+    }
+    else
+    {
+      sig = 64 - lead - trail;
+      rfHistPut(pb, 3, 2);
+      rfHistPut(pb, (rfHistWord)lead, 5);
+      rfHistPut(pb, (rfHistWord)(sig - 1), 6);
+      rfHistPut(pb, xor >> trail, sig);
+      pb->prev_lead = lead;
+      pb->prev_sig  = sig;
+    }
+  }
+  pb->prev_bits = bits;
+
+  pb->t1 = time;
+  pb->count++;
+  pb->sum += value;
+  if (value < pb->min) pb->min = value;
+  if (value > pb->max) pb->max = value;
+}
+
+static void rfHistCursorInit(rfHistCursor *pc, const rfHistBlock *pb)
+{
+  memset(pc, 0, sizeof(*pc));
+  pc->pb = pb;
+}
+
+/*
+ * Decode the next sample of a block.  Returns 0 at the end of the block.
+ */
+static int rfHistNext(rfHistCursor *pc, double *time, double *value)
+{
+  rfHistWord xor;
+  long       dod;
+  int        lead;
+
+  if (pc->index >= pc->pb->count) return 0;
+  if (pc->index == 0)
+  {
+    pc->bits = rfHistGet(pc, 64);
+  }
+  else
+  {
+    if      (!rfHistGet(pc, 1)) dod = 0;
+    else if (!rfHistGet(pc, 1)) dod = (long)rfHistGet(pc, 7)  - 63;
+    else if (!rfHistGet(pc, 1)) dod = (long)rfHistGet(pc, 9)  - 255;
+    else if (!rfHistGet(pc, 1)) dod = (long)rfHistGet(pc, 12) - 2047;
+    else
+    {
+      dod = (long)rfHistGet(pc, 32);
+      if (dod & 0x80000000L) dod |= ~0xffffffffL;
+    }
+    pc->delta += dod;
+    pc->ms    += pc->delta;
+
+    if (rfHistGet(pc, 1))
+    {
+      if (rfHistGet(pc, 1))
+      {
+        lead     = (int)rfHistGet(pc, 5);
+        pc->sig  = (int)rfHistGet(pc, 6) + 1;
+        pc->lead = lead;
+      }
+      xor = rfHistGet(pc, pc->sig) << (64 - pc->lead - pc->sig);
+      pc->bits ^= xor;
+    }
+  }
+  pc->index++;
+  *time  = pc->pb->t0 + pc->ms / 1000.0;
+  *value = rfHistValue(pc->bits);
+  return 1;
+}
+
+static rfHistSeries *rfHistGetSeries(int id)
+{
+  if ((id < 0) || (id >= rfHistCount)) return NULL;
+  return rfHistTable[id];
+}
+
+/* Block n, counted from the oldest one held */
+static rfHistBlock *rfHistBlockAt(rfHistSeries *ps, int n)
+{
+  return &ps->block[(ps->head - ps->used + 1 + n + ps->nblocks) % ps->nblocks];
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfHistConfig(int kbytes)
+{
+  if (kbytes <= 0) return RF_HIST_ERROR;
+  rfHistKbytes = kbytes;
+  return RF_HIST_OK;
+}
+
+double rfHistNow(void)
+{
+  epicsTimeStamp now;
+
+  epicsTimeGetCurrent(&now);
+  return now.secPastEpoch + now.nsec * 1e-9;
+}
+
+int rfHistFind(const char *stn, const char *name)
+{
+  char full[RF_HIST_NAME_LEN];
+  int  i;
+
+  if (!name) return RF_HIST_ERROR;
+  if (stn && *stn) sprintf(full, "%.*s:%.*s", 8, stn,
+                           RF_HIST_NAME_LEN - 10, name);
+  else             sprintf(full, "%.*s", RF_HIST_NAME_LEN - 1, name);
+  for (i = 0; i < rfHistCount; i++)
+    if (!strcmp(full, rfHistTable[i]->name)) return i;
+  return RF_HIST_ERROR;
+}
+
+int rfHistOpen(const char *stn, const char *name)
+{
+  rfHistSeries *ps;
+  int           id;
+
+  epicsThreadOnce(&rfHistOnce, rfHistInit, NULL);
+  epicsMutexMustLock(rfHistTableLock);
+  id = rfHistFind(stn, name);
+  if ((id == RF_HIST_ERROR) && name && (rfHistCount < RF_HIST_MAX_SERIES))
+  {
+    ps = (rfHistSeries *)calloc(1, sizeof(*ps));
+    if (ps)
+    {
+      ps->nblocks = (int)(((long)rfHistKbytes * 1024) / sizeof(rfHistBlock));
+      if (ps->nblocks < 2) ps->nblocks = 2;
+      ps->block = (rfHistBlock *)calloc(ps->nblocks, sizeof(rfHistBlock));
+      if (!ps->block)
+      {
+        free(ps);
+        ps = NULL;
+      }
+    }
+    if (ps)
+    {
+      if (stn && *stn) sprintf(ps->name, "%.*s:%.*s", 8, stn,
+                               RF_HIST_NAME_LEN - 10, name);
+      else             sprintf(ps->name, "%.*s", RF_HIST_NAME_LEN - 1, name);
+      ps->lock = epicsMutexMustCreate();
+      ps->head = ps->nblocks - 1;
+      id = rfHistCount;
+      rfHistTable[rfHistCount++] = ps;
+    }
+    else
+    {
+      epicsPrintf("rfHistOpen: No memory for series %s\n", name);
+    }
+  }
+  epicsMutexUnlock(rfHistTableLock);
+  return id;
+}
+
+int rfHistAddAt(int id, double time, double value)
+{
+  rfHistSeries *ps = rfHistGetSeries(id);
+  rfHistBlock  *pb;
+
+  if (!ps) return RF_HIST_ERROR;
+  epicsMutexMustLock(ps->lock);
+  pb = &ps->block[ps->head];
+  if (ps->used && (time < pb->t1)) time = pb->t1;
+  if (!ps->used ||
+      (pb->nbits + RF_HIST_SAMPLE_BITS > RF_HIST_BLOCK_DATA * 8) ||
+      (time - pb->t0 > RF_HIST_BLOCK_SPAN))
+  {
+    ps->head = (ps->head + 1) % ps->nblocks;
+    if (ps->used < ps->nblocks) ps->used++;
+    rfHistStart(&ps->block[ps->head], time, value);
+  }
+  else
+  {
+    rfHistEncode(pb, time, value);
+  }
+  ps->total++;
+  epicsMutexUnlock(ps->lock);
+  return RF_HIST_OK;
+}
+
+int rfHistAdd(int id, double value)
+{
+  return rfHistAddAt(id, rfHistNow(), value);
+}
+
+int rfHistStats(int id, double t0, double t1, double *min, double *max,
+                double *mean, unsigned long *count)
+{
+  rfHistSeries *ps = rfHistGetSeries(id);
+  rfHistBlock  *pb;
+  rfHistCursor  cursor;
+  double        time, value, sum = 0.0;
+  int           n;
+
+  if (!ps) return RF_HIST_ERROR;
+  *count = 0;
+  *min = *max = *mean = 0.0;
+  epicsMutexMustLock(ps->lock);
+  for (n = 0; n < ps->used; n++)
+  {
+    pb = rfHistBlockAt(ps, n);
+    if ((pb->t1 < t0) || (pb->t0 > t1)) continue;
+    if ((pb->t0 >= t0) && (pb->t1 <= t1))
+    {
+      if (!*count || (pb->min < *min)) *min = pb->min;
+      if (!*count || (pb->max > *max)) *max = pb->max;
+      sum    += pb->sum;
+      *count += pb->count;
+      continue;
+    }
+    rfHistCursorInit(&cursor, pb);
+    while (rfHistNext(&cursor, &time, &value))
+    {
+      if ((time < t0) || (time > t1)) continue;
+      if (!*count || (value < *min)) *min = value;
+      if (!*count || (value > *max)) *max = value;
+      sum += value;
+      (*count)++;
+    }
+  }
+  epicsMutexUnlock(ps->lock);
+  if (*count) *mean = sum / *count;
+  return RF_HIST_OK;
+}
+
+/*
+ * Fill npts buckets spanning [t0,t1) with the min, max and mean of the
+ * samples in each.  Empty buckets hold the previous bucket's values.
+ * Returns the number of buckets with samples.
+ */
+int rfHistDecimate(int id, double t0, double t1, int npts,
+                   float *min, float *max, float *mean)
+{
+  rfHistSeries  *ps = rfHistGetSeries(id);
+  rfHistBlock   *pb;
+  rfHistCursor   cursor;
+  double        *sum, time, value, width;
+  unsigned long *count;
+  int            n, i, b0, b1, filled = 0;
+
+  if (!ps || (npts <= 0) || (t1 <= t0)) return RF_HIST_ERROR;
+  sum   = (double *)calloc(npts, sizeof(*sum));
+  count = (unsigned long *)calloc(npts, sizeof(*count));
+  if (!sum || !count)
+  {
+    free(sum);
+    free(count);
+    return RF_HIST_ERROR;
+  }
+  width = (t1 - t0) / npts;
+  epicsMutexMustLock(ps->lock);
+  for (n = 0; n < ps->used; n++)
+  {
+    pb = rfHistBlockAt(ps, n);
+    if ((pb->t1 < t0) || (pb->t0 >= t1)) continue;
+    b0 = (int)floor((pb->t0 - t0) / width);
+    b1 = (int)floor((pb->t1 - t0) / width);
+    if ((b0 == b1) && (b0 >= 0) && (b0 < npts))
+    {
+      if (!count[b0] || (pb->min < min[b0])) min[b0] = (float)pb->min;
+      if (!count[b0] || (pb->max > max[b0])) max[b0] = (float)pb->max;
+      sum[b0]   += pb->sum;
+      count[b0] += pb->count;
+      continue;
+    }
+    rfHistCursorInit(&cursor, pb);
+    while (rfHistNext(&cursor, &time, &value))
+    {
+      i = (int)floor((time - t0) / width);
+      if ((i < 0) || (i >= npts)) continue;
+      if (!count[i] || (value < min[i])) min[i] = (float)value;
+      if (!count[i] || (value > max[i])) max[i] = (float)value;
+      sum[i] += value;
+      count[i]++;
+    }
+  }
+  epicsMutexUnlock(ps->lock);
+
+  for (i = 0; i < npts; i++)
+  {
+    if (count[i])
+    {
+      mean[i] = (float)(sum[i] / count[i]);
+      filled++;
+    }
+    else
+    {
+      min[i] = max[i] = mean[i] = (i > 0) ? mean[i - 1] : 0.0f;
+    }
+  }
+  free(sum);
+  free(count);
+  return filled;
+}
+
+void rfHistReport(int level)
+{
+  rfHistSeries *ps;
+  unsigned long samples, bits;
+  double        first, last;
+  int           i, n;
+
+  printf("%d series, %d KB per series, %d bytes per block\n",
+         rfHistCount, rfHistKbytes, (int)sizeof(rfHistBlock));
+  for (i = 0; i < rfHistCount; i++)
+  {
+    ps = rfHistTable[i];
+    samples = bits = 0;
+    first = last = 0.0;
+    epicsMutexMustLock(ps->lock);
+    for (n = 0; n < ps->used; n++)
+    {
+      samples += rfHistBlockAt(ps, n)->count;
+      bits    += rfHistBlockAt(ps, n)->nbits;
+    }
+    if (ps->used)
+    {
+      first = rfHistBlockAt(ps, 0)->t0;
+      last  = ps->block[ps->head].t1;
+    }
+    epicsMutexUnlock(ps->lock);
+    printf("%-32s %8lu samples %5d/%d blocks %7.2f hours %5.2f bits/sample\n",
+           ps->name, samples, ps->used, ps->nblocks, (last - first) / 3600.0,
+           samples ? (double)bits / samples : 0.0);
+    if (level > 0)
+      printf("%32s %8lu recorded in total\n", "", ps->total);
+  }
+}
+
+void rfHistQuery(const char *name, double seconds, int npts)
+{
+  float         min[RF_HIST_QUERY_NPTS], max[RF_HIST_QUERY_NPTS];
+  float         mean[RF_HIST_QUERY_NPTS];
+  double        t1 = rfHistNow(), t0 = t1 - seconds;
+  double        dmin, dmax, dmean;
+  unsigned long count;
+  int           id = rfHistFind(NULL, name), i;
+
+  if ((id == RF_HIST_ERROR) || (seconds <= 0.0))
+  {
+    printf("rfHistQuery: No series %s or bad range\n", name ? name : "");
+    return;
+  }
+  rfHistStats(id, t0, t1, &dmin, &dmax, &dmean, &count);
+  printf("%s last %g sec: %lu samples min %g max %g mean %g\n",
+         name, seconds, count, dmin, dmax, dmean);
+  if (npts <= 0) return;
+  if (npts > RF_HIST_QUERY_NPTS) npts = RF_HIST_QUERY_NPTS;
+  rfHistDecimate(id, t0, t1, npts, min, max, mean);
+  for (i = 0; i < npts; i++)
+    printf("%10.1f %12g %12g %12g\n", (i + 1) * seconds / npts - seconds,
+           min[i], max[i], mean[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfHistConfigArg0 = {"kbytes", iocshArgInt};
+static const iocshArg *rfHistConfigArgs[] = {&rfHistConfigArg0};
+static const iocshFuncDef rfHistConfigDef =
+  {"rfHistConfig", 1, rfHistConfigArgs};
+static void rfHistConfigCall(const iocshArgBuf *args)
+{
+  rfHistConfig(args[0].ival);
+}
+
+static const iocshArg rfHistReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfHistReportArgs[] = {&rfHistReportArg0};
+static const iocshFuncDef rfHistReportDef =
+  {"rfHistReport", 1, rfHistReportArgs};
+static void rfHistReportCall(const iocshArgBuf *args)
+{
+  rfHistReport(args[0].ival);
+}
+
+static const iocshArg rfHistQueryArg0 = {"name",    iocshArgString};
+static const iocshArg rfHistQueryArg1 = {"seconds", iocshArgDouble};
+static const iocshArg rfHistQueryArg2 = {"npts",    iocshArgInt};
+static const iocshArg *rfHistQueryArgs[] =
+  {&rfHistQueryArg0, &rfHistQueryArg1, &rfHistQueryArg2};
+static const iocshFuncDef rfHistQueryDef =
+  {"rfHistQuery", 3, rfHistQueryArgs};
+static void rfHistQueryCall(const iocshArgBuf *args)
+{
+  rfHistQuery(args[0].sval, args[1].dval, args[2].ival);
+}
+
+static void rfHistRegistrar(void)
+{
+  iocshRegister(&rfHistConfigDef, rfHistConfigCall);
+  iocshRegister(&rfHistReportDef, rfHistReportCall);
+  iocshRegister(&rfHistQueryDef,  rfHistQueryCall);
+}
+epicsExportRegistrar(rfHistRegistrar);
@@ -0,0 +1,58 @@
+/*=============================================================================
+
+  Abs:  Compressed In-IOC Time-Series History
+
+  Name: rfHist.h
+
+  Prev: None
+
+  Rem:  Loop variables are recorded into named series ("STN:NAME").  At
+        the 2 Hz loop rate the default RF_HIST_KBYTES holds about a day
+        of a float loop value and two to three days of a status.  Times
+        are seconds past the EPICS epoch as doubles.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_HIST_H
+#define RF_HIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_HIST_OK           0
+#define RF_HIST_ERROR      (-1)
+
+#define RF_HIST_MAX_SERIES   32     /* # series per IOC                    */
+#define RF_HIST_NAME_LEN     40     /* series name length incl. station    */
+#define RF_HIST_KBYTES       512    /* default storage per series in KB    */
+
+/* IOC shell */
+int    rfHistConfig  (int kbytes);
+void   rfHistReport  (int level);
+void   rfHistQuery   (const char *name, double seconds, int npts);
+
+/* Recording */
+int    rfHistOpen    (const char *stn, const char *name);
+int    rfHistFind    (const char *stn, const char *name);
+int    rfHistAdd     (int id, double value);
+int    rfHistAddAt   (int id, double time, double value);
+double rfHistNow     (void);
+
+/* Range queries */
+int    rfHistStats   (int id, double t0, double t1, double *min,
+                      double *max, double *mean, unsigned long *count);
+int    rfHistDecimate(int id, double t0, double t1, int npts,
+                      float *min, float *max, float *mean);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_HIST_H */
@@ -0,0 +1,308 @@
+/*=============================================================================
+
+  Abs:  Calibration Table Conversions
+
+  Name: rfLut.c
+         Public:
+           rfLutConvert - convert values through a table
+           rfLutFind    - id of a table name
+           rfLutInvert  - convert values back through a table
+           rfLutLoad    - load or reload the table file
+           rfLutReport  - print the tables and their use
+           rfLutShow    - print one conversion each way
+         Private:
+           rfLutInit    - create the lock
+           rfLutBind    - point the ids at the tables of a set
+           rfLutBlocks  - convert a waveform a block at a time
+
+  Rem:  The drive, reflected power and tune mode DAC calibrations used to
+        reach the IOC as breakpoint tables copied into the databases by
+        hand.  They are now compiled from the spreadsheets in
+        llrf/calibrations into one file, rfCal.lut, installed with the
+        databases, and converted through here (rfLutSpline.c), a whole
+        waveform per call if the caller has one.
+
+        rfLutLoad reads the new file completely and checks it before
+        swapping it in; if anything is wrong the tables already loaded
+        stay.  Conversions hold the lock for one RF_LUT_BLOCK of values
+        at a time, so a reload never frees a table in use, and a long
+        waveform holds up other loops for one block at most.  A
+        waveform converted across a reload may use both tables.
+
+        IOC shell:
+          rfLutLoad("$(TOP)/db/rfCal.lut")
+          rfLutReport(1)
+          rfLutShow("TUNE_DAC", 1000)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfLut.h"
+
+typedef struct
+{
+  char               name[RF_LUT_NAME_LEN];
+  const rfLutTable  *pt;     /* table of the loaded set, or NULL          */
+  unsigned long      calls;
+  unsigned long      samples;
+  unsigned long      clamped;  /* samples outside the table             */
+} rfLutId;
+
+static rfLutId       rfLutIds[RF_LUT_MAX_IDS];
+static int           rfLutCount  = 0;
+static rfLutSet     *rfLutTables = NULL;
+static char          rfLutFile[RF_LUT_FILE_LEN];
+static int           rfLutLoads  = 0;
+static epicsMutexId  rfLutLock   = NULL;
+static epicsThreadOnceId rfLutOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfLutInit(void *arg)
+{
+  rfLutLock = epicsMutexMustCreate();
+}
+
+/*
+ * Called with the lock held.
+ */
+static void rfLutBind(const rfLutSet *ps)
+{
+  int id;
+
+  for (id = 0; id < rfLutCount; id++)
+    rfLutIds[id].pt = rfLutLookup(ps, rfLutIds[id].name);
+}
+
+/*
+ * Convert RF_LUT_BLOCK values per hold of the lock, so a long waveform
+ * lets other callers and a reload in between its blocks.
+ */
+static int rfLutBlocks(int id, const double *in, double *out, int n,
+                       int (*conv)(const rfLutTable *, const double *,
+                                   double *, int))
+{
+  rfLutId *pi;
+  int      i, nb, status, clamped = 0;
+
+  if ((id < 0) || (id >= rfLutCount) || (n < 0)) return RF_LUT_ERROR;
+  pi = &rfLutIds[id];
+  for (i = 0; (i < n) || (i == 0); i += RF_LUT_BLOCK)
+  {
+    nb = (n - i < RF_LUT_BLOCK) ? n - i : RF_LUT_BLOCK;
+    epicsMutexMustLock(rfLutLock);
+    status = conv(pi->pt, in + i, out + i, nb);
+    if (status >= 0)
+    {
+      if (i == 0) pi->calls++;
+      pi->samples += nb;
+      pi->clamped += status;
+    }
+    epicsMutexUnlock(rfLutLock);
+    if (status < 0) return status;
+    clamped += status;
+  }
+  return clamped;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * With no file, or an empty one, reloads the last file loaded.
+ */
+int rfLutLoad(const char *file)
+{
+  rfLutSet *ps, *old;
+  char      msg[RF_LUT_MSG_LEN];
+  int       id;
+
+  epicsThreadOnce(&rfLutOnce, rfLutInit, NULL);
+  if (!file || !*file) file = rfLutFile;
+  if (!*file)
+  {
+    epicsPrintf("rfLutLoad: No table file\n");
+    return RF_LUT_ERROR;
+  }
+  if ((ps = rfLutRead(file, msg)) == NULL)
+  {
+    epicsPrintf("rfLutLoad: %s, tables not changed\n", msg);
+    return RF_LUT_ERROR;
+  }
+  epicsMutexMustLock(rfLutLock);
+  old         = rfLutTables;
+  rfLutTables = ps;
+  rfLutBind(ps);
+  if (file != rfLutFile)
+    sprintf(rfLutFile, "%.*s", RF_LUT_FILE_LEN - 1, file);
+  rfLutLoads++;
+  for (id = 0; id < rfLutCount; id++)
+    if (!rfLutIds[id].pt)
+      epicsPrintf("rfLutLoad: No table %s in %s\n", rfLutIds[id].name,
+                  rfLutFile);
+  epicsMutexUnlock(rfLutLock);
+  rfLutFree(old);
+  return RF_LUT_OK;
+}
+
+int rfLutFind(const char *name)
+{
+  int id;
+
+  if (!name || !*name) return RF_LUT_ERROR;
+  epicsThreadOnce(&rfLutOnce, rfLutInit, NULL);
+  epicsMutexMustLock(rfLutLock);
+  for (id = 0; id < rfLutCount; id++)
+    if (!strncmp(name, rfLutIds[id].name, RF_LUT_NAME_LEN - 1)) break;
+  if (id == rfLutCount)
+  {
+    if (rfLutCount < RF_LUT_MAX_IDS)
+    {
+      sprintf(rfLutIds[id].name, "%.*s", RF_LUT_NAME_LEN - 1, name);
+      rfLutIds[id].pt = rfLutLookup(rfLutTables, rfLutIds[id].name);
+      rfLutCount++;
+    }
+    else
+    {
+      epicsPrintf("rfLutFind: No room for table %s\n", name);
+      id = RF_LUT_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfLutLock);
+  return id;
+}
+
+/*
+ * Returns the number of values outside the table, which were given the
+ * end values, or RF_LUT_ERROR.  x and y may be the same array.
+ */
+int rfLutConvert(int id, const double *x, double *y, int n)
+{
+  return rfLutBlocks(id, x, y, n, rfLutEval);
+}
+
+/*
+ * As rfLutConvert the other way, e.g. mW to tune mode DAC counts.
+ */
+int rfLutInvert(int id, const double *y, double *x, int n)
+{
+  return rfLutBlocks(id, y, x, n, rfLutInv);
+}
+
+void rfLutReport(int level)
+{
+  const rfLutTable *pt;
+  rfLutId          *pi;
+  int               i;
+
+  epicsThreadOnce(&rfLutOnce, rfLutInit, NULL);
+  epicsMutexMustLock(rfLutLock);
+  if (!rfLutTables)
+    printf("No calibration tables loaded\n");
+  else
+  {
+    printf("%d calibration tables from %s, %s, %d loads\n",
+           rfLutTables->ntables, rfLutFile, rfLutTables->stamp, rfLutLoads);
+    if (level > 1)
+      for (i = 0; i < rfLutTables->ntables; i++)
+      {
+        pt = &rfLutTables->tables[i];
+        printf("  %-16s %4d points %8s -> %-6s%s\n", pt->name, pt->npts,
+               pt->xunits, pt->yunits, pt->dir ? "" : " (not invertible)");
+        if (level > 2)
+          printf("    %s, x %g to %g\n", pt->source, pt->x[0],
+                 pt->x[pt->npts - 1]);
+      }
+  }
+  printf("%d tables in use\n", rfLutCount);
+  if (level > 0)
+    for (i = 0; i < rfLutCount; i++)
+    {
+      pi = &rfLutIds[i];
+      printf("  %-16s %10lu calls %12lu values %10lu clamped%s\n", pi->name,
+             pi->calls, pi->samples, pi->clamped,
+             pi->pt ? "" : "  NOT LOADED");
+    }
+  epicsMutexUnlock(rfLutLock);
+}
+
+/*
+ * For commissioning a new table: value through it and back.
+ */
+void rfLutShow(const char *name, double value)
+{
+  const rfLutTable *pt;
+  double            fwd, inv;
+  int               out;
+
+  epicsThreadOnce(&rfLutOnce, rfLutInit, NULL);
+  epicsMutexMustLock(rfLutLock);
+  if ((pt = rfLutLookup(rfLutTables, name)) == NULL)
+    printf("No table %s\n", name ? name : "");
+  else
+  {
+    out = rfLutEval(pt, &value, &fwd, 1);
+    printf("%s: %g %s -> %g %s%s\n", pt->name, value, pt->xunits, fwd,
+           pt->yunits, out ? " (clamped)" : "");
+    if (pt->dir)
+    {
+      out = rfLutInv(pt, &value, &inv, 1);
+      printf("%s: %g %s -> %g %s%s\n", pt->name, value, pt->yunits, inv,
+             pt->xunits, out ? " (clamped)" : "");
+    }
+  }
+  epicsMutexUnlock(rfLutLock);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfLutLoadArg0 = {"file", iocshArgString};
+static const iocshArg *rfLutLoadArgs[] = {&rfLutLoadArg0};
+static const iocshFuncDef rfLutLoadDef =
+  {"rfLutLoad", 1, rfLutLoadArgs};
+static void rfLutLoadCall(const iocshArgBuf *args)
+{
+  rfLutLoad(args[0].sval);
+}
+
+static const iocshArg rfLutReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfLutReportArgs[] = {&rfLutReportArg0};
+static const iocshFuncDef rfLutReportDef =
+  {"rfLutReport", 1, rfLutReportArgs};
+static void rfLutReportCall(const iocshArgBuf *args)
+{
+  rfLutReport(args[0].ival);
+}
+
+static const iocshArg rfLutShowArg0 = {"table", iocshArgString};
+static const iocshArg rfLutShowArg1 = {"value", iocshArgDouble};
+static const iocshArg *rfLutShowArgs[] = {&rfLutShowArg0, &rfLutShowArg1};
+static const iocshFuncDef rfLutShowDef =
+  {"rfLutShow", 2, rfLutShowArgs};
+static void rfLutShowCall(const iocshArgBuf *args)
+{
+  rfLutShow(args[0].sval, args[1].dval);
+}
+
+static void rfLutRegistrar(void)
+{
+  iocshRegister(&rfLutLoadDef,   rfLutLoadCall);
+  iocshRegister(&rfLutReportDef, rfLutReportCall);
+  iocshRegister(&rfLutShowDef,   rfLutShowCall);
+}
+epicsExportRegistrar(rfLutRegistrar);
@@ -0,0 +1,52 @@
+/*=============================================================================
+
+  Abs:  Calibration Table Conversions
+
+  Name: rfLut.h
+
+  Prev: rfLutSpline.h         (table file and interpolation)
+
+  Rem:  A caller finds a table once by name and converts through it as
+        often as it likes, one value or a whole waveform at a time.  The
+        id stays good across rfLutLoad, which replaces the tables while
+        the IOC runs; a name the loaded file lacks converts nothing and
+        returns RF_LUT_ERROR until a file that has it is loaded.
+
+        Table names are those of rfCalTables.py, e.g. TUNE_DAC (tune mode
+        DAC counts to mW), DRIVE_AMP_013, CAV1REFL.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_LUT_H
+#define RF_LUT_H
+
+#include "rfLutSpline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_LUT_MAX_IDS        32    /* # table names found per IOC         */
+#define RF_LUT_FILE_LEN       128   /* table file path                     */
+
+/* IOC shell */
+int    rfLutLoad    (const char *file);
+void   rfLutReport  (int level);
+void   rfLutShow    (const char *name, double value);
+
+/* Callers */
+int    rfLutFind    (const char *name);
+int    rfLutConvert (int id, const double *x, double *y, int n);
+int    rfLutInvert  (int id, const double *y, double *x, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_LUT_H */
@@ -0,0 +1,409 @@
+/*=============================================================================
+
+  Abs:  Calibration Lookup Tables and Monotone Spline Interpolation
+
+  Name: rfLutSpline.c
+         Public:
+           rfLutRead      - read and check a compiled table file
+           rfLutFree      - free what rfLutRead returned
+           rfLutLookup    - table of a name
+           rfLutEval      - convert a block of samples through a table
+           rfLutInv       - invert a table for a block of values
+         Private:
+           rfLutGet32     - big-endian 32-bit word
+           rfLutGetDouble - big-endian double
+           rfLutFnv       - FNV-1a checksum
+           rfLutBuild     - slopes and segment polynomials of a table
+           rfLutSegment   - segment holding a value
+           rfLutGridSeg   - segment holding a value, from the grid
+
+  Rem:  rfLutEval works through the samples RF_LUT_BLOCK at a time in two
+        passes: the first clamps each sample into the table, finds its
+        segment and gathers the four coefficients of that segment into
+        block arrays, the second evaluates the polynomials.  The second
+        pass is a plain loop over contiguous arrays with no branches or
+        indexing through the segment, which the compiler vectorizes.  The first looks the
+        segment up in a uniform grid over the table and steps over the
+        few knots inside the grid cell, rather than searching.
+
+        The slopes are from Fritsch & Carlson, "Monotone Piecewise Cubic
+        Interpolation", SIAM J. Numer. Anal. 17 (1980): three-point
+        averages, zero at a local extremum, scaled back where they would
+        let a segment overshoot.  A two-point table is a straight line.
+
+        rfLutInv solves the cubic of the segment holding each value by
+        Newton steps kept inside the segment by bisection.  Values are
+        converted one at a time; inversion is for setpoints.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "rfLutSpline.h"
+
+#define RF_LUT_MAGIC        "RFLT"
+#define RF_LUT_HEADER_LEN   (16 + RF_LUT_STAMP_LEN)
+#define RF_LUT_TABLE_LEN    (RF_LUT_NAME_LEN + 2 * RF_LUT_UNITS_LEN + \
+                             RF_LUT_SOURCE_LEN + 4)
+#define RF_LUT_INV_ITER     60    /* Newton and bisection steps, at most  */
+
+/*----------------------------------------------------------------------------*/
+
+static unsigned long rfLutGet32(const unsigned char *p)
+{
+  return ((unsigned long)p[0] << 24) | ((unsigned long)p[1] << 16) |
+         ((unsigned long)p[2] << 8)  |  (unsigned long)p[3];
+}
+
+static double rfLutGetDouble(const unsigned char *p)
+{
+  unsigned long long u = 0;
+  double             d;
+  int                i;
+
+  for (i = 0; i < 8; i++) u = (u << 8) | p[i];
+  memcpy(&d, &u, sizeof(d));
+  return d;
+}
+
+static unsigned long rfLutFnv(const unsigned char *p, long len)
+{
+  unsigned long h = 0x811c9dc5UL;
+
+  while (len-- > 0) h = ((h ^ *p++) * 0x01000193UL) & 0xffffffffUL;
+  return h;
+}
+
+/*
+ * Fills c1..c3 from x and y and sets dir.  Needs x strictly increasing.
+ */
+static void rfLutBuild(rfLutTable *pt)
+{
+  double *m = pt->c1;         /* slopes at the knots, then c1 */
+  double  h, d, a, b, r;
+  int     i, k, n = pt->npts;
+
+  for (k = 0; k < n - 1; k++)
+    pt->c2[k] = (pt->y[k + 1] - pt->y[k]) / (pt->x[k + 1] - pt->x[k]);
+
+  m[0]     = pt->c2[0];
+  m[n - 1] = pt->c2[n - 2];
+  for (k = 1; k < n - 1; k++)
+    m[k] = (pt->c2[k - 1] * pt->c2[k] <= 0.0) ? 0.0 :
+           0.5 * (pt->c2[k - 1] + pt->c2[k]);
+
+  for (k = 0; k < n - 1; k++)
+  {
+    d = pt->c2[k];
+    if (d == 0.0)
+    {
+      m[k] = m[k + 1] = 0.0;
+      continue;
+    }
+    a = m[k] / d;
+    b = m[k + 1] / d;
+    if (a < 0.0) m[k] = a = 0.0;
+    if (b < 0.0) m[k + 1] = b = 0.0;
+    r = a * a + b * b;
+    if (r > 9.0)
+    {
+      r        = 3.0 / sqrt(r);
+      m[k]     = r * a * d;
+      m[k + 1] = r * b * d;
+    }
+  }
+
+  for (k = 0; k < n - 1; k++)
+  {
+    h         = pt->x[k + 1] - pt->x[k];
+    d         = pt->c2[k];
+    pt->c2[k] = (3.0 * d - 2.0 * m[k] - m[k + 1]) / h;
+    pt->c3[k] = (m[k] + m[k + 1] - 2.0 * d) / (h * h);
+  }
+  pt->c2[n - 1] = pt->c3[n - 1] = 0.0;
+
+  pt->gscale = RF_LUT_GRID / (pt->x[n - 1] - pt->x[0]);
+  for (k = 0, i = 0; i <= RF_LUT_GRID; i++)
+  {
+    a = pt->x[0] + i / pt->gscale;
+    while ((k < n - 2) && (pt->x[k + 1] <= a)) k++;
+    pt->grid[i] = k;
+  }
+
+  pt->dir = (pt->y[1] > pt->y[0]) ? 1 : (pt->y[1] < pt->y[0]) ? -1 : 0;
+  for (k = 1; (k < n - 1) && pt->dir; k++)
+    if ((pt->y[k + 1] - pt->y[k]) * pt->dir <= 0.0) pt->dir = 0;
+}
+
+/*
+ * Index k of the segment [v[k], v[k+1]] holding w, for v rising (dir 1)
+ * or falling (dir -1) and w already clamped into the table.
+ */
+static int rfLutSegment(const double *v, int n, int dir, double w)
+{
+  int lo = 0, hi = n - 1, mid;
+
+  while (hi - lo > 1)
+  {
+    mid = (lo + hi) / 2;
+    if ((v[mid] - w) * dir <= 0.0) lo = mid;
+    else                           hi = mid;
+  }
+  return lo;
+}
+
+/*
+ * As rfLutSegment over the knots of a table, for v inside the table.
+ */
+static int rfLutGridSeg(const rfLutTable *pt, double v)
+{
+  int k = pt->grid[(int)((v - pt->x[0]) * pt->gscale)];
+
+  while ((k < pt->npts - 2) && (pt->x[k + 1] <= v)) k++;
+  return k;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Returns NULL, with the reason in msg (RF_LUT_MSG_LEN), if the file
+ * cannot be read, is of another version or fails its checks.
+ */
+rfLutSet *rfLutRead(const char *file, char *msg)
+{
+  FILE          *fp;
+  unsigned char *buf = NULL, *p, *end;
+  rfLutSet      *ps  = NULL;
+  rfLutTable    *pt;
+  long           len = 0;
+  unsigned long  ntables, npts;
+  int            i, k;
+
+  sprintf(msg, "%.*s: ", RF_LUT_MSG_LEN - 48, file ? file : "");
+  if (!file || !(fp = fopen(file, "rb")))
+  {
+    strcat(msg, "cannot open");
+    return NULL;
+  }
+  if ((fseek(fp, 0, SEEK_END) == 0) && ((len = ftell(fp)) > 0) &&
+      (fseek(fp, 0, SEEK_SET) == 0) && (buf = (unsigned char *)malloc(len)) &&
+      (fread(buf, 1, len, fp) != (size_t)len))
+  {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(fp);
+  if (!buf)
+  {
+    strcat(msg, "cannot read");
+    return NULL;
+  }
+
+  end = buf + len;
+  if ((len < RF_LUT_HEADER_LEN) || memcmp(buf, RF_LUT_MAGIC, 4))
+  {
+    strcat(msg, "not a table file");
+    goto bad;
+  }
+  if (rfLutGet32(buf + 4) != RF_LUT_VERSION)
+  {
+    sprintf(msg + strlen(msg), "version %lu, not %d", rfLutGet32(buf + 4),
+            RF_LUT_VERSION);
+    goto bad;
+  }
+  ntables = rfLutGet32(buf + 8);
+  if ((ntables == 0) || (ntables > RF_LUT_MAX_TABLES))
+  {
+    sprintf(msg + strlen(msg), "%lu tables", ntables);
+    goto bad;
+  }
+  if (rfLutFnv(buf + RF_LUT_HEADER_LEN, len - RF_LUT_HEADER_LEN) !=
+      rfLutGet32(buf + 12))
+  {
+    strcat(msg, "bad checksum");
+    goto bad;
+  }
+
+  if (!(ps = (rfLutSet *)calloc(1, sizeof(*ps))) ||
+      !(ps->tables = (rfLutTable *)calloc(ntables, sizeof(rfLutTable))))
+  {
+    strcat(msg, "no memory");
+    goto bad;
+  }
+  memcpy(ps->stamp, buf + 16, RF_LUT_STAMP_LEN);
+  ps->stamp[RF_LUT_STAMP_LEN - 1] = '\0';
+
+  p = buf + RF_LUT_HEADER_LEN;
+  for (i = 0; i < (int)ntables; i++)
+  {
+    pt = &ps->tables[i];
+    if (end - p < RF_LUT_TABLE_LEN)
+    {
+      strcat(msg, "truncated");
+      goto bad;
+    }
+    memcpy(pt->name,   p, RF_LUT_NAME_LEN - 1);      p += RF_LUT_NAME_LEN;
+    memcpy(pt->xunits, p, RF_LUT_UNITS_LEN - 1);     p += RF_LUT_UNITS_LEN;
+    memcpy(pt->yunits, p, RF_LUT_UNITS_LEN - 1);     p += RF_LUT_UNITS_LEN;
+    memcpy(pt->source, p, RF_LUT_SOURCE_LEN - 1);    p += RF_LUT_SOURCE_LEN;
+    npts = rfLutGet32(p);                            p += 4;
+    if ((npts < 2) || (npts > RF_LUT_MAX_PTS) ||
+        ((unsigned long)(end - p) < npts * 2 * 8))
+    {
+      sprintf(msg + strlen(msg), "%.*s: %lu points", RF_LUT_NAME_LEN,
+              pt->name, npts);
+      goto bad;
+    }
+    pt->npts = (int)npts;
+    if (!(pt->x = (double *)malloc(5 * npts * sizeof(double))))
+    {
+      strcat(msg, "no memory");
+      goto bad;
+    }
+    ps->ntables++;
+    pt->y  = pt->x  + npts;
+    pt->c1 = pt->y  + npts;
+    pt->c2 = pt->c1 + npts;
+    pt->c3 = pt->c2 + npts;
+    for (k = 0; k < (int)npts; k++, p += 8) pt->x[k] = rfLutGetDouble(p);
+    for (k = 0; k < (int)npts; k++, p += 8) pt->y[k] = rfLutGetDouble(p);
+    for (k = 1; k < (int)npts; k++)
+      if (!(pt->x[k] > pt->x[k - 1]))
+      {
+        sprintf(msg + strlen(msg), "%.*s: x not increasing",
+                RF_LUT_NAME_LEN, pt->name);
+        goto bad;
+      }
+    rfLutBuild(pt);
+  }
+  if (p != end)
+  {
+    strcat(msg, "trailing data");
+    goto bad;
+  }
+  free(buf);
+  msg[0] = '\0';
+  return ps;
+
+bad:
+  free(buf);
+  rfLutFree(ps);
+  return NULL;
+}
+
+void rfLutFree(rfLutSet *ps)
+{
+  int i;
+
+  if (!ps) return;
+  for (i = 0; i < ps->ntables; i++) free(ps->tables[i].x);
+  free(ps->tables);
+  free(ps);
+}
+
+const rfLutTable *rfLutLookup(const rfLutSet *ps, const char *name)
+{
+  int i;
+
+  if (!ps || !name) return NULL;
+  for (i = 0; i < ps->ntables; i++)
+    if (!strcmp(ps->tables[i].name, name)) return &ps->tables[i];
+  return NULL;
+}
+
+/*
+ * x and y may be the same array.  Returns the number of samples outside
+ * the table, which were given the end values, or RF_LUT_ERROR.
+ */
+int rfLutEval(const rfLutTable *pt, const double *x, double *y, int n)
+{
+  double  t[RF_LUT_BLOCK], a0[RF_LUT_BLOCK], a1[RF_LUT_BLOCK];
+  double  a2[RF_LUT_BLOCK], a3[RF_LUT_BLOCK];
+  double  lo, hi, v;
+  int     i, j, nb, k, out = 0;
+
+  if (!pt || !x || !y || (n < 0)) return RF_LUT_ERROR;
+  lo = pt->x[0];
+  hi = pt->x[pt->npts - 1];
+
+  for (i = 0; i < n; i += RF_LUT_BLOCK)
+  {
+    nb = (n - i < RF_LUT_BLOCK) ? n - i : RF_LUT_BLOCK;
+    for (j = 0; j < nb; j++)
+    {
+      v = x[i + j];
+      if      (v < lo) { v = lo; out++; }
+      else if (v > hi) { v = hi; out++; }
+      else if (v != v) { v = lo; out++; }
+      k     = rfLutGridSeg(pt, v);
+      t[j]  = v - pt->x[k];
+      a0[j] = pt->y[k];
+      a1[j] = pt->c1[k];
+      a2[j] = pt->c2[k];
+      a3[j] = pt->c3[k];
+    }
+    for (j = 0; j < nb; j++)
+      y[i + j] = a0[j] + t[j] * (a1[j] + t[j] * (a2[j] + t[j] * a3[j]));
+  }
+  return out;
+}
+
+/*
+ * As rfLutEval the other way, for a table whose y is strictly monotone.
+ */
+int rfLutInv(const rfLutTable *pt, const double *y, double *x, int n)
+{
+  const double *v;
+  double        lo, hi, w, h, t, tn, tlo, thi, g, d, c1, c2, c3;
+  int           i, it, k, dir, out = 0;
+
+  if (!pt || !y || !x || (n < 0) || !pt->dir) return RF_LUT_ERROR;
+  v   = pt->y;
+  dir = pt->dir;
+  lo  = (dir > 0) ? v[0] : v[pt->npts - 1];
+  hi  = (dir > 0) ? v[pt->npts - 1] : v[0];
+
+  for (i = 0; i < n; i++)
+  {
+    w = y[i];
+    if      (w < lo) { w = lo; out++; }
+    else if (w > hi) { w = hi; out++; }
+    else if (w != w) { w = lo; out++; }
+    k   = rfLutSegment(v, pt->npts, dir, w);
+    h   = pt->x[k + 1] - pt->x[k];
+    c1  = pt->c1[k];
+    c2  = pt->c2[k];
+    c3  = pt->c3[k];
+    tlo = 0.0;
+    thi = h;
+    t   = h * (w - v[k]) / (v[k + 1] - v[k]);
+    for (it = 0; it < RF_LUT_INV_ITER; it++)
+    {
+      g = dir * (v[k] + t * (c1 + t * (c2 + t * c3)) - w);
+      if (g == 0.0) break;
+      if (g < 0.0) tlo = t;
+      else         thi = t;
+      d  = dir * (c1 + t * (2.0 * c2 + 3.0 * t * c3));
+      tn = (d > 0.0) ? t - g / d : tlo - 1.0;
+      if ((tn <= tlo) || (tn >= thi)) tn = 0.5 * (tlo + thi);
+      if (fabs(tn - t) <= 1e-14 * h)
+      {
+        t = tn;
+        break;
+      }
+      t = tn;
+    }
+    x[i] = pt->x[k] + t;
+  }
+  return out;
+}
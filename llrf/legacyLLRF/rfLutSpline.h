@@ -0,0 +1,97 @@
+/*=============================================================================
+
+  Abs:  Calibration Lookup Tables and Monotone Spline Interpolation
+
+  Name: rfLutSpline.h
+
+  Prev: None
+
+  Rem:  Reads the calibration tables compiled from llrf/calibrations by
+        rfCalTables.py and converts through them.  Between the measured
+        points a table is a piecewise cubic Hermite spline with
+        Fritsch-Carlson slopes, which follows the points exactly, never
+        overshoots and is monotone wherever the points are, so a table
+        with monotone y can be inverted exactly (setpoint to counts).
+        Outside the measured points the end values are held.
+
+        File layout, big-endian:
+          header  char   magic[4]     "RFLT"
+                  uint32 version      RF_LUT_VERSION
+                  uint32 ntables
+                  uint32 checksum     FNV-1a of everything after the header
+                  char   stamp[32]    hash of the workbooks compiled
+          table   char   name[32], xunits[16], yunits[16], source[64]
+                  uint32 npts
+                  double x[npts]      strictly increasing
+                  double y[npts]
+
+        Shared by the IOC (rfLut.c) and host tools, so it uses no EPICS
+        calls.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_LUT_SPLINE_H
+#define RF_LUT_SPLINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_LUT_OK             0
+#define RF_LUT_ERROR        (-1)
+
+#define RF_LUT_VERSION        1
+#define RF_LUT_MAX_TABLES     64    /* # tables in one file                */
+#define RF_LUT_MAX_PTS        1024  /* # points in one table               */
+#define RF_LUT_NAME_LEN       32
+#define RF_LUT_UNITS_LEN      16
+#define RF_LUT_SOURCE_LEN     64
+#define RF_LUT_STAMP_LEN      32
+#define RF_LUT_MSG_LEN        160   /* rfLutRead message buffer            */
+#define RF_LUT_BLOCK          64    /* samples converted per pass          */
+#define RF_LUT_GRID           256   /* cells of the segment index          */
+
+typedef struct
+{
+  char     name[RF_LUT_NAME_LEN];
+  char     xunits[RF_LUT_UNITS_LEN];
+  char     yunits[RF_LUT_UNITS_LEN];
+  char     source[RF_LUT_SOURCE_LEN];
+  int      npts;
+  int      dir;          /* +1 y rising, -1 falling, 0 not invertible */
+  double  *x;            /* npts knots                                */
+  double  *y;            /* npts values, also the constant terms      */
+  double  *c1;           /* npts - 1 segment polynomials in x - x[k]  */
+  double  *c2;
+  double  *c3;
+  double   gscale;       /* grid cells per unit x                     */
+  int      grid[RF_LUT_GRID + 1]; /* first segment of each grid cell  */
+} rfLutTable;
+
+typedef struct
+{
+  char        stamp[RF_LUT_STAMP_LEN];
+  int         ntables;
+  rfLutTable *tables;
+} rfLutSet;
+
+rfLutSet         *rfLutRead   (const char *file, char *msg);
+void              rfLutFree   (rfLutSet *ps);
+const rfLutTable *rfLutLookup (const rfLutSet *ps, const char *name);
+
+int               rfLutEval   (const rfLutTable *pt, const double *x,
+                               double *y, int n);
+int               rfLutInv    (const rfLutTable *pt, const double *y,
+                               double *x, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_LUT_SPLINE_H */
@@ -0,0 +1,312 @@
+/*=============================================================================
+
+  Abs:  Real-Time Scheduling of State Sets
+
+  Name: rfRt.c
+         Public:
+           rfRtLock    - lock the IOC in memory
+           rfRtReport  - print the scheduling of every state set
+           rfRtSetup   - set the scheduling of the calling state set
+         Private:
+           rfRtInit    - create the lock
+           rfRtParse   - parse an RT macro value
+           rfRtApply   - set the calling thread's class, priority, CPUs
+
+  Rem:  On vxWorks every state set runs at the sequencer's priority and
+        the kernel is fully preemptive, so the loops keep their cadence.
+        On a Linux IOC the same threads would share the normal scheduler
+        with the CA server and with each other: a fault file dump or a
+        calibration run could delay the DAC and HVPS loops.
+
+        The program macro RT_<state set>, or RT for every state set of
+        the program, is
+
+          class[:priority[:cpus]]
+
+          class     fifo, rr or other (SCHED_FIFO, SCHED_RR, SCHED_OTHER)
+          priority  1-99 for fifo and rr, ignored for other
+          cpus      CPU numbers and ranges joined by +, e.g. 1 or 2-3+5;
+                    empty or missing leaves the affinity alone
+
+        and is applied to the state set's thread when it starts.  With
+        neither macro the thread keeps what the sequencer gave it.  For
+        example, to keep the loops on CPU 1 ahead of everything else and
+        move the fault files and the calibration out of their way:
+
+          rfRtLock()
+          seq &rf_dac_loop,  "STN=RF1,name=DACLOOP,RT=fifo:80:1"
+          seq &rf_hvps_loop, "STN=RF1,name=HVPSLOOP,RT=fifo:79:1"
+          seq &rf_states,    "STN=RF1,RT=fifo:70:1,RT_rf_statesFF=other::2-3"
+          seq &P2RF_Calib,   "STN=RF1,RT=other::2-3"
+
+        fifo and rr need CAP_SYS_NICE (or an RLIMIT_RTPRIO), and rfRtLock
+        needs CAP_IPC_LOCK (or a large enough RLIMIT_MEMLOCK).  A failure
+        is printed and kept for rfRtReport; the state set runs on as it
+        was.  Locking with MCL_FUTURE also locks the stacks of threads
+        created later, so call rfRtLock before iocInit.
+
+        On other targets rfRtSetup only records the request.
+
+        IOC shell:
+          rfRtLock()
+          rfRtReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#ifdef __linux__
+#define _GNU_SOURCE          /* pthread_setaffinity_np, CPU_SET     */
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+#include <seqCom.h>          /* seq_macValueGet prototype           */
+
+#include "rfRt.h"
+
+#define RF_RT_CLASS_NONE      0
+#define RF_RT_CLASS_FIFO      1
+#define RF_RT_CLASS_RR        2
+#define RF_RT_CLASS_OTHER     3
+
+#define RF_RT_MAX_CPUS        64
+#define RF_RT_STATUS_LEN      40
+
+typedef struct
+{
+  int            cls;
+  int            prio;
+  int            ncpu;       /* # CPUs set in cpus, 0 leaves affinity     */
+  char           cpus[RF_RT_MAX_CPUS];
+} rfRtSpec;
+
+typedef struct
+{
+  char           name[RF_RT_NAME_LEN];
+  char           thread[RF_RT_NAME_LEN];
+  char           spec[RF_RT_SPEC_LEN];
+  char           status[RF_RT_STATUS_LEN];
+  int            ok;
+} rfRtSet;
+
+static rfRtSet       rfRtTable[RF_RT_MAX_SETS];
+static int           rfRtNset   = 0;
+static int           rfRtLocked = 0;
+static epicsMutexId  rfRtLockId = NULL;
+static epicsThreadOnceId rfRtOnce = EPICS_THREAD_ONCE_INIT;
+
+static const char   *rfRtClassName[] = {"", "fifo", "rr", "other"};
+
+/*----------------------------------------------------------------------------*/
+
+static void rfRtInit(void *arg)
+{
+  rfRtLockId = epicsMutexMustCreate();
+}
+
+/*
+ * Returns RF_RT_ERROR for a bad class, priority or CPU list.
+ */
+static int rfRtParse(const char *str, rfRtSpec *pspec)
+{
+  char        buf[RF_RT_SPEC_LEN];
+  char       *cls, *prio, *cpus, *next, *end;
+  long        lo, hi;
+
+  memset(pspec, 0, sizeof(*pspec));
+  sprintf(buf, "%.*s", RF_RT_SPEC_LEN - 1, str);
+  cls  = buf;
+  prio = strchr(cls, ':');
+  cpus = NULL;
+  if (prio)
+  {
+    *prio++ = '\0';
+    if ((cpus = strchr(prio, ':')) != NULL) *cpus++ = '\0';
+  }
+  for (pspec->cls = RF_RT_CLASS_FIFO; pspec->cls <= RF_RT_CLASS_OTHER;
+       pspec->cls++)
+    if (!strcmp(cls, rfRtClassName[pspec->cls])) break;
+  if (pspec->cls > RF_RT_CLASS_OTHER) return RF_RT_ERROR;
+  if (pspec->cls != RF_RT_CLASS_OTHER)
+  {
+    if (!prio || !*prio) return RF_RT_ERROR;
+    pspec->prio = (int)strtol(prio, &end, 10);
+    if (*end || (pspec->prio < 1) || (pspec->prio > 99)) return RF_RT_ERROR;
+  }
+  for (next = cpus; next && *next; )
+  {
+    lo = strtol(next, &end, 10);
+    hi = lo;
+    if (end == next) return RF_RT_ERROR;
+    if (*end == '-')
+    {
+      next = end + 1;
+      hi   = strtol(next, &end, 10);
+      if (end == next) return RF_RT_ERROR;
+    }
+    if ((lo < 0) || (hi < lo) || (hi >= RF_RT_MAX_CPUS)) return RF_RT_ERROR;
+    for (; lo <= hi; lo++)
+      if (!pspec->cpus[lo]) { pspec->cpus[lo] = 1; pspec->ncpu++; }
+    if (*end == '+') end++;
+    else if (*end)   return RF_RT_ERROR;
+    next = end;
+  }
+  return RF_RT_OK;
+}
+
+/*
+ * Fills in status, returns RF_RT_ERROR if anything was refused.
+ */
+static int rfRtApply(const rfRtSpec *pspec, char *status)
+{
+#ifdef __linux__
+  struct sched_param param;
+  cpu_set_t          set;
+  int                policy, err, cpu;
+
+  policy = (pspec->cls == RF_RT_CLASS_FIFO) ? SCHED_FIFO :
+           (pspec->cls == RF_RT_CLASS_RR)   ? SCHED_RR   : SCHED_OTHER;
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = (policy == SCHED_OTHER) ? 0 : pspec->prio;
+  if ((err = pthread_setschedparam(pthread_self(), policy, &param)) != 0)
+  {
+    sprintf(status, "class: %.*s", RF_RT_STATUS_LEN - 8, strerror(err));
+    return RF_RT_ERROR;
+  }
+  if (pspec->ncpu)
+  {
+    CPU_ZERO(&set);
+    for (cpu = 0; cpu < RF_RT_MAX_CPUS; cpu++)
+      if (pspec->cpus[cpu]) CPU_SET(cpu, &set);
+    if ((err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)))
+    {
+      sprintf(status, "cpus: %.*s", RF_RT_STATUS_LEN - 7, strerror(err));
+      return RF_RT_ERROR;
+    }
+  }
+  strcpy(status, "set");
+  return RF_RT_OK;
+#else
+  strcpy(status, "not supported on this target");
+  return RF_RT_OK;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Locks current and future pages of the IOC.
+ */
+int rfRtLock(void)
+{
+#ifdef __linux__
+  if (mlockall(MCL_CURRENT | MCL_FUTURE))
+  {
+    epicsPrintf("rfRtLock: mlockall failed: %s\n", strerror(errno));
+    return RF_RT_ERROR;
+  }
+  rfRtLocked = 1;
+  return RF_RT_OK;
+#else
+  epicsPrintf("rfRtLock: not supported on this target\n");
+  return RF_RT_ERROR;
+#endif
+}
+
+/*
+ * Call from the first state of the state set named ss.
+ */
+int rfRtSetup(void *ssId, const char *ss)
+{
+  rfRtSet    *pr;
+  rfRtSpec    spec;
+  char        macro[RF_RT_NAME_LEN + 4];
+  char       *value, *stn;
+  int         status;
+
+  if (!ssId || !ss) return RF_RT_ERROR;
+  sprintf(macro, "RT_%.*s", RF_RT_NAME_LEN - 1, ss);
+  if (!(value = seq_macValueGet((SS_ID)ssId, macro)))
+    value = seq_macValueGet((SS_ID)ssId, "RT");
+  if (!value) return RF_RT_OK;
+  epicsThreadOnce(&rfRtOnce, rfRtInit, NULL);
+  epicsMutexMustLock(rfRtLockId);
+  if (rfRtNset >= RF_RT_MAX_SETS)
+  {
+    epicsMutexUnlock(rfRtLockId);
+    epicsPrintf("rfRtSetup: No room for %s\n", ss);
+    return RF_RT_ERROR;
+  }
+  pr = &rfRtTable[rfRtNset++];
+  epicsMutexUnlock(rfRtLockId);
+  stn = seq_macValueGet((SS_ID)ssId, "STN");
+  sprintf(pr->name, "%.*s:%.*s", 15, stn ? stn : "", RF_RT_NAME_LEN - 17, ss);
+  sprintf(pr->thread, "%.*s", RF_RT_NAME_LEN - 1, epicsThreadGetNameSelf());
+  sprintf(pr->spec, "%.*s", RF_RT_SPEC_LEN - 1, value);
+  if (rfRtParse(value, &spec) != RF_RT_OK)
+  {
+    strcpy(pr->status, "bad RT macro");
+    status = RF_RT_ERROR;
+  }
+  else status = rfRtApply(&spec, pr->status);
+  pr->ok = (status == RF_RT_OK);
+  if (!pr->ok)
+    epicsPrintf("rfRtSetup: %s %s: %s\n", pr->name, pr->spec, pr->status);
+  return status;
+}
+
+void rfRtReport(int level)
+{
+  rfRtSet    *pr;
+  int         i;
+
+  printf("Memory %slocked, %d state sets with an RT macro\n",
+         rfRtLocked ? "" : "not ", rfRtNset);
+  for (i = 0; i < rfRtNset; i++)
+  {
+    pr = &rfRtTable[i];
+    if ((level > 0) || !pr->ok)
+      printf("  %-28s %-16s %-20s %s\n", pr->name, pr->thread, pr->spec,
+             pr->status);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshFuncDef rfRtLockDef = {"rfRtLock", 0, NULL};
+static void rfRtLockCall(const iocshArgBuf *args)
+{
+  rfRtLock();
+}
+
+static const iocshArg rfRtReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfRtReportArgs[] = {&rfRtReportArg0};
+static const iocshFuncDef rfRtReportDef = {"rfRtReport", 1, rfRtReportArgs};
+static void rfRtReportCall(const iocshArgBuf *args)
+{
+  rfRtReport(args[0].ival);
+}
+
+static void rfRtRegistrar(void)
+{
+  iocshRegister(&rfRtLockDef,   rfRtLockCall);
+  iocshRegister(&rfRtReportDef, rfRtReportCall);
+}
+epicsExportRegistrar(rfRtRegistrar);
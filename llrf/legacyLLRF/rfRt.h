@@ -0,0 +1,47 @@
+/*=============================================================================
+
+  Abs:  Real-Time Scheduling of State Sets
+
+  Name: rfRt.h
+
+  Prev: None
+
+  Rem:  Each state set calls rfRtSetup once, from its first state, with
+        its name.  The scheduling class, priority and CPUs of the state
+        set's thread come from the program macros RT_<state set> or RT.
+        rfRtLock locks the IOC in memory; call it before iocInit.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_RT_H
+#define RF_RT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_RT_OK              0
+#define RF_RT_ERROR         (-1)
+
+#define RF_RT_MAX_SETS        48    /* # state sets per IOC                */
+#define RF_RT_NAME_LEN        40    /* state set name incl. station        */
+#define RF_RT_SPEC_LEN        40    /* RT macro value                      */
+
+/* IOC shell */
+int    rfRtLock   (void);
+void   rfRtReport (int level);
+
+/* State sets */
+int    rfRtSetup  (void *ssId, const char *ss);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_RT_H */
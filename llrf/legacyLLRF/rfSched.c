@@ -0,0 +1,283 @@
+/*=============================================================================
+
+  Abs:  Adaptive-Rate Loop Scheduler
+
+  Name: rfSched.c
+         Public:
+           rfSchedEnable  - turn adaptation on or off for all loops
+           rfSchedReport  - print the rate and decision of every loop
+           rfSchedOpen    - find or register a loop
+           rfSchedDue     - is a cycle due on this READY event
+           rfSchedRun     - report the error after a cycle
+           rfSchedGet     - current period, decision and activity
+         Private:
+           rfSchedInit    - create the table lock
+           rfSchedNow     - current time in seconds
+
+  Rem:  The HVPS, DAC and tuner loops used to run on every READY event
+        from the database, and on a fixed MAX_INTERVAL timer when READY
+        stopped.  Their cadence was set by the database, not by how much
+        each loop had to do.
+
+        After each cycle a loop reports its correction (err) and the
+        size of correction that matters to it (scale).  The activity of
+        the cycle is the larger of |err| and the change in err since the
+        last cycle, over scale:
+
+        o activity >= 1, or the loop is not steady (a status other than
+          good, a motor moving, processing, ...): run on every READY.
+        o activity < RF_SCHED_QUIET for RF_SCHED_QUIET_RUNS cycles in a
+          row: double the period, starting from RF_SCHED_MIN_PERIOD,
+          up to the loop's slow heartbeat.
+        o otherwise: hold the period.
+
+        A READY event is skipped while less than the period has passed
+        since the last cycle.  The HVPS and DAC loops keep a timer at
+        the slow period so they still run if READY stops.
+
+        IOC shell:
+          rfSchedEnable(0)        run every loop on every READY again
+          rfSchedReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfSched.h"
+
+#define RF_SCHED_QUIET        0.25   /* activity of a quiet cycle           */
+#define RF_SCHED_QUIET_RUNS   4      /* quiet cycles before backing off     */
+#define RF_SCHED_MIN_PERIOD   1.0    /* first backed off period (sec.)      */
+#define RF_SCHED_SLACK        0.1    /* READY jitter allowed (sec.)         */
+
+typedef struct
+{
+  char          name[RF_SCHED_NAME_LEN];
+  double        slow;        /* heartbeat period                          */
+  double        period;      /* current period, 0 is every READY          */
+  double        last;        /* time of the last cycle                    */
+  double        err;         /* error reported by the last cycle          */
+  double        activity;    /* activity of the last cycle                */
+  int           decision;
+  int           quiet;       /* # quiet cycles in a row                   */
+  unsigned long runs;
+  unsigned long skips;
+} rfSchedLoop;
+
+static rfSchedLoop  *rfSchedTable[RF_SCHED_MAX_LOOPS];
+static int           rfSchedCount   = 0;
+static int           rfSchedEnabled = 1;
+static epicsMutexId  rfSchedTableLock = NULL;
+static epicsThreadOnceId rfSchedOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfSchedInit(void *arg)
+{
+  rfSchedTableLock = epicsMutexMustCreate();
+}
+
+static double rfSchedNow(void)
+{
+  epicsTimeStamp now;
+
+  epicsTimeGetCurrent(&now);
+  return now.secPastEpoch + now.nsec * 1e-9;
+}
+
+static rfSchedLoop *rfSchedGetLoop(int id)
+{
+  if ((id < 0) || (id >= rfSchedCount)) return NULL;
+  return rfSchedTable[id];
+}
+
+/*----------------------------------------------------------------------------*/
+
+void rfSchedEnable(int enable)
+{
+  rfSchedEnabled = enable;
+}
+
+int rfSchedOpen(const char *stn, const char *name, double slow)
+{
+  rfSchedLoop *pl;
+  char         full[RF_SCHED_NAME_LEN];
+  int          id;
+
+  if (!name) return RF_SCHED_ERROR;
+  if (stn && *stn) sprintf(full, "%.*s:%.*s", 8, stn,
+                           RF_SCHED_NAME_LEN - 10, name);
+  else             sprintf(full, "%.*s", RF_SCHED_NAME_LEN - 1, name);
+  epicsThreadOnce(&rfSchedOnce, rfSchedInit, NULL);
+  epicsMutexMustLock(rfSchedTableLock);
+  for (id = 0; id < rfSchedCount; id++)
+    if (!strcmp(full, rfSchedTable[id]->name)) break;
+  if (id == rfSchedCount)
+  {
+    pl = NULL;
+    if (rfSchedCount < RF_SCHED_MAX_LOOPS)
+      pl = (rfSchedLoop *)calloc(1, sizeof(*pl));
+    if (pl)
+    {
+      strcpy(pl->name, full);
+      rfSchedTable[rfSchedCount++] = pl;
+    }
+    else
+    {
+      epicsPrintf("rfSchedOpen: No room for loop %s\n", full);
+      id = RF_SCHED_ERROR;
+    }
+  }
+  if (id != RF_SCHED_ERROR)
+  {
+    pl = rfSchedTable[id];
+    pl->slow     = (slow > RF_SCHED_MIN_PERIOD) ? slow : RF_SCHED_MIN_PERIOD;
+    pl->period   = 0.0;
+    pl->decision = RF_SCHED_FAST;
+    pl->quiet    = 0;
+  }
+  epicsMutexUnlock(rfSchedTableLock);
+  return id;
+}
+
+/*
+ * Called on each READY event.  Returns 1 if the loop should run now.
+ * An unknown id always runs so a failed open leaves the loop as it was.
+ */
+int rfSchedDue(int id)
+{
+  rfSchedLoop *pl = rfSchedGetLoop(id);
+
+  if (!pl || !rfSchedEnabled || (pl->period <= 0.0)) return 1;
+  if (rfSchedNow() - pl->last >= pl->period - RF_SCHED_SLACK) return 1;
+  pl->skips++;
+  return 0;
+}
+
+/*
+ * Report the error left by a cycle.  A scale <= 0 or !steady keeps the
+ * loop on every READY.  Returns 1 if the period or decision changed.
+ */
+int rfSchedRun(int id, double err, double scale, int steady)
+{
+  rfSchedLoop *pl = rfSchedGetLoop(id);
+  double       period;
+  int          decision;
+
+  if (!pl) return 0;
+  period   = pl->period;
+  decision = pl->decision;
+  pl->last = rfSchedNow();
+  pl->runs++;
+  if (scale > 0.0)
+  {
+    pl->activity = fabs(err - pl->err);
+    if (fabs(err) > pl->activity) pl->activity = fabs(err);
+    pl->activity /= scale;
+  }
+  else
+  {
+    pl->activity = 1.0;
+  }
+  pl->err = err;
+
+  if (!rfSchedEnabled || !steady || (pl->activity >= 1.0))
+  {
+    pl->quiet    = 0;
+    pl->period   = 0.0;
+    pl->decision = RF_SCHED_FAST;
+  }
+  else if (pl->activity < RF_SCHED_QUIET)
+  {
+    if (++pl->quiet >= RF_SCHED_QUIET_RUNS)
+    {
+      pl->quiet  = 0;
+      pl->period = (pl->period < RF_SCHED_MIN_PERIOD) ?
+                   RF_SCHED_MIN_PERIOD : 2.0 * pl->period;
+      if (pl->period >= pl->slow) pl->period = pl->slow;
+      pl->decision = (pl->period >= pl->slow) ?
+                     RF_SCHED_IDLE : RF_SCHED_SLOWING;
+    }
+  }
+  else
+  {
+    pl->quiet    = 0;
+    pl->decision = RF_SCHED_HOLD;
+  }
+  return (period != pl->period) || (decision != pl->decision);
+}
+
+int rfSchedGet(int id, float *period, int *decision, float *activity)
+{
+  rfSchedLoop *pl = rfSchedGetLoop(id);
+
+  if (!pl) return RF_SCHED_ERROR;
+  *period   = (float)pl->period;
+  *decision = pl->decision;
+  *activity = (float)pl->activity;
+  return RF_SCHED_OK;
+}
+
+void rfSchedReport(int level)
+{
+  static const char *decisionName[] = {"FAST", "HOLD", "SLOWING", "IDLE"};
+  rfSchedLoop       *pl;
+  int                i;
+
+  printf("%d loops, adaptation %s\n", rfSchedCount,
+         rfSchedEnabled ? "enabled" : "disabled");
+  for (i = 0; i < rfSchedCount; i++)
+  {
+    pl = rfSchedTable[i];
+    printf("%-32s %-7s period %5.1f/%5.1f sec activity %6.3f\n",
+           pl->name, decisionName[pl->decision], pl->period, pl->slow,
+           pl->activity);
+    if (level > 0)
+      printf("%32s %8lu runs %8lu READYs skipped\n", "", pl->runs,
+             pl->skips);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfSchedEnableArg0 = {"enable", iocshArgInt};
+static const iocshArg *rfSchedEnableArgs[] = {&rfSchedEnableArg0};
+static const iocshFuncDef rfSchedEnableDef =
+  {"rfSchedEnable", 1, rfSchedEnableArgs};
+static void rfSchedEnableCall(const iocshArgBuf *args)
+{
+  rfSchedEnable(args[0].ival);
+}
+
+static const iocshArg rfSchedReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfSchedReportArgs[] = {&rfSchedReportArg0};
+static const iocshFuncDef rfSchedReportDef =
+  {"rfSchedReport", 1, rfSchedReportArgs};
+static void rfSchedReportCall(const iocshArgBuf *args)
+{
+  rfSchedReport(args[0].ival);
+}
+
+static void rfSchedRegistrar(void)
+{
+  iocshRegister(&rfSchedEnableDef, rfSchedEnableCall);
+  iocshRegister(&rfSchedReportDef, rfSchedReportCall);
+}
+epicsExportRegistrar(rfSchedRegistrar);
@@ -0,0 +1,55 @@
+/*=============================================================================
+
+  Abs:  Adaptive-Rate Loop Scheduler
+
+  Name: rfSched.h
+
+  Prev: None
+
+  Rem:  Each loop registers once and then asks, on every READY event,
+        whether this cycle is due.  After a cycle it reports its error;
+        the scheduler runs the loop on every READY while the error is
+        large or moving and backs off to a slow heartbeat when quiet.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_SCHED_H
+#define RF_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_SCHED_OK           0
+#define RF_SCHED_ERROR      (-1)
+
+#define RF_SCHED_MAX_LOOPS    32     /* # scheduled loops per IOC           */
+#define RF_SCHED_NAME_LEN     40     /* loop name length incl. station      */
+
+/* Decisions, these MUST match the {...}:LOOP:SCHED:DECISION records */
+#define RF_SCHED_FAST         0      /* run on every READY                  */
+#define RF_SCHED_HOLD         1      /* keep the current period             */
+#define RF_SCHED_SLOWING      2      /* quiet - period is backing off       */
+#define RF_SCHED_IDLE         3      /* quiet - running at the heartbeat    */
+
+/* IOC shell */
+void   rfSchedEnable (int enable);
+void   rfSchedReport (int level);
+
+/* Loops */
+int    rfSchedOpen   (const char *stn, const char *name, double slow);
+int    rfSchedDue    (int id);
+int    rfSchedRun    (int id, double err, double scale, int steady);
+int    rfSchedGet    (int id, float *period, int *decision, float *activity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_SCHED_H */
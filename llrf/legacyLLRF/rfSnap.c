@@ -0,0 +1,275 @@
+/*=============================================================================
+
+  Abs:  Station Status Snapshot
+
+  Name: rfSnap.c
+         Public:
+           rfSnapCommit   - publish a section
+           rfSnapCopy     - copy the published snapshot
+           rfSnapFlag     - set an event flag on every commit
+           rfSnapOpen     - open the snapshot of a station
+           rfSnapPut      - stage a word
+           rfSnapPutStamp - stage a time stamp word
+           rfSnapReport   - print every snapshot
+         Private:
+           rfSnapInit     - create the table lock
+           rfSnapGetStn   - station of an id
+           rfSnapNow      - current POSIX time in seconds
+           rfSnapSection  - first word and length of a section
+
+  Rem:  A display of one station subscribes to dozens of scalar status
+        PVs, and every alarm client and panel does the same for every
+        station, which is more monitors than the CA gateway can carry.
+        The loops now also stage their states, status codes, setpoints
+        and counters here, and rf_snap publishes all of them as one
+        waveform, {STN}:STN:SNAP, whose layout is in rfSnap.h.
+
+        Each writer owns a section.  It stages words with rfSnapPut as
+        it goes and calls rfSnapCommit at the end of a cycle, which
+        copies the whole section into the published snapshot at once and
+        stamps it, so a client never sees half a cycle of one loop.
+        rfSnapCopy takes the published snapshot under the same lock.
+
+        IOC shell:
+          rfSnapReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <seqCom.h>          /* seq_efSet prototype                 */
+#include <epicsExport.h>
+
+#include "rfSnap.h"
+
+#define RF_SNAP_STN_NAME_LEN  16
+
+typedef struct
+{
+  char          stn[RF_SNAP_STN_NAME_LEN];
+  epicsMutexId  lock;
+  double        staged[RF_SNAP_LEN];
+  double        snap[RF_SNAP_LEN];
+  unsigned long commits[RF_SNAP_NSECS];
+  unsigned long copies;
+  void         *ssId;        /* publisher to notify, or NULL              */
+  int           ef;
+} rfSnapStn;
+
+static rfSnapStn    *rfSnapTable[RF_SNAP_MAX_STATIONS];
+static int           rfSnapCount     = 0;
+static epicsMutexId  rfSnapTableLock = NULL;
+static epicsThreadOnceId rfSnapOnce = EPICS_THREAD_ONCE_INIT;
+
+static const char   *rfSnapSecName[RF_SNAP_NSECS] =
+  {"STN", "HVPS", "DAC", "TUNR1", "TUNR2", "TUNR3", "TUNR4"};
+
+/*----------------------------------------------------------------------------*/
+
+static void rfSnapInit(void *arg)
+{
+  rfSnapTableLock = epicsMutexMustCreate();
+}
+
+static double rfSnapNow(void)
+{
+  epicsTimeStamp now;
+
+  epicsTimeGetCurrent(&now);
+  return now.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH + now.nsec * 1e-9;
+}
+
+static rfSnapStn *rfSnapGetStn(int id)
+{
+  if ((id < 0) || (id >= rfSnapCount)) return NULL;
+  return rfSnapTable[id];
+}
+
+static int rfSnapSection(int sec, int *first, int *len)
+{
+  if (sec == RF_SNAP_SEC_STN)
+  {
+    *first = RF_SNAP_STN;
+    *len   = RF_SNAP_STN_LEN;
+  }
+  else if (sec == RF_SNAP_SEC_HVPS)
+  {
+    *first = RF_SNAP_HVPS;
+    *len   = RF_SNAP_HVPS_LEN;
+  }
+  else if (sec == RF_SNAP_SEC_DAC)
+  {
+    *first = RF_SNAP_DAC;
+    *len   = RF_SNAP_DAC_LEN;
+  }
+  else if ((sec >= RF_SNAP_SEC_TUNR(0)) && (sec < RF_SNAP_NSECS))
+  {
+    *first = RF_SNAP_TUNR(sec - RF_SNAP_SEC_TUNR(0));
+    *len   = RF_SNAP_TUNR_LEN;
+  }
+  else return RF_SNAP_ERROR;
+  return RF_SNAP_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfSnapOpen(const char *stn)
+{
+  rfSnapStn *ps;
+  int        id;
+
+  if (!stn) stn = "";
+  epicsThreadOnce(&rfSnapOnce, rfSnapInit, NULL);
+  epicsMutexMustLock(rfSnapTableLock);
+  for (id = 0; id < rfSnapCount; id++)
+    if (!strncmp(stn, rfSnapTable[id]->stn, RF_SNAP_STN_NAME_LEN - 1)) break;
+  if (id == rfSnapCount)
+  {
+    ps = NULL;
+    if (rfSnapCount < RF_SNAP_MAX_STATIONS)
+      ps = (rfSnapStn *)calloc(1, sizeof(*ps));
+    if (ps)
+    {
+      sprintf(ps->stn, "%.*s", RF_SNAP_STN_NAME_LEN - 1, stn);
+      ps->lock = epicsMutexMustCreate();
+      ps->snap[RF_SNAP_HDR_VERSION] = RF_SNAP_VERSION;
+      ps->snap[RF_SNAP_HDR_LEN]     = RF_SNAP_LEN;
+      rfSnapTable[rfSnapCount++] = ps;
+    }
+    else
+    {
+      epicsPrintf("rfSnapOpen: No room for station %s\n", stn);
+      id = RF_SNAP_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfSnapTableLock);
+  return id;
+}
+
+int rfSnapPut(int id, int word, double value)
+{
+  rfSnapStn *ps = rfSnapGetStn(id);
+
+  if (!ps || (word < RF_SNAP_HDR_WORDS) || (word >= RF_SNAP_LEN))
+    return RF_SNAP_ERROR;
+  epicsMutexMustLock(ps->lock);
+  ps->staged[word] = value;
+  epicsMutexUnlock(ps->lock);
+  return RF_SNAP_OK;
+}
+
+/*
+ * Takes the two halves of an epicsTimeStamp.
+ */
+int rfSnapPutStamp(int id, int word, unsigned long secPastEpoch,
+                   unsigned long nsec)
+{
+  return rfSnapPut(id, word, secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH +
+                             nsec * 1e-9);
+}
+
+int rfSnapCommit(int id, int sec)
+{
+  rfSnapStn *ps = rfSnapGetStn(id);
+  double     now;
+  int        first, len;
+
+  if (!ps || (rfSnapSection(sec, &first, &len) != RF_SNAP_OK))
+    return RF_SNAP_ERROR;
+  now = rfSnapNow();
+  epicsMutexMustLock(ps->lock);
+  memcpy(&ps->snap[first + 1], &ps->staged[first + 1],
+         (len - 1) * sizeof(double));
+  ps->snap[first]            = now;
+  ps->snap[RF_SNAP_HDR_SEQ] += 1.0;
+  ps->snap[RF_SNAP_HDR_TIME] = now;
+  ps->commits[sec]++;
+  if (ps->ssId) seq_efSet((SS_ID)ps->ssId, ps->ef);
+  epicsMutexUnlock(ps->lock);
+  return RF_SNAP_OK;
+}
+
+int rfSnapFlag(int id, void *ssId, int ef)
+{
+  rfSnapStn *ps = rfSnapGetStn(id);
+
+  if (!ps) return RF_SNAP_ERROR;
+  epicsMutexMustLock(ps->lock);
+  ps->ssId = ssId;
+  ps->ef   = ef;
+  epicsMutexUnlock(ps->lock);
+  return RF_SNAP_OK;
+}
+
+/*
+ * Copies at most n words; the rest of wf is left alone.
+ */
+int rfSnapCopy(int id, double *wf, int n)
+{
+  rfSnapStn *ps = rfSnapGetStn(id);
+
+  if (!ps || !wf || (n <= 0)) return RF_SNAP_ERROR;
+  if (n > RF_SNAP_LEN) n = RF_SNAP_LEN;
+  epicsMutexMustLock(ps->lock);
+  memcpy(wf, ps->snap, n * sizeof(double));
+  ps->copies++;
+  epicsMutexUnlock(ps->lock);
+  return RF_SNAP_OK;
+}
+
+void rfSnapReport(int level)
+{
+  rfSnapStn *ps;
+  double     now = rfSnapNow();
+  int        i, sec, first, len;
+
+  printf("%d station snapshots, version %d, %d words\n", rfSnapCount,
+         RF_SNAP_VERSION, RF_SNAP_LEN);
+  for (i = 0; i < rfSnapCount; i++)
+  {
+    ps = rfSnapTable[i];
+    epicsMutexMustLock(ps->lock);
+    printf("  %-8s %10.0f updates %10lu copies\n", ps->stn,
+           ps->snap[RF_SNAP_HDR_SEQ], ps->copies);
+    if (level > 0)
+      for (sec = 0; sec < RF_SNAP_NSECS; sec++)
+      {
+        rfSnapSection(sec, &first, &len);
+        if (ps->commits[sec])
+          printf("    %-6s %10lu commits, last %.1f s ago\n",
+                 rfSnapSecName[sec], ps->commits[sec], now - ps->snap[first]);
+      }
+    epicsMutexUnlock(ps->lock);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfSnapReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfSnapReportArgs[] = {&rfSnapReportArg0};
+static const iocshFuncDef rfSnapReportDef =
+  {"rfSnapReport", 1, rfSnapReportArgs};
+static void rfSnapReportCall(const iocshArgBuf *args)
+{
+  rfSnapReport(args[0].ival);
+}
+
+static void rfSnapRegistrar(void)
+{
+  iocshRegister(&rfSnapReportDef, rfSnapReportCall);
+}
+epicsExportRegistrar(rfSnapRegistrar);
@@ -0,0 +1,130 @@
+/*=============================================================================
+
+  Abs:  Station Status Snapshot
+
+  Name: rfSnap.h
+
+  Prev: None
+
+  Rem:  Layout of the {STN}:STN:SNAP waveform and the calls the loops
+        use to fill it.  The waveform is an array of RF_SNAP_LEN doubles:
+        a header, then one section per writer.  The first word of every
+        section is the time of its last update, 0 if it has never been
+        updated.  Times are POSIX seconds.  Codes are those of the
+        status PVs they stand for ({STN}:HVPS:LOOP:STATUS, ...).
+
+        The layout only ever grows at the end.  A change to the meaning
+        of a word, or a word removed, bumps RF_SNAP_VERSION; clients
+        check the version and the length in the header (rfSnapDecode.h).
+
+        This header is shared by the IOC and by clients, so it uses no
+        EPICS types.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_SNAP_H
+#define RF_SNAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_SNAP_OK              0
+#define RF_SNAP_ERROR         (-1)
+
+#define RF_SNAP_VERSION         1
+#define RF_SNAP_MAX_STATIONS    4     /* # snapshots per IOC                 */
+#define RF_SNAP_MAX_CAVS        4     /* # tuner loops per station           */
+#define RF_SNAP_NFAULTS         15    /* # fault times, as FAULT:TIME1..15   */
+
+/* Header */
+#define RF_SNAP_HDR_VERSION     0     /* RF_SNAP_VERSION                     */
+#define RF_SNAP_HDR_LEN         1     /* # words in use                      */
+#define RF_SNAP_HDR_SEQ         2     /* update count                        */
+#define RF_SNAP_HDR_TIME        3     /* time of the last update             */
+#define RF_SNAP_HDR_WORDS       4
+
+/* Station, from rf_snap and rf_states */
+#define RF_SNAP_STN             RF_SNAP_HDR_WORDS
+#define RF_SNAP_STN_TIME        (RF_SNAP_STN + 0)
+#define RF_SNAP_STN_STATE       (RF_SNAP_STN + 1)   /* STN:STATE:RBCK        */
+#define RF_SNAP_STN_CTRL        (RF_SNAP_STN + 2)   /* STN:STATE:CTRL        */
+#define RF_SNAP_STN_RESET       (RF_SNAP_STN + 3)   /* STN:RESET:COUNTER     */
+#define RF_SNAP_STN_FAULT_NUM   (RF_SNAP_STN + 4)   /* STN:FAULT:NUM         */
+#define RF_SNAP_STN_FAULT_ANUM  (RF_SNAP_STN + 5)   /* STN:FAULT:ANUM        */
+#define RF_SNAP_STN_FAULT_TIME(i) (RF_SNAP_STN + 6 + (i)) /* FAULT:TIME<i+1> */
+#define RF_SNAP_STN_LEN         (6 + RF_SNAP_NFAULTS)
+
+/* HVPS loop, from rf_hvps_loop */
+#define RF_SNAP_HVPS            (RF_SNAP_STN + RF_SNAP_STN_LEN)
+#define RF_SNAP_HVPS_TIME       (RF_SNAP_HVPS + 0)
+#define RF_SNAP_HVPS_STATE      (RF_SNAP_HVPS + 1)  /* HVPS:LOOP:STATE       */
+#define RF_SNAP_HVPS_STATUS     (RF_SNAP_HVPS + 2)  /* HVPS:LOOP:STATUS      */
+#define RF_SNAP_HVPS_CTRL       (RF_SNAP_HVPS + 3)  /* HVPS:LOOP:CTRL        */
+#define RF_SNAP_HVPS_VOLT_CTRL  (RF_SNAP_HVPS + 4)  /* HVPS:VOLT:CTRL        */
+#define RF_SNAP_HVPS_VOLT       (RF_SNAP_HVPS + 5)  /* HVPS:VOLT             */
+#define RF_SNAP_HVPS_VOLT_TOL   (RF_SNAP_HVPS + 6)  /* # cycles out of tol.  */
+#define RF_SNAP_HVPS_CAVV_LIM   (RF_SNAP_HVPS + 7)  /* # cycles at gap limit */
+#define RF_SNAP_HVPS_PERIOD     (RF_SNAP_HVPS + 8)  /* scheduler period      */
+#define RF_SNAP_HVPS_LEN        9
+
+/* DAC loop, from rf_dac_loop */
+#define RF_SNAP_DAC             (RF_SNAP_HVPS + RF_SNAP_HVPS_LEN)
+#define RF_SNAP_DAC_TIME        (RF_SNAP_DAC + 0)
+#define RF_SNAP_DAC_STATUS      (RF_SNAP_DAC + 1)   /* STNDAC:LOOP:STATUS    */
+#define RF_SNAP_DAC_TUNE_IQ     (RF_SNAP_DAC + 2)   /* STN:TUNE:IQ.A         */
+#define RF_SNAP_DAC_ON_IQ       (RF_SNAP_DAC + 3)   /* STN:ON:IQ.A           */
+#define RF_SNAP_DAC_GFF_IQ      (RF_SNAP_DAC + 4)   /* STN:GFF:IQ.A          */
+#define RF_SNAP_DAC_TUNE_CTRL   (RF_SNAP_DAC + 5)   /* tune control          */
+#define RF_SNAP_DAC_ON_CTRL     (RF_SNAP_DAC + 6)   /* on_cw control         */
+#define RF_SNAP_DAC_DIRECT      (RF_SNAP_DAC + 7)   /* direct loop control   */
+#define RF_SNAP_DAC_PERIOD      (RF_SNAP_DAC + 8)   /* scheduler period      */
+#define RF_SNAP_DAC_LEN         9
+
+/* Tuner loops, cav 0 is CAV1, from rf_tuner_loop */
+#define RF_SNAP_TUNR_BASE       (RF_SNAP_DAC + RF_SNAP_DAC_LEN)
+#define RF_SNAP_TUNR(cav)       (RF_SNAP_TUNR_BASE + (cav) * RF_SNAP_TUNR_LEN)
+#define RF_SNAP_TUNR_TIME       0     /* offsets from RF_SNAP_TUNR(cav)      */
+#define RF_SNAP_TUNR_STATE      1     /* CAV{CAV}TUNR:LOOP:STATE             */
+#define RF_SNAP_TUNR_STATUS     2     /* CAV{CAV}TUNR:LOOP:STATUS            */
+#define RF_SNAP_TUNR_CTRL       3     /* CAVTUNR:LOOP:CTRL                   */
+#define RF_SNAP_TUNR_POSN_CTRL  4     /* CAV{CAV}TUNR:POSN:CTRL              */
+#define RF_SNAP_TUNR_POSN       5     /* stepper motor readback              */
+#define RF_SNAP_TUNR_NOMOV      6     /* # cycles stuck moving               */
+#define RF_SNAP_TUNR_PERIOD     7     /* scheduler period                    */
+#define RF_SNAP_TUNR_LEN        8
+
+#define RF_SNAP_LEN             RF_SNAP_TUNR(RF_SNAP_MAX_CAVS)
+
+/* Sections, each committed as a whole */
+#define RF_SNAP_SEC_STN         0
+#define RF_SNAP_SEC_HVPS        1
+#define RF_SNAP_SEC_DAC         2
+#define RF_SNAP_SEC_TUNR(cav)   (3 + (cav))
+#define RF_SNAP_NSECS           RF_SNAP_SEC_TUNR(RF_SNAP_MAX_CAVS)
+
+/* IOC shell */
+void   rfSnapReport   (int level);
+
+/* Writers */
+int    rfSnapOpen     (const char *stn);
+int    rfSnapPut      (int id, int word, double value);
+int    rfSnapPutStamp (int id, int word, unsigned long secPastEpoch,
+                       unsigned long nsec);
+int    rfSnapCommit   (int id, int sec);
+
+/* Publisher */
+int    rfSnapFlag     (int id, void *ssId, int ef);
+int    rfSnapCopy     (int id, double *wf, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_SNAP_H */
@@ -0,0 +1,170 @@
+/*=============================================================================
+
+  Abs:  Station Status Snapshot Decoding
+
+  Name: rfSnapDecode.c
+         Public:
+           rfSnapDecode         - unpack a snapshot waveform
+           rfSnapDacStatusName  - DAC loop status string
+           rfSnapHvpsStatusName - HVPS loop status string
+           rfSnapStnStateName   - station state name
+           rfSnapTunrStatusName - tuner loop status string
+
+  Rem:  Host library for clients of {STN}:STN:SNAP.  The status strings
+        are those the loops write next to their status codes, taken from
+        the loop definition headers so the two cannot drift apart.  The
+        station state names are matched to the STATION_* codes of
+        rf_station_state.h (in the db area, on USR_INCLUDES) one by one,
+        so nothing depends on the codes being contiguous.  Only plain
+        definition headers are included; no EPICS headers or libraries.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <string.h>
+
+#include "rf_station_state.h"
+#include "rf_hvps_loop_defs.h"
+#include "rf_dac_loop_defs.h"
+#include "rf_tuner_loop_defs.h"
+#include "rfSnapDecode.h"
+
+#define RF_SNAP_NAME(table, i) \
+  ((((i) >= 0) && ((i) < (int)(sizeof(table) / sizeof(table[0])))) ? \
+   table[i] : table[0])
+
+static const char *rfSnapHvpsStatus[] =
+{
+  HVPS_LOOP_STATUS_UNKNOWN_C,   HVPS_LOOP_STATUS_GOOD_C,
+  HVPS_LOOP_STATUS_RFP_BAD_C,   HVPS_LOOP_STATUS_CAVV_LIM_C,
+  HVPS_LOOP_STATUS_OFF_C,       HVPS_LOOP_STATUS_VACM_BAD_C,
+  HVPS_LOOP_STATUS_POWR_BAD_C,  HVPS_LOOP_STATUS_GAPV_BAD_C,
+  HVPS_LOOP_STATUS_GAPV_TOL_C,  HVPS_LOOP_STATUS_VOLT_LIM_C,
+  HVPS_LOOP_STATUS_STN_OFF_C,   HVPS_LOOP_STATUS_VOLT_TOL_C,
+  HVPS_LOOP_STATUS_VOLT_BAD_C,  HVPS_LOOP_STATUS_DRIV_BAD_C,
+  HVPS_LOOP_STATUS_ON_FM_C,     HVPS_LOOP_STATUS_DRIV_TOL_C
+};
+
+static const char *rfSnapDacStatus[] =
+{
+  DAC_LOOP_STATUS_UNKNOWN_C,    DAC_LOOP_STATUS_TUNE_C,
+  DAC_LOOP_STATUS_ON_C,         DAC_LOOP_STATUS_TUNE_OFF_C,
+  DAC_LOOP_STATUS_ON_OFF_C,     DAC_LOOP_STATUS_DRIV_BAD_C,
+  DAC_LOOP_STATUS_GAPV_BAD_C,   DAC_LOOP_STATUS_CTRL_C,
+  DAC_LOOP_STATUS_STN_OFF_C,    DAC_LOOP_STATUS_RFP_BAD_C,
+  DAC_LOOP_STATUS_DAC_LIMT_C,   DAC_LOOP_STATUS_GVF_BAD_C,
+  DAC_LOOP_STATUS_DRIV_HIGH_C,  DAC_LOOP_STATUS_DRIV_TOL_C,
+  DAC_LOOP_STATUS_GAPV_TOL_C
+};
+
+static const char *rfSnapTunrStatus[] =
+{
+  LOOP_UNKNOWN_STRING,  LOOP_OFF_STRING,      LOOP_STN_OFF_STRING,
+  LOOP_GOOD_STRING,     LOOP_ON_FM_STRING,    LOOP_SM_CTRL_STRING,
+  LOOP_SM_LIMIT_STRING, LOOP_SM_BAD_STRING,   LOOP_DRV_LIMT_STRING,
+  LOOP_SM_MOVE_STRING,  LOOP_PHAS_BAD_STRING, LOOP_PHASMISS_STRING,
+  LOOP_POWR_LOW_STRING, LOOP_LDANGLIM_STRING
+};
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Returns RF_SNAP_ERROR, leaving *pd alone, if the waveform is of another
+ * version or shorter than this layout.  A longer one is from a later
+ * layout of the same version and its extra words are ignored.
+ */
+int rfSnapDecode(const double *wf, int n, rfSnapData *pd)
+{
+  const double *pw;
+  int           cav, i;
+
+  if (!wf || !pd || (n < RF_SNAP_LEN)) return RF_SNAP_ERROR;
+  if (((int)wf[RF_SNAP_HDR_VERSION] != RF_SNAP_VERSION) ||
+      ((int)wf[RF_SNAP_HDR_LEN] < RF_SNAP_LEN))
+    return RF_SNAP_ERROR;
+
+  memset(pd, 0, sizeof(*pd));
+  pd->version        = (int)wf[RF_SNAP_HDR_VERSION];
+  pd->seq            = wf[RF_SNAP_HDR_SEQ];
+  pd->time           = wf[RF_SNAP_HDR_TIME];
+
+  pd->stn.time       = wf[RF_SNAP_STN_TIME];
+  pd->stn.state      = (int)wf[RF_SNAP_STN_STATE];
+  pd->stn.ctrl       = (int)wf[RF_SNAP_STN_CTRL];
+  pd->stn.reset      = (int)wf[RF_SNAP_STN_RESET];
+  pd->stn.faultNum   = (int)wf[RF_SNAP_STN_FAULT_NUM];
+  pd->stn.faultAnum  = (int)wf[RF_SNAP_STN_FAULT_ANUM];
+  for (i = 0; i < RF_SNAP_NFAULTS; i++)
+    pd->stn.faultTime[i] = wf[RF_SNAP_STN_FAULT_TIME(i)];
+
+  pd->hvps.time      = wf[RF_SNAP_HVPS_TIME];
+  pd->hvps.state     = (int)wf[RF_SNAP_HVPS_STATE];
+  pd->hvps.status    = (int)wf[RF_SNAP_HVPS_STATUS];
+  pd->hvps.ctrl      = (int)wf[RF_SNAP_HVPS_CTRL];
+  pd->hvps.voltCtrl  = wf[RF_SNAP_HVPS_VOLT_CTRL];
+  pd->hvps.volt      = wf[RF_SNAP_HVPS_VOLT];
+  pd->hvps.voltTol   = (int)wf[RF_SNAP_HVPS_VOLT_TOL];
+  pd->hvps.cavvLim   = (int)wf[RF_SNAP_HVPS_CAVV_LIM];
+  pd->hvps.period    = wf[RF_SNAP_HVPS_PERIOD];
+
+  pd->dac.time       = wf[RF_SNAP_DAC_TIME];
+  pd->dac.status     = (int)wf[RF_SNAP_DAC_STATUS];
+  pd->dac.tuneIq     = wf[RF_SNAP_DAC_TUNE_IQ];
+  pd->dac.onIq       = wf[RF_SNAP_DAC_ON_IQ];
+  pd->dac.gffIq      = wf[RF_SNAP_DAC_GFF_IQ];
+  pd->dac.tuneCtrl   = (int)wf[RF_SNAP_DAC_TUNE_CTRL];
+  pd->dac.onCtrl     = (int)wf[RF_SNAP_DAC_ON_CTRL];
+  pd->dac.direct     = (int)wf[RF_SNAP_DAC_DIRECT];
+  pd->dac.period     = wf[RF_SNAP_DAC_PERIOD];
+
+  for (cav = 0; cav < RF_SNAP_MAX_CAVS; cav++)
+  {
+    pw = &wf[RF_SNAP_TUNR(cav)];
+    pd->tunr[cav].time     = pw[RF_SNAP_TUNR_TIME];
+    pd->tunr[cav].state    = (int)pw[RF_SNAP_TUNR_STATE];
+    pd->tunr[cav].status   = (int)pw[RF_SNAP_TUNR_STATUS];
+    pd->tunr[cav].ctrl     = (int)pw[RF_SNAP_TUNR_CTRL];
+    pd->tunr[cav].posnCtrl = pw[RF_SNAP_TUNR_POSN_CTRL];
+    pd->tunr[cav].posn     = pw[RF_SNAP_TUNR_POSN];
+    pd->tunr[cav].nomov    = (int)pw[RF_SNAP_TUNR_NOMOV];
+    pd->tunr[cav].period   = pw[RF_SNAP_TUNR_PERIOD];
+  }
+  return RF_SNAP_OK;
+}
+
+/*
+ * The name functions return the unknown string for a code out of range.
+ */
+const char *rfSnapStnStateName(int state)
+{
+  switch (state)
+  {
+    case STATION_OFF:   return "OFF";
+    case STATION_PARK:  return "PARK";
+    case STATION_TUNE:  return "TUNE";
+    case STATION_ON_FM: return "ON_FM";
+    case STATION_ON_CW: return "ON_CW";
+    default:            return "UNKNOWN";
+  }
+}
+
+const char *rfSnapHvpsStatusName(int status)
+{
+  return RF_SNAP_NAME(rfSnapHvpsStatus, status);
+}
+
+const char *rfSnapDacStatusName(int status)
+{
+  return RF_SNAP_NAME(rfSnapDacStatus, status);
+}
+
+const char *rfSnapTunrStatusName(int status)
+{
+  return RF_SNAP_NAME(rfSnapTunrStatus, status);
+}
@@ -0,0 +1,104 @@
+/*=============================================================================
+
+  Abs:  Station Status Snapshot Decoding
+
+  Name: rfSnapDecode.h
+
+  Prev: rfSnap.h              (snapshot layout)
+
+  Rem:  For clients of {STN}:STN:SNAP.  rfSnapDecode checks the version
+        and length in the header and unpacks the waveform into named
+        fields; the name functions give the status strings the loops
+        publish with their status codes.  A section whose time is 0 has
+        never been written by its loop.  Links with no EPICS library;
+        builds with only rf_station_state.h from the db area.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_SNAP_DECODE_H
+#define RF_SNAP_DECODE_H
+
+#include "rfSnap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  double  time;              /* POSIX seconds of the last update, 0 never */
+  int     state;
+  int     ctrl;
+  int     reset;
+  int     faultNum;
+  int     faultAnum;
+  double  faultTime[RF_SNAP_NFAULTS];
+} rfSnapStnData;
+
+typedef struct
+{
+  double  time;
+  int     state;
+  int     status;
+  int     ctrl;
+  double  voltCtrl;
+  double  volt;
+  int     voltTol;
+  int     cavvLim;
+  double  period;
+} rfSnapHvpsData;
+
+typedef struct
+{
+  double  time;
+  int     status;
+  double  tuneIq;
+  double  onIq;
+  double  gffIq;
+  int     tuneCtrl;
+  int     onCtrl;
+  int     direct;
+  double  period;
+} rfSnapDacData;
+
+typedef struct
+{
+  double  time;
+  int     state;
+  int     status;
+  int     ctrl;
+  double  posnCtrl;
+  double  posn;
+  int     nomov;
+  double  period;
+} rfSnapTunrData;
+
+typedef struct
+{
+  int            version;
+  double         seq;
+  double         time;
+  rfSnapStnData  stn;
+  rfSnapHvpsData hvps;
+  rfSnapDacData  dac;
+  rfSnapTunrData tunr[RF_SNAP_MAX_CAVS];
+} rfSnapData;
+
+int         rfSnapDecode         (const double *wf, int n, rfSnapData *pd);
+
+const char *rfSnapStnStateName   (int state);
+const char *rfSnapHvpsStatusName (int status);
+const char *rfSnapDacStatusName  (int status);
+const char *rfSnapTunrStatusName (int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_SNAP_DECODE_H */
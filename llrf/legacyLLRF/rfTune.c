@@ -0,0 +1,517 @@
+/*=============================================================================
+
+  Abs:  Streaming Tune Measurement from the Tickle Excitation
+
+  Name: rfTune.c
+         Public:
+           rfTuneReport   - print the estimate and bank of every station
+           rfTuneOpen     - find or create the engine for a station
+           rfTuneBand     - set the sample rate, search band and averaging
+           rfTuneExcite   - read the tickle I & Q files as the excitation
+           rfTuneUpdate   - add a block of I & Q response
+           rfTuneGet      - current tune, confidence, gain and status
+           rfTuneSpectrum - averaged gain over the band, for display
+         Private:
+           rfTuneInit     - create the table lock
+           rfTuneRead     - read the numbers of one tickle file
+           rfTuneBank     - Goertzel power of I & Q at every frequency
+           rfTunePower    - excitation power as seen by a response block
+           rfTunePeak     - find and refine the peak, rate the estimate
+
+  Rem:  rf_states loads the tickle files into the RFP module and plays
+        them to the beam while in ON_CW, but getting a tune out of the
+        response was done offline.  This module does it in the IOC.
+
+        The bank holds nbins frequencies spread over [low, high] Hz from
+        the carrier.  Each block of response I & Q is detrended, Hann
+        windowed, and run through a Goertzel filter per frequency.  A
+        synchrotron sideband shows on both sides of the carrier in I & Q,
+        so the power of the I and Q channels is summed, which is the sum
+        of the upper and lower sideband powers.  The Goertzel form needs
+        one multiply-add per sample per channel per frequency.
+
+        The tickle files are played cyclically, so a response block sees
+        a block-long stretch of the excitation at some unknown offset.
+        The excitation power is the mean over block-long stretches of the
+        files, taken circularly every quarter block, so the two powers
+        have the same resolution and the ratio isn't skewed by the
+        scatter of a single periodogram.  It is worked out again when
+        the block length or the band changes.
+
+        The ratio of response to excitation power is only taken where the
+        excitation has at least RF_TUNE_EXCITE_FLOOR of its peak power,
+        and is averaged exponentially over navg blocks (a running mean
+        until navg blocks have been seen).  The tune is the peak of the
+        averaged gain, refined by a parabola through the peak and its
+        neighbours.  The confidence (0-1) is the peak prominence over the
+        median of the band, times a stability term that falls off once
+        the estimate wanders by more than a bin between blocks.
+
+        The response is not aligned to the excitation playback, so only
+        the gain magnitude is used; no phase is needed for a tune.
+
+        IOC shell:
+          rfTuneReport(1)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <epicsPrint.h>      /* epicsPrintf prototype               */
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <iocsh.h>
+#include <epicsExport.h>
+
+#include "rfTune.h"
+
+#define RF_TUNE_EXCITE_FLOOR  1e-3   /* excitation power used, of its peak  */
+#define RF_TUNE_MIN_BLOCKS    4      /* blocks before a first estimate      */
+#define RF_TUNE_STN_LEN       16
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct
+{
+  char          stn[RF_TUNE_STN_LEN];
+  epicsMutexId  lock;
+  double        rate;                       /* sample rate (Hz)           */
+  double        low, high, df;              /* band and bin spacing (Hz)  */
+  int           nbins;
+  int           navg;                       /* blocks averaged            */
+  double        coeff [RF_TUNE_MAX_BINS];   /* Goertzel 2cos(w)           */
+  double        excite[RF_TUNE_MAX_BINS];   /* excitation power/sample    */
+  double        avg   [RF_TUNE_MAX_BINS];   /* averaged power gain        */
+  char          valid [RF_TUNE_MAX_BINS];   /* bin is excited             */
+  int           nvalid;
+  unsigned long blocks;                     /* blocks since band/excite   */
+  double        freq;                       /* estimate (Hz)              */
+  double        fmean, fvar;                /* running stats of estimate  */
+  double        conf;
+  double        ampl;
+  int           status;
+  float        *work;                       /* detrended windowed block   */
+  float        *ei, *eq;                    /* tickle I & Q files         */
+  float        *si, *sq;                    /* stretch of the excitation  */
+  int           nexcite;                    /* # samples in the files     */
+  int           nblock;                     /* block length of excite[]   */
+} rfTuneEngine;
+
+static rfTuneEngine *rfTuneTable[RF_TUNE_MAX_STATIONS];
+static int           rfTuneCount     = 0;
+static epicsMutexId  rfTuneTableLock = NULL;
+static epicsThreadOnceId rfTuneOnce = EPICS_THREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+
+static void rfTuneInit(void *arg)
+{
+  rfTuneTableLock = epicsMutexMustCreate();
+}
+
+static rfTuneEngine *rfTuneGetEngine(int id)
+{
+  if ((id < 0) || (id >= rfTuneCount)) return NULL;
+  return rfTuneTable[id];
+}
+
+/*
+ * Read up to RF_TUNE_MAX_EXCITE numbers from a tickle file.  Anything
+ * after a '#' and any text that isn't a number is skipped.  Returns the
+ * number of samples read, or RF_TUNE_ERROR if the file can't be opened.
+ */
+static int rfTuneRead(const char *file, float *x)
+{
+  FILE  *fp;
+  char   line[256], *p, *end, *hash;
+  double v;
+  int    n = 0;
+
+  if (!file || !*file || !(fp = fopen(file, "r"))) return RF_TUNE_ERROR;
+  while ((n < RF_TUNE_MAX_EXCITE) && fgets(line, sizeof(line), fp))
+  {
+    if ((hash = strchr(line, '#'))) *hash = '\0';
+    for (p = line; (n < RF_TUNE_MAX_EXCITE) && *p; p = end)
+    {
+      v = strtod(p, &end);
+      if (end == p)
+      {
+        end = p + 1;
+        continue;
+      }
+      x[n++] = (float)v;
+    }
+  }
+  fclose(fp);
+  return n;
+}
+
+/*
+ * Detrend and Hann window n samples of I and of Q, and return the power
+ * of I plus Q at every bank frequency, per unit of window power.
+ */
+static void rfTuneBank(rfTuneEngine *pe, const float *i, const float *q,
+                       int n, double *power)
+{
+  const float *x;
+  float       *w = pe->work;
+  double       mean, win, wsum = 0.0, s0, s1, s2, c;
+  int          chan, k, m;
+
+  for (m = 0; m < n; m++)
+  {
+    win   = 0.5 - 0.5 * cos(2.0 * M_PI * m / (n - 1));
+    wsum += win * win;
+  }
+  for (k = 0; k < pe->nbins; k++) power[k] = 0.0;
+  for (chan = 0; chan < 2; chan++)
+  {
+    x = chan ? q : i;
+    for (mean = 0.0, m = 0; m < n; m++) mean += x[m];
+    mean /= n;
+    for (m = 0; m < n; m++)
+      w[m] = (float)((x[m] - mean) *
+                     (0.5 - 0.5 * cos(2.0 * M_PI * m / (n - 1))));
+    for (k = 0; k < pe->nbins; k++)
+    {
+      c  = pe->coeff[k];
+      s1 = s2 = 0.0;
+      for (m = 0; m < n; m++)
+      {
+        s0 = w[m] + c * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+      }
+      power[k] += s1 * s1 + s2 * s2 - c * s1 * s2;
+    }
+  }
+  for (k = 0; k < pe->nbins; k++) power[k] /= wsum;
+}
+
+static void rfTunePower(rfTuneEngine *pe, int n)
+{
+  double power[RF_TUNE_MAX_BINS], peak = 0.0;
+  int    hop = (n / 4 > 0) ? n / 4 : 1, start, nseg = 0, k, m;
+
+  for (k = 0; k < pe->nbins; k++) pe->excite[k] = 0.0;
+  for (start = 0; start < pe->nexcite; start += hop, nseg++)
+  {
+    for (m = 0; m < n; m++)
+    {
+      pe->si[m] = pe->ei[(start + m) % pe->nexcite];
+      pe->sq[m] = pe->eq[(start + m) % pe->nexcite];
+    }
+    rfTuneBank(pe, pe->si, pe->sq, n, power);
+    for (k = 0; k < pe->nbins; k++) pe->excite[k] += power[k];
+  }
+  pe->nvalid = 0;
+  for (k = 0; k < pe->nbins; k++)
+  {
+    pe->excite[k] /= nseg;
+    if (pe->excite[k] > peak) peak = pe->excite[k];
+  }
+  for (k = 0; k < pe->nbins; k++)
+  {
+    pe->valid[k] = (peak > 0.0) &&
+                   (pe->excite[k] >= RF_TUNE_EXCITE_FLOOR * peak);
+    if (pe->valid[k]) pe->nvalid++;
+  }
+  memset(pe->avg, 0, sizeof(pe->avg));
+  pe->nblock = n;
+  pe->blocks = 0;
+  pe->fmean  = pe->fvar = 0.0;
+}
+
+static int rfTuneCompare(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+
+  return (x < y) ? -1 : (x > y);
+}
+
+static void rfTunePeak(rfTuneEngine *pe, double alpha)
+{
+  double gain[RF_TUNE_MAX_BINS], sorted[RF_TUNE_MAX_BINS];
+  double peak, median, a, b, c, den, delta = 0.0, d;
+  int    k, kmax = -1, kfirst = -1, klast = -1, nv = 0;
+
+  for (k = 0; k < pe->nbins; k++)
+  {
+    gain[k] = sqrt(pe->avg[k]);
+    if (!pe->valid[k]) continue;
+    sorted[nv++] = gain[k];
+    if (kfirst < 0) kfirst = k;
+    klast = k;
+    if ((kmax < 0) || (gain[k] > gain[kmax])) kmax = k;
+  }
+  if (nv < 3)
+  {
+    pe->status = RF_TUNE_STATUS_NOEXCIT;
+    pe->conf   = 0.0;
+    return;
+  }
+  qsort(sorted, nv, sizeof(double), rfTuneCompare);
+  median = sorted[nv / 2];
+  peak  = gain[kmax];
+
+  /* A peak on the edge of the excited band is leakage, not a tune */
+  if ((kmax == kfirst) || (kmax == klast) || (peak <= median))
+  {
+    pe->status = RF_TUNE_STATUS_NOPEAK;
+    pe->conf   = 0.0;
+    return;
+  }
+  if (pe->valid[kmax - 1] && pe->valid[kmax + 1])
+  {
+    a   = gain[kmax - 1];
+    b   = peak;
+    c   = gain[kmax + 1];
+    den = a - 2.0 * b + c;
+    if (den < 0.0) delta = 0.5 * (a - c) / den;
+  }
+  pe->freq = pe->low + (kmax + delta) * pe->df;
+  pe->ampl = peak;
+
+  d          = pe->freq - pe->fmean;
+  pe->fmean += alpha * d;
+  pe->fvar   = (1.0 - alpha) * (pe->fvar + alpha * d * d);
+
+  if (pe->blocks < RF_TUNE_MIN_BLOCKS)
+  {
+    pe->status = RF_TUNE_STATUS_SETTLE;
+    pe->conf   = 0.0;
+    return;
+  }
+  pe->status = RF_TUNE_STATUS_GOOD;
+  pe->conf   = ((peak - median) / (peak + median)) /
+               (1.0 + pe->fvar / (pe->df * pe->df));
+}
+
+/*----------------------------------------------------------------------------*/
+
+int rfTuneOpen(const char *stn)
+{
+  rfTuneEngine *pe;
+  int           id;
+
+  if (!stn) stn = "";
+  epicsThreadOnce(&rfTuneOnce, rfTuneInit, NULL);
+  epicsMutexMustLock(rfTuneTableLock);
+  for (id = 0; id < rfTuneCount; id++)
+    if (!strncmp(stn, rfTuneTable[id]->stn, RF_TUNE_STN_LEN - 1)) break;
+  if (id == rfTuneCount)
+  {
+    pe = NULL;
+    if (rfTuneCount < RF_TUNE_MAX_STATIONS)
+      pe = (rfTuneEngine *)calloc(1, sizeof(*pe));
+    if (pe)
+    {
+      pe->work = (float *)malloc(RF_TUNE_MAX_EXCITE * sizeof(float));
+      pe->ei   = (float *)malloc(RF_TUNE_MAX_EXCITE * sizeof(float));
+      pe->eq   = (float *)malloc(RF_TUNE_MAX_EXCITE * sizeof(float));
+      pe->si   = (float *)malloc(RF_TUNE_MAX_EXCITE * sizeof(float));
+      pe->sq   = (float *)malloc(RF_TUNE_MAX_EXCITE * sizeof(float));
+    }
+    if (pe && pe->work && pe->ei && pe->eq && pe->si && pe->sq)
+    {
+      sprintf(pe->stn, "%.*s", RF_TUNE_STN_LEN - 1, stn);
+      pe->lock   = epicsMutexMustCreate();
+      pe->status = RF_TUNE_STATUS_BAND;
+      rfTuneTable[rfTuneCount++] = pe;
+    }
+    else
+    {
+      if (pe)
+      {
+        free(pe->work);
+        free(pe->ei);
+        free(pe->eq);
+        free(pe->si);
+        free(pe->sq);
+        free(pe);
+      }
+      epicsPrintf("rfTuneOpen: No room for station %s\n", stn);
+      id = RF_TUNE_ERROR;
+    }
+  }
+  epicsMutexUnlock(rfTuneTableLock);
+  return id;
+}
+
+/*
+ * Set up the bank.  A bad band stops the measurement until the next call.
+ */
+int rfTuneBand(int id, double rate, double low, double high,
+               int nbins, int navg)
+{
+  rfTuneEngine *pe = rfTuneGetEngine(id);
+  int           k, status = RF_TUNE_OK;
+
+  if (!pe) return RF_TUNE_ERROR;
+  epicsMutexMustLock(pe->lock);
+  if (nbins > RF_TUNE_MAX_BINS) nbins = RF_TUNE_MAX_BINS;
+  if ((rate <= 0.0) || (low < 0.0) || (high <= low) ||
+      (high >= rate / 2.0) || (nbins < 3))
+  {
+    pe->nbins  = 0;
+    pe->status = RF_TUNE_STATUS_BAND;
+    status     = RF_TUNE_ERROR;
+  }
+  else
+  {
+    pe->rate  = rate;
+    pe->low   = low;
+    pe->high  = high;
+    pe->nbins = nbins;
+    pe->navg  = (navg > 0) ? navg : 1;
+    pe->df    = (high - low) / (nbins - 1);
+    for (k = 0; k < nbins; k++)
+      pe->coeff[k] = 2.0 * cos(2.0 * M_PI * (low + k * pe->df) / rate);
+    pe->status = (pe->nexcite > 0) ? RF_TUNE_STATUS_SETTLE :
+                                     RF_TUNE_STATUS_NOEXCIT;
+  }
+  pe->nblock = 0;
+  pe->blocks = 0;
+  pe->conf   = 0.0;
+  epicsMutexUnlock(pe->lock);
+  return status;
+}
+
+int rfTuneExcite(int id, const char *ifile, const char *qfile)
+{
+  rfTuneEngine *pe = rfTuneGetEngine(id);
+  int           ni, nq, status = RF_TUNE_OK;
+
+  if (!pe) return RF_TUNE_ERROR;
+  epicsMutexMustLock(pe->lock);
+  ni = rfTuneRead(ifile, pe->ei);
+  nq = rfTuneRead(qfile, pe->eq);
+  pe->nexcite = (ni < nq) ? ni : nq;
+  if (pe->nexcite < 2 * RF_TUNE_MIN_BLOCKS)
+  {
+    epicsPrintf("rfTuneExcite: %s: No excitation in %s, %s\n",
+                pe->stn, ifile ? ifile : "", qfile ? qfile : "");
+    pe->nexcite = 0;
+    status      = RF_TUNE_ERROR;
+  }
+  pe->nblock = 0;
+  pe->blocks = 0;
+  pe->conf   = 0.0;
+  if (pe->nbins)
+    pe->status = (status == RF_TUNE_OK) ? RF_TUNE_STATUS_SETTLE :
+                                          RF_TUNE_STATUS_NOEXCIT;
+  epicsMutexUnlock(pe->lock);
+  return status;
+}
+
+int rfTuneUpdate(int id, const float *i, const float *q, int n)
+{
+  rfTuneEngine *pe = rfTuneGetEngine(id);
+  double        power[RF_TUNE_MAX_BINS], alpha;
+  int           k;
+
+  if (!pe) return RF_TUNE_ERROR;
+  if (n > RF_TUNE_MAX_EXCITE) n = RF_TUNE_MAX_EXCITE;
+  epicsMutexMustLock(pe->lock);
+  if (!pe->nbins || !pe->nexcite || (n < 2 * RF_TUNE_MIN_BLOCKS))
+  {
+    epicsMutexUnlock(pe->lock);
+    return RF_TUNE_ERROR;
+  }
+  if (n != pe->nblock) rfTunePower(pe, n);
+  rfTuneBank(pe, i, q, n, power);
+  pe->blocks++;
+  alpha = 1.0 / ((pe->blocks < (unsigned long)pe->navg) ?
+                 pe->blocks : pe->navg);
+  for (k = 0; k < pe->nbins; k++)
+    if (pe->valid[k])
+      pe->avg[k] += alpha * (power[k] / pe->excite[k] - pe->avg[k]);
+  rfTunePeak(pe, alpha);
+  epicsMutexUnlock(pe->lock);
+  return RF_TUNE_OK;
+}
+
+int rfTuneGet(int id, double *freq, double *conf, double *ampl, int *status)
+{
+  rfTuneEngine *pe = rfTuneGetEngine(id);
+
+  if (!pe) return RF_TUNE_ERROR;
+  epicsMutexMustLock(pe->lock);
+  *freq   = pe->freq;
+  *conf   = pe->conf;
+  *ampl   = pe->ampl;
+  *status = pe->status;
+  epicsMutexUnlock(pe->lock);
+  return RF_TUNE_OK;
+}
+
+int rfTuneSpectrum(int id, float *spectrum, int n)
+{
+  rfTuneEngine *pe = rfTuneGetEngine(id);
+  int           k;
+
+  if (!pe) return RF_TUNE_ERROR;
+  epicsMutexMustLock(pe->lock);
+  for (k = 0; k < n; k++)
+    spectrum[k] = ((k < pe->nbins) && pe->valid[k]) ?
+                  (float)sqrt(pe->avg[k]) : 0.0f;
+  epicsMutexUnlock(pe->lock);
+  return RF_TUNE_OK;
+}
+
+void rfTuneReport(int level)
+{
+  static const char *statusName[] =
+    {"OFF", "GOOD", "SETTLE", "NOEXCIT", "BAND", "NOPEAK"};
+  rfTuneEngine      *pe;
+  int                i, k;
+
+  printf("%d tune engines\n", rfTuneCount);
+  for (i = 0; i < rfTuneCount; i++)
+  {
+    pe = rfTuneTable[i];
+    epicsMutexMustLock(pe->lock);
+    printf("%-8s %-7s tune %10.2f Hz conf %5.3f gain %10.4g %lu blocks\n",
+           pe->stn, statusName[pe->status], pe->freq, pe->conf, pe->ampl,
+           pe->blocks);
+    if (level > 0)
+      printf("%8s band %.1f-%.1f Hz, %d bins (%d excited), rate %.1f Hz, "
+             "avg %d\n", "", pe->low, pe->high, pe->nbins, pe->nvalid,
+             pe->rate, pe->navg);
+    if (level > 1)
+      for (k = 0; k < pe->nbins; k++)
+        if (pe->valid[k])
+          printf("%8s %10.2f Hz %10.4g\n", "", pe->low + k * pe->df,
+                 sqrt(pe->avg[k]));
+    epicsMutexUnlock(pe->lock);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const iocshArg rfTuneReportArg0 = {"level", iocshArgInt};
+static const iocshArg *rfTuneReportArgs[] = {&rfTuneReportArg0};
+static const iocshFuncDef rfTuneReportDef =
+  {"rfTuneReport", 1, rfTuneReportArgs};
+static void rfTuneReportCall(const iocshArgBuf *args)
+{
+  rfTuneReport(args[0].ival);
+}
+
+static void rfTuneRegistrar(void)
+{
+  iocshRegister(&rfTuneReportDef, rfTuneReportCall);
+}
+epicsExportRegistrar(rfTuneRegistrar);
@@ -0,0 +1,62 @@
+/*=============================================================================
+
+  Abs:  Streaming Tune Measurement from the Tickle Excitation
+
+  Name: rfTune.h
+
+  Prev: None
+
+  Rem:  One engine per station.  The tickle I & Q files give the
+        excitation; blocks of station I & Q response are fed to a
+        Goertzel bank over the tune search band and the tune is taken
+        from the peak of the averaged response/excitation ratio.
+        Frequencies are offsets from the RF carrier in Hz.
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+-------------------------------------------------------------------------------
+
+  Mod:
+
+=============================================================================*/
+#ifndef RF_TUNE_H
+#define RF_TUNE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_TUNE_OK           0
+#define RF_TUNE_ERROR      (-1)
+
+#define RF_TUNE_MAX_STATIONS 4      /* # engines per IOC                    */
+#define RF_TUNE_MAX_BINS     256    /* # frequencies in the Goertzel bank   */
+#define RF_TUNE_MAX_EXCITE   16384  /* # samples in a tickle file or block  */
+
+/* Statuses, these MUST match pv {STN}:STN:TUNE:STATUS */
+#define RF_TUNE_STATUS_OFF     0    /* tickle off                           */
+#define RF_TUNE_STATUS_GOOD    1    /* tracking                             */
+#define RF_TUNE_STATUS_SETTLE  2    /* averaging, no estimate yet           */
+#define RF_TUNE_STATUS_NOEXCIT 3    /* tickle files unreadable or empty     */
+#define RF_TUNE_STATUS_BAND    4    /* bad band or sample rate              */
+#define RF_TUNE_STATUS_NOPEAK  5    /* response has no peak in the band     */
+
+/* IOC shell */
+void   rfTuneReport  (int level);
+
+/* Measurement */
+int    rfTuneOpen    (const char *stn);
+int    rfTuneBand    (int id, double rate, double low, double high,
+                      int nbins, int navg);
+int    rfTuneExcite  (int id, const char *ifile, const char *qfile);
+int    rfTuneUpdate  (int id, const float *i, const float *q, int n);
+int    rfTuneGet     (int id, double *freq, double *conf, double *ampl,
+                      int *status);
+int    rfTuneSpectrum(int id, float *spectrum, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_TUNE_H */
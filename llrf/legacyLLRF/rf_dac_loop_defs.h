@@ -26,12 +26,48 @@
 /* File name: rf_dac_loop_defs.h */
 
 /* 
- * Process at least every ten seconds no matter what 
+ * Slowest cycle (heartbeat) of the adaptive scheduler, rfSched.c.  The
+ * loop also runs at this period if READY stops.  A count change of
+ * DAC_LOOP_SCHED_SCALE is active; only a loop that is controlling or
+ * turned off with no error may slow down.
  */
-#define DAC_LOOP_MAX_INTERVAL     10.0
+#define DAC_LOOP_SLOW_PERIOD      5.0
+#define DAC_LOOP_SCHED_NAME       "STNDAC:LOOP"
+#define DAC_LOOP_SCHED_SCALE      (2 * DAC_LOOP_MIN_DELTA_COUNTS)
+#define DAC_LOOP_STEADY(status)   (((status) == DAC_LOOP_STATUS_TUNE)     || \
+                                   ((status) == DAC_LOOP_STATUS_ON)       || \
+                                   ((status) == DAC_LOOP_STATUS_TUNE_OFF) || \
+                                   ((status) == DAC_LOOP_STATUS_ON_OFF))
 #define DAC_LOOP_MAX_COUNTS       2047
 #define DAC_LOOP_MIN_DELTA_COUNTS 0.5
 
+/* 
+ * Checkpoint for a bumpless restart (rfCkpt.c): name, age limit, and the
+ * slots of the record
+ */
+#define DAC_LOOP_CKPT_NAME        "STNDAC:LOOP"
+#define DAC_LOOP_CKPT_AGE         (LOOP_CKPT_RESTART + DAC_LOOP_SLOW_PERIOD)
+#define DAC_LOOP_CKPT_STN         0
+#define DAC_LOOP_CKPT_DIRECT      1
+#define DAC_LOOP_CKPT_TUNE_CTRL   2
+#define DAC_LOOP_CKPT_ON_CTRL     3
+#define DAC_LOOP_CKPT_GFF_CTRL    4
+#define DAC_LOOP_CKPT_TUNE_COUNTS 5
+#define DAC_LOOP_CKPT_ON_COUNTS   6
+#define DAC_LOOP_CKPT_GFF_COUNTS  7
+#define DAC_LOOP_CKPT_TUNE_PROC   8
+#define DAC_LOOP_CKPT_ON_PROC     9
+#define DAC_LOOP_CKPT_GFF_PROC    10
+#define DAC_LOOP_CKPT_LEN         11
+
+/* 
+ * Names of the in-IOC history series (rfHist.c), prefixed by the station 
+ */
+#define DAC_LOOP_HIST_STATUS      "STNDAC:LOOP:STATUS"
+#define DAC_LOOP_HIST_TUNE        "STN:TUNE:IQ"
+#define DAC_LOOP_HIST_ON          "STN:ON:IQ"
+#define DAC_LOOP_HIST_GFF         "STN:GFF:IQ"
+
 /* 
  * Definitions for DAC loop statuses - 
  * these MUST match pv {STN}:STNDAC:LOOP:STATUS 
@@ -54,6 +54,81 @@
         prev_direct_loop = LOOP_CONTROL_OFF;                               \
 }  
 
+#define DAC_LOOP_CKPT_SAVE()                                               \
+{                                                                          \
+        /* Save the loop state every cycle for a bumpless restart */       \
+        ckpt_rec[DAC_LOOP_CKPT_STN]         = station_state;               \
+        ckpt_rec[DAC_LOOP_CKPT_DIRECT]      = prev_direct_loop;            \
+        ckpt_rec[DAC_LOOP_CKPT_TUNE_CTRL]   = prev_tune_ctrl;              \
+        ckpt_rec[DAC_LOOP_CKPT_ON_CTRL]     = prev_on_ctrl;                \
+        ckpt_rec[DAC_LOOP_CKPT_GFF_CTRL]    = prev_gff_ctrl;               \
+        ckpt_rec[DAC_LOOP_CKPT_TUNE_COUNTS] = prev_tune_counts;            \
+        ckpt_rec[DAC_LOOP_CKPT_ON_COUNTS]   = prev_on_counts;              \
+        ckpt_rec[DAC_LOOP_CKPT_GFF_COUNTS]  = prev_gff_counts;             \
+        ckpt_rec[DAC_LOOP_CKPT_TUNE_PROC]   = tune_proc_counts;            \
+        ckpt_rec[DAC_LOOP_CKPT_ON_PROC]     = on_proc_counts;              \
+        ckpt_rec[DAC_LOOP_CKPT_GFF_PROC]    = gff_proc_counts;             \
+        rfCkptSave(ckpt_id, ckpt_rec);                                     \
+}
+
+#define DAC_LOOP_SNAP()                                                    \
+{                                                                          \
+        /* Stage and commit the loop's section of the station snapshot */  \
+        rfSnapPut(snap_id, RF_SNAP_DAC_STATUS,    loop_status);            \
+        rfSnapPut(snap_id, RF_SNAP_DAC_TUNE_IQ,   tune_counts);            \
+        rfSnapPut(snap_id, RF_SNAP_DAC_ON_IQ,     on_counts);              \
+        rfSnapPut(snap_id, RF_SNAP_DAC_GFF_IQ,    gff_counts);             \
+        rfSnapPut(snap_id, RF_SNAP_DAC_TUNE_CTRL, loop_tune_ctrl);         \
+        rfSnapPut(snap_id, RF_SNAP_DAC_ON_CTRL,   loop_on_ctrl);           \
+        rfSnapPut(snap_id, RF_SNAP_DAC_DIRECT,    direct_loop);            \
+        rfSnapPut(snap_id, RF_SNAP_DAC_PERIOD,    sched_period);           \
+        rfSnapCommit(snap_id, RF_SNAP_SEC_DAC);                            \
+}
+
+/* A DAC the loop was controlling must still hold the counts it last set */
+#define DAC_LOOP_CKPT_AGREES(ctrl_slot, counts, counts_slot)               \
+(                                                                          \
+        (ckpt_rec[ctrl_slot] == LOOP_CONTROL_OFF) ||                       \
+        (((counts) - ckpt_rec[counts_slot] <=  DAC_LOOP_MIN_DELTA_COUNTS) && \
+         ((counts) - ckpt_rec[counts_slot] >= -DAC_LOOP_MIN_DELTA_COUNTS))   \
+)
+
+/* True when the checkpoint is fresh, was taken in the same tune or on_cw
+   station state and the DACs agree with it; call after getting the counts */
+#define DAC_LOOP_CKPT_RESUME()                                             \
+(                                                                          \
+        (rfCkptLoad(ckpt_id, ckpt_rec, DAC_LOOP_CKPT_AGE) == RF_CKPT_OK) && \
+        ((station_state == STATION_TUNE) ||                                \
+         (station_state == STATION_ON_CW))                              && \
+        (ckpt_rec[DAC_LOOP_CKPT_STN] == station_state)                  && \
+        DAC_LOOP_CKPT_AGREES(DAC_LOOP_CKPT_TUNE_CTRL, tune_counts,         \
+                             DAC_LOOP_CKPT_TUNE_COUNTS)                 && \
+        DAC_LOOP_CKPT_AGREES(DAC_LOOP_CKPT_ON_CTRL,   on_counts,           \
+                             DAC_LOOP_CKPT_ON_COUNTS)                   && \
+        DAC_LOOP_CKPT_AGREES(DAC_LOOP_CKPT_GFF_CTRL,  gff_counts,          \
+                             DAC_LOOP_CKPT_GFF_COUNTS)                     \
+)
+
+#define DAC_LOOP_CKPT_RESTORE()                                            \
+{                                                                          \
+        /* Keep the controls, so the loop carries on from its counts */    \
+        efClear(loop_ready_ef);                                            \
+        efSet(phase_ef);                                                   \
+        efSet(rfp_dac_ef);                                                 \
+        prev_direct_loop = ckpt_rec[DAC_LOOP_CKPT_DIRECT];                 \
+        prev_tune_ctrl   = ckpt_rec[DAC_LOOP_CKPT_TUNE_CTRL];              \
+        prev_on_ctrl     = ckpt_rec[DAC_LOOP_CKPT_ON_CTRL];                \
+        prev_gff_ctrl    = ckpt_rec[DAC_LOOP_CKPT_GFF_CTRL];               \
+        prev_tune_counts = ckpt_rec[DAC_LOOP_CKPT_TUNE_COUNTS];            \
+        prev_on_counts   = ckpt_rec[DAC_LOOP_CKPT_ON_COUNTS];              \
+        prev_gff_counts  = ckpt_rec[DAC_LOOP_CKPT_GFF_COUNTS];             \
+        tune_proc_counts = ckpt_rec[DAC_LOOP_CKPT_TUNE_PROC];              \
+        on_proc_counts   = ckpt_rec[DAC_LOOP_CKPT_ON_PROC];                \
+        gff_proc_counts  = ckpt_rec[DAC_LOOP_CKPT_GFF_PROC];               \
+        /* The first cycle publishes the status */                         \
+        loop_status = prev_loop_status = DAC_LOOP_STATUS_UNKNOWN;          \
+}
+
 #define DAC_LOOP_SET(counts, delta_counts, tol_sev, other_stat, other_sev, \
                      prev_counts, proc_counts, ctrl, prev_ctrl,            \
                      good_status, off_status, tol_status, bad_status)      \
@@ -82,6 +157,7 @@
                                             pvSeverity(counts),            \
 	                                    good_status, bad_status);      \
 	  get_status  = pvGet(delta_counts);                               \
+	  sched_err   = delta_counts;                                      \
 	  loop_status = DAC_LOOP_GET_STATUS(get_status,                    \
                                             pvSeverity(delta_counts),      \
 	                                    loop_status, bad_status);      \
@@ -193,5 +269,9 @@
           pvPut (loop_status);                                             \
           pvPut (loop_status_c);                                           \
         }                                                                  \
+        rfHistAdd(hist_status_id, loop_status);                            \
+        rfHistAdd(hist_tune_id,   tune_counts);                            \
+        rfHistAdd(hist_on_id,     on_counts);                              \
+        rfHistAdd(hist_gff_id,    gff_counts);                             \
         pvPut(hist_proc);                                                  \
 }
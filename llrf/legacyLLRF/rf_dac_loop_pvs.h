@@ -58,6 +58,15 @@ assign  loop_status       to "{STN}:STNDAC:LOOP:STATUS";
 
 string  loop_status_c;
 assign  loop_status_c     to "{STN}:STNDAC:LOOP:STRING";
+
+float   sched_period;
+assign  sched_period      to "{STN}:STNDAC:LOOP:SCHED:PERIOD";
+
+int     sched_decision;
+assign  sched_decision    to "{STN}:STNDAC:LOOP:SCHED:DECISION";
+
+float   sched_activity;
+assign  sched_activity    to "{STN}:STNDAC:LOOP:SCHED:ACTIVITY";
   
 float   phase;
 assign  phase             to "{STN}:STN:PHASE:CALC";
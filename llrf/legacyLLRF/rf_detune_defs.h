@@ -0,0 +1,19 @@
+/*=============================================================================
+
+  Abs:  Defines used by the Detuning Estimator Sequence
+
+  Name: rf_detune_defs.h
+
+  Prev: None
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+#define DETUNE_NCAV          4       /* # cavities per station              */
+#define DETUNE_NPTS          1024    /* # samples in an I or Q waveform     */
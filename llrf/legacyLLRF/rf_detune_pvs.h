@@ -0,0 +1,137 @@
+/*=============================================================================
+
+  Abs:  Process Variables used by the Detuning Estimator Sequence
+
+  Name: rf_detune_pvs.h
+
+  Prev: rf_detune_defs.h      (DETUNE_NCAV, DETUNE_NPTS)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/* Forward, reflected and probe I & Q waveforms, one row per cavity.  The
+   capture processes every waveform and then READY, so a new block is
+   flagged by the READY monitor. */
+float   fwd_i[DETUNE_NCAV][DETUNE_NPTS];
+assign  fwd_i[0] to "{STN}:CAV1FRWD:WF:I";
+assign  fwd_i[1] to "{STN}:CAV2FRWD:WF:I";
+assign  fwd_i[2] to "{STN}:CAV3FRWD:WF:I";
+assign  fwd_i[3] to "{STN}:CAV4FRWD:WF:I";
+monitor fwd_i;
+
+float   fwd_q[DETUNE_NCAV][DETUNE_NPTS];
+assign  fwd_q[0] to "{STN}:CAV1FRWD:WF:Q";
+assign  fwd_q[1] to "{STN}:CAV2FRWD:WF:Q";
+assign  fwd_q[2] to "{STN}:CAV3FRWD:WF:Q";
+assign  fwd_q[3] to "{STN}:CAV4FRWD:WF:Q";
+monitor fwd_q;
+
+float   refl_i[DETUNE_NCAV][DETUNE_NPTS];
+assign  refl_i[0] to "{STN}:CAV1REFL:WF:I";
+assign  refl_i[1] to "{STN}:CAV2REFL:WF:I";
+assign  refl_i[2] to "{STN}:CAV3REFL:WF:I";
+assign  refl_i[3] to "{STN}:CAV4REFL:WF:I";
+monitor refl_i;
+
+float   refl_q[DETUNE_NCAV][DETUNE_NPTS];
+assign  refl_q[0] to "{STN}:CAV1REFL:WF:Q";
+assign  refl_q[1] to "{STN}:CAV2REFL:WF:Q";
+assign  refl_q[2] to "{STN}:CAV3REFL:WF:Q";
+assign  refl_q[3] to "{STN}:CAV4REFL:WF:Q";
+monitor refl_q;
+
+float   prb_i[DETUNE_NCAV][DETUNE_NPTS];
+assign  prb_i[0] to "{STN}:CAV1PROBE:WF:I";
+assign  prb_i[1] to "{STN}:CAV2PROBE:WF:I";
+assign  prb_i[2] to "{STN}:CAV3PROBE:WF:I";
+assign  prb_i[3] to "{STN}:CAV4PROBE:WF:I";
+monitor prb_i;
+
+float   prb_q[DETUNE_NCAV][DETUNE_NPTS];
+assign  prb_q[0] to "{STN}:CAV1PROBE:WF:Q";
+assign  prb_q[1] to "{STN}:CAV2PROBE:WF:Q";
+assign  prb_q[2] to "{STN}:CAV3PROBE:WF:Q";
+assign  prb_q[3] to "{STN}:CAV4PROBE:WF:Q";
+monitor prb_q;
+
+int     wf_ready;
+assign  wf_ready to "{STN}:CAVTUNR:WF:READY";
+monitor wf_ready;
+evflag  wf_ef;
+sync    wf_ready wf_ef;
+
+/* Estimator control, shared with rf_tuner_loop.  On, the tuner loops take
+   posn delta from the estimator instead of {STN}:CAV{CAV}TUNR:POSN:DELTA. */
+
+int     est_ctrl;
+assign  est_ctrl to "{STN}:CAVTUNR:EST:CTRL";
+monitor est_ctrl;
+evflag  ctrl_ef;
+sync    est_ctrl ctrl_ef;
+
+/* Calibration - load angle offset (deg), tuner gain (posn per deg) and the
+   minimum rms forward amplitude.  Any change loads the estimator again. */
+
+evflag  cal_ef;
+
+double  est_offset[DETUNE_NCAV];
+assign  est_offset[0] to "{STN}:CAV1TUNR:EST:OFFSET";
+assign  est_offset[1] to "{STN}:CAV2TUNR:EST:OFFSET";
+assign  est_offset[2] to "{STN}:CAV3TUNR:EST:OFFSET";
+assign  est_offset[3] to "{STN}:CAV4TUNR:EST:OFFSET";
+monitor est_offset;
+sync    est_offset cal_ef;
+
+double  est_gain[DETUNE_NCAV];
+assign  est_gain[0] to "{STN}:CAV1TUNR:EST:GAIN";
+assign  est_gain[1] to "{STN}:CAV2TUNR:EST:GAIN";
+assign  est_gain[2] to "{STN}:CAV3TUNR:EST:GAIN";
+assign  est_gain[3] to "{STN}:CAV4TUNR:EST:GAIN";
+monitor est_gain;
+sync    est_gain cal_ef;
+
+double  est_amin;
+assign  est_amin to "{STN}:CAVTUNR:EST:AMIN";
+monitor est_amin;
+sync    est_amin cal_ef;
+
+/* Results */
+
+double  est_detune[DETUNE_NCAV];
+assign  est_detune[0] to "{STN}:CAV1TUNR:EST:DETUNE";
+assign  est_detune[1] to "{STN}:CAV2TUNR:EST:DETUNE";
+assign  est_detune[2] to "{STN}:CAV3TUNR:EST:DETUNE";
+assign  est_detune[3] to "{STN}:CAV4TUNR:EST:DETUNE";
+
+double  est_ldang[DETUNE_NCAV];
+assign  est_ldang[0] to "{STN}:CAV1TUNR:EST:LDANG";
+assign  est_ldang[1] to "{STN}:CAV2TUNR:EST:LDANG";
+assign  est_ldang[2] to "{STN}:CAV3TUNR:EST:LDANG";
+assign  est_ldang[3] to "{STN}:CAV4TUNR:EST:LDANG";
+
+double  est_delta[DETUNE_NCAV];
+assign  est_delta[0] to "{STN}:CAV1TUNR:EST:DELTA";
+assign  est_delta[1] to "{STN}:CAV2TUNR:EST:DELTA";
+assign  est_delta[2] to "{STN}:CAV3TUNR:EST:DELTA";
+assign  est_delta[3] to "{STN}:CAV4TUNR:EST:DELTA";
+
+double  est_noise[DETUNE_NCAV];
+assign  est_noise[0] to "{STN}:CAV1TUNR:EST:NOISE";
+assign  est_noise[1] to "{STN}:CAV2TUNR:EST:NOISE";
+assign  est_noise[2] to "{STN}:CAV3TUNR:EST:NOISE";
+assign  est_noise[3] to "{STN}:CAV4TUNR:EST:NOISE";
+
+int     est_status[DETUNE_NCAV];
+assign  est_status[0] to "{STN}:CAV1TUNR:EST:STATUS";
+assign  est_status[1] to "{STN}:CAV2TUNR:EST:STATUS";
+assign  est_status[2] to "{STN}:CAV3TUNR:EST:STATUS";
+assign  est_status[3] to "{STN}:CAV4TUNR:EST:STATUS";
+
+double  est_rate;
+assign  est_rate to "{STN}:CAVTUNR:EST:RATE";
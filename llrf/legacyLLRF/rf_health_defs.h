@@ -0,0 +1,42 @@
+/*=============================================================================
+
+  Abs:  Defines used by the Station Health Watchdog Sequence
+
+  Name: rf_health_defs.h
+
+  Prev: None
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/* Bits of the aggregated health mask ({STN}:STN:HEALTH:MASK) */
+#define HEALTH_NBITS         4
+#define HEALTH_TAXI_BIT      0    /* GVF TAXI link error (GST1 TAXIOFLW)    */
+#define HEALTH_GVF_BIT       1    /* GVF module has invalid severity        */
+#define HEALTH_RFP_BIT       2    /* RF processor has invalid severity      */
+#define HEALTH_RESYNC_BIT    3    /* LFB resyncs did not clear TAXI error   */
+#define HEALTH_M(bit)        (1 << (bit))
+
+#define HEALTH_TAXI_NAME     "Gvf Taxi error"
+#define HEALTH_GVF_NAME      "Gvf module invalid"
+#define HEALTH_RFP_NAME      "RF processor invalid"
+#define HEALTH_RESYNC_NAME   "LFB resync failed"
+#define HEALTH_GOOD_STRING   "Healthy"
+
+/* Debounce and recovery timing */
+#define HEALTH_DEBOUNCE      0.5  /* # seconds a change must persist        */
+#define HEALTH_RESYNC_MIN    30   /* min random delay in ticks before resync
+                                     so mostly only one IOC does the reset  */
+#define HEALTH_RESYNC_RANGE  210  /* range of random delay in ticks         */
+#define HEALTH_VERIFY_DELAY  (2/60.0) /* # seconds for TAXI check to happen */
+#define HEALTH_RESYNC_RETRY  10.0 /* # seconds between resync attempts      */
+#define HEALTH_RESYNC_MAX    3    /* # resyncs before HEALTH_RESYNC_BIT     */
+
+/* Gap module state */
+#define HEALTH_GVF_RUN       1
@@ -0,0 +1,50 @@
+/*=============================================================================
+
+  Abs:  Macros Shared by States of the Station Health Watchdog Sequence
+
+  Name: rf_health_macs.h
+
+  Prev: %%epicsPrint.h        (epicsPrintf prototype)
+        health_defs.h         (HEALTH* defines)
+        health_pvs.h          (health process variable names)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/*
+ * Record a raw (undebounced) change of a health bit.  Every TAXI
+ * assertion is counted, including glitches too short to be debounced.
+ * Used from more than one state set; rfHealthMark keeps the raw mask.
+ */
+#define HEALTH_RAW(bit, asserted)					\
+{									\
+  if (rfHealthMark(bit, (asserted) ? TRUE : FALSE))			\
+  {									\
+    efSet(raw_ef);							\
+    if ((asserted) && ((bit) == HEALTH_TAXI_BIT))			\
+    {									\
+      taxi_count++;							\
+      pvPut(taxi_count);						\
+    }									\
+  }									\
+}
+/*
+
+*/
+/*
+ * Publish the first-seen time of a health bit that has just been set.
+ */
+#define HEALTH_PUBLISH_TIME(changed, bit, time_c)			\
+{									\
+  if (((changed) & HEALTH_M(bit)) && (health_mask & HEALTH_M(bit)))	\
+  {									\
+    rfHealthTime(bit, time_c);						\
+    pvPut(time_c);							\
+  }									\
+}
@@ -0,0 +1,81 @@
+/*=============================================================================
+
+  Abs:  Process Variables used by the Station Health Watchdog Sequence
+
+  Name: rf_health_pvs.h
+
+  Prev: None
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/* Inputs - all monitored, nothing is polled */
+
+int     gvfstat1;
+assign  gvfstat1 to "{STN}:STN:GVF:MODU.GST1";
+monitor gvfstat1;
+evflag  gvfstat1_ef;
+sync    gvfstat1 gvfstat1_ef;
+
+int     gvfstate;
+assign  gvfstate to "{STN}:STN:GVF:STATE";
+monitor gvfstate;
+
+int     gvfwoof;
+assign  gvfwoof to "{STN}:STN:GVF:LFBLOOP";
+monitor gvfwoof;
+
+int     gvf_module_sevr;
+assign  gvf_module_sevr to "{STN}:STN:GVF:MODU.SEVR";
+monitor gvf_module_sevr;
+evflag  gvf_module_sevr_ef;
+sync    gvf_module_sevr gvf_module_sevr_ef;
+
+int     rf_processor_sevr;
+assign  rf_processor_sevr to "{STN}:STN:RFP:MODU.SEVR";
+monitor rf_processor_sevr;
+evflag  rf_processor_sevr_ef;
+sync    rf_processor_sevr rf_processor_sevr_ef;
+
+int     ring;
+assign  ring to "{STN}:STN:RING:PLC";
+
+/* Recovery actions */
+
+int     lfbtaxi;
+assign  lfbtaxi to "";  /* Do dynamic assignment in init */
+
+int     taxichk;
+assign  taxichk to "{STN}:STN:GVF:MODU.TMCK";
+
+/* Outputs */
+
+int     health_mask;
+assign  health_mask to "{STN}:STN:HEALTH:MASK";
+
+string  health_string_c;
+assign  health_string_c to "{STN}:STN:HEALTH:STRING";
+
+int     taxi_count;
+assign  taxi_count to "{STN}:STN:HEALTH:TAXI:COUNT";
+
+int     resync_count;
+assign  resync_count to "{STN}:STN:HEALTH:RESYNC:COUNT";
+
+string  taxi_time_c;
+assign  taxi_time_c to "{STN}:STN:HEALTH:TAXI:TIME";
+
+string  gvf_time_c;
+assign  gvf_time_c to "{STN}:STN:HEALTH:GVF:TIME";
+
+string  rfp_time_c;
+assign  rfp_time_c to "{STN}:STN:HEALTH:RFP:TIME";
+
+string  resync_time_c;
+assign  resync_time_c to "{STN}:STN:HEALTH:RESYNC:TIME";
@@ -0,0 +1,26 @@
+/*=============================================================================
+
+  Abs:  Defines used by the In-IOC History Query Sequence
+
+  Name: rf_hist_defs.h
+
+  Prev: None
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+#define HIST_NPTS            500     /* # points in the trend waveforms     */
+#define HIST_REFRESH         10.0    /* sec. between refreshes of a query   */
+#define HIST_MAX_SPAN        (14 * 86400.0) /* longest span queried (sec.)  */
+
+/* Query statuses, these MUST match pv {STN}:HIST:STATUS */
+#define HIST_STATUS_GOOD     0
+#define HIST_STATUS_NONE     1       /* no such series                      */
+#define HIST_STATUS_SPAN     2       /* span out of range                   */
+#define HIST_STATUS_EMPTY    3       /* no samples in the span              */
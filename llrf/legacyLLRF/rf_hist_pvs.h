@@ -0,0 +1,62 @@
+/*=============================================================================
+
+  Abs:  Process Variables used by the In-IOC History Query Sequence
+
+  Name: rf_hist_pvs.h
+
+  Prev: rf_hist_defs.h        (HIST_NPTS)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/* Query - series name without the station prefix, and span in seconds */
+
+string  hist_name_c;
+assign  hist_name_c to "{STN}:HIST:NAME";
+monitor hist_name_c;
+evflag  hist_name_ef;
+sync    hist_name_c hist_name_ef;
+
+double  hist_span;
+assign  hist_span to "{STN}:HIST:SPAN";
+monitor hist_span;
+evflag  hist_span_ef;
+sync    hist_span hist_span_ef;
+
+int     hist_req;
+assign  hist_req to "{STN}:HIST:REQ";
+monitor hist_req;
+evflag  hist_req_ef;
+sync    hist_req hist_req_ef;
+
+/* Results - decimated trend and statistics over the whole span */
+
+float   hist_min[HIST_NPTS];
+assign  hist_min to "{STN}:HIST:MIN";
+
+float   hist_max[HIST_NPTS];
+assign  hist_max to "{STN}:HIST:MAX";
+
+float   hist_mean[HIST_NPTS];
+assign  hist_mean to "{STN}:HIST:MEAN";
+
+double  hist_range_min;
+assign  hist_range_min to "{STN}:HIST:RANGE:MIN";
+
+double  hist_range_max;
+assign  hist_range_max to "{STN}:HIST:RANGE:MAX";
+
+double  hist_range_mean;
+assign  hist_range_mean to "{STN}:HIST:RANGE:MEAN";
+
+int     hist_count;
+assign  hist_count to "{STN}:HIST:COUNT";
+
+int     hist_status;
+assign  hist_status to "{STN}:HIST:STATUS";
@@ -25,11 +25,41 @@
 
 /* File name: rf_hvps_loop_defs.h */
 
-/* Process at least every ten seconds no matter what. */
-#define HVPS_LOOP_MAX_INTERVAL  10.0 
+/* Slowest cycle (heartbeat) of the adaptive scheduler, rfSched.c.  The loop
+   also runs at this period if READY stops. */
+#define HVPS_LOOP_SLOW_PERIOD   5.0 
+#define HVPS_LOOP_SCHED_NAME    "HVPS:LOOP"
+/* Only a loop with good status, or turned off, may slow down. */
+#define HVPS_LOOP_STEADY(status) (((status) == HVPS_LOOP_STATUS_GOOD) || \
+                                  ((status) == HVPS_LOOP_STATUS_OFF))
 /* Allow 10 voltage out-of-tolerance conditions to happen before changing status. */
 #define HVPS_LOOP_MAX_VOLT_TOL  10 
 
+/* Names of the in-IOC history series (rfHist.c), prefixed by the station */
+#define HVPS_LOOP_HIST_VOLT     "HVPS:VOLT:LOOP"
+#define HVPS_LOOP_HIST_RBCK     "HVPS:VOLT"
+#define HVPS_LOOP_HIST_STATUS   "HVPS:LOOP:STATUS"
+
+/* Processing trend forecasts (rfCond.c).  The step up is scaled by the
+   headroom of the forecasts HORIZON sec. ahead, measured in decades of
+   vacuum below its MAJOR limit or in fractions of the gap voltage limit. */
+#define HVPS_LOOP_COND_HORIZON    10.0
+#define HVPS_LOOP_COND_DECADES    0.5
+#define HVPS_LOOP_COND_FRACTION   0.05
+#define HVPS_LOOP_COND_STEP_MAX   2.0
+
+/* Checkpoint for a bumpless restart (rfCkpt.c): name, age limit, and the
+   slots of the record */
+#define HVPS_LOOP_CKPT_NAME       "HVPS:LOOP"
+#define HVPS_LOOP_CKPT_AGE        (LOOP_CKPT_RESTART + HVPS_LOOP_SLOW_PERIOD)
+#define HVPS_LOOP_CKPT_STATE      0
+#define HVPS_LOOP_CKPT_STN        1
+#define HVPS_LOOP_CKPT_CTRL       2
+#define HVPS_LOOP_CKPT_VOLT       3
+#define HVPS_LOOP_CKPT_VOLT_TOL   4
+#define HVPS_LOOP_CKPT_CAVV_LIM   5
+#define HVPS_LOOP_CKPT_LEN        6
+
 /* Definitions for controlling the loop */
 #define HVPS_LOOP_CONTROL_OFF     0
 #define HVPS_LOOP_CONTROL_PROC    1 
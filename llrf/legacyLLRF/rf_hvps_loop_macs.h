@@ -50,9 +50,87 @@
                 prev_requested_hvps_voltage = requested_hvps_voltage;               \
                 history_hvps_voltage = requested_hvps_voltage;                      \
                 pvPut(history_hvps_voltage);                                        \
+                rfHistAdd(hist_volt_id, requested_hvps_voltage);                    \
+                rfHistAdd(hist_rbck_id, readback_hvps_voltage);                     \
                 } /* HVPS_LOOP_SET_VOLTAGE */
 
+/* Start new trends when processing begins */
+#define HVPS_LOOP_COND_RESET() {                                                    \
+                rfCondReset(&condVacm, TRUE);                                       \
+                rfCondReset(&condGapv, FALSE);                                      \
+                } /* HVPS_LOOP_COND_RESET */
+
+/* Add the worst vacuum and gap voltage to their trends, forecast both and
+   publish the step scale.  A reading with no forecast yet is left out of
+   the scale by passing it no limit. */
+#define HVPS_LOOP_COND_UPDATE() {                                                   \
+                rfCondAdd(&condVacm, cavity_vacuum_check);                          \
+                rfCondAdd(&condGapv, gap_voltage_check);                            \
+                cond_vacm_limit = cavity_vacuum_limit;                              \
+                cond_gapv_limit = gap_voltage_limit;                                \
+                if (rfCondForecast(&condVacm, HVPS_LOOP_COND_HORIZON,               \
+                                   &cond_vacm_rate, &cond_vacm_fcst)) {             \
+                   cond_vacm_rate = 0.0;                                            \
+                   cond_vacm_fcst = cavity_vacuum_check;                            \
+                   cond_vacm_limit = 0.0;                                           \
+                   }                                                                \
+                if (rfCondForecast(&condGapv, HVPS_LOOP_COND_HORIZON,               \
+                                   &cond_gapv_rate, &cond_gapv_fcst)) {             \
+                   cond_gapv_rate = 0.0;                                            \
+                   cond_gapv_fcst = gap_voltage_check;                              \
+                   cond_gapv_limit = 0.0;                                           \
+                   }                                                                \
+                cond_scale = rfCondScale(cond_vacm_fcst, cond_vacm_limit,           \
+                                         HVPS_LOOP_COND_DECADES,                    \
+                                         cond_gapv_fcst, cond_gapv_limit,           \
+                                         HVPS_LOOP_COND_FRACTION,                   \
+                                         HVPS_LOOP_COND_STEP_MAX);                  \
+                pvPut(cond_vacm_rate);                                              \
+                pvPut(cond_vacm_fcst);                                              \
+                pvPut(cond_gapv_rate);                                              \
+                pvPut(cond_gapv_fcst);                                              \
+                pvPut(cond_scale);                                                  \
+                } /* HVPS_LOOP_COND_UPDATE */
+
+/* Save the loop state every cycle for a bumpless restart (rfCkpt.c) */
+#define HVPS_LOOP_CKPT_SAVE() {                                                     \
+                ckpt_rec[HVPS_LOOP_CKPT_STATE]    = hvps_loop_state;                \
+                ckpt_rec[HVPS_LOOP_CKPT_STN]      = station_state;                  \
+                ckpt_rec[HVPS_LOOP_CKPT_CTRL]     = hvps_loop_ctrl;                 \
+                ckpt_rec[HVPS_LOOP_CKPT_VOLT]     = prev_requested_hvps_voltage;    \
+                ckpt_rec[HVPS_LOOP_CKPT_VOLT_TOL] = volt_tol_count;                 \
+                ckpt_rec[HVPS_LOOP_CKPT_CAVV_LIM] = cavv_lim_count;                 \
+                rfCkptSave(ckpt_id, ckpt_rec);                                      \
+                } /* HVPS_LOOP_CKPT_SAVE */
+
+/* Stage and commit the loop's section of the station snapshot (rfSnap.c) */
+#define HVPS_LOOP_SNAP() {                                                          \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_STATE,     hvps_loop_state);        \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_STATUS,    hvps_loop_status);       \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_CTRL,      hvps_loop_ctrl);         \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_VOLT_CTRL, requested_hvps_voltage); \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_VOLT,      readback_hvps_voltage);  \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_VOLT_TOL,  volt_tol_count);         \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_CAVV_LIM,  cavv_lim_count);         \
+                rfSnapPut(snap_id, RF_SNAP_HVPS_PERIOD,    sched_period);           \
+                rfSnapCommit(snap_id, RF_SNAP_SEC_HVPS);                            \
+                } /* HVPS_LOOP_SNAP */
+
+/* True when the checkpoint is fresh, was taken processing or on with the
+   station state and loop control still the same, and the readback agrees
+   with the voltage last requested */
+#define HVPS_LOOP_CKPT_RESUME()                                                     \
+        ((rfCkptLoad(ckpt_id, ckpt_rec, HVPS_LOOP_CKPT_AGE) == RF_CKPT_OK)     &&   \
+         ((ckpt_rec[HVPS_LOOP_CKPT_STATE] == HVPS_LOOP_STATE_PROC) ||               \
+          (ckpt_rec[HVPS_LOOP_CKPT_STATE] == HVPS_LOOP_STATE_ON))               &&   \
+         (ckpt_rec[HVPS_LOOP_CKPT_STN]  == station_state)                      &&   \
+         (ckpt_rec[HVPS_LOOP_CKPT_CTRL] == hvps_loop_ctrl)                     &&   \
+         (!LOOP_INVALID_SEVERITY(pvSeverity(readback_hvps_voltage)))           &&   \
+         (fabs(readback_hvps_voltage - ckpt_rec[HVPS_LOOP_CKPT_VOLT]) <=            \
+          allowed_hvps_voltage_diff))
+
 #define HVPS_LOOP_CHECK_STATUS() {                                                         \
+            rfHistAdd(hist_status_id, hvps_loop_status);                                   \
             /* Check for hvps loop status change */                                        \
             if (prev_hvps_loop_status != hvps_loop_status) {                               \
                                                                                            \
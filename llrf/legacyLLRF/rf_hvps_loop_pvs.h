@@ -44,6 +44,15 @@ assign  hvps_loop_delay to "{STN}:HVPS:LOOP:DELAY";
 
 string  hvps_loop_status_c;
 assign  hvps_loop_status_c to "{STN}:HVPS:LOOP:STRING";
+
+float   sched_period;
+assign  sched_period to "{STN}:HVPS:LOOP:SCHED:PERIOD";
+
+int     sched_decision;
+assign  sched_decision to "{STN}:HVPS:LOOP:SCHED:DECISION";
+
+float   sched_activity;
+assign  sched_activity to "{STN}:HVPS:LOOP:SCHED:ACTIVITY";
   
 int     hvps_loop_ready;
 assign  hvps_loop_ready to "{STN}:HVPS:LOOP:READY";
@@ -71,7 +80,9 @@ int     cavity_vacuum_sevr;
 assign  cavity_vacuum_sevr to "{STN}:CAVVACM:SUMY:SEVR.SEVR"; 
 monitor cavity_vacuum_sevr;
 
-int     cavity_vacuum_check; 
+/* Worst cavity vacuum; its severity stops the loop and its value feeds
+   the processing trend forecasts (rfCond.c) */
+float   cavity_vacuum_check; 
 assign  cavity_vacuum_check to "{STN}:CAVVACM:CHECK"; 
 monitor cavity_vacuum_check;
 
@@ -87,10 +98,41 @@ int     dp_error_stat;
 assign  dp_error_stat     to "{STN}:KLYSDRIVFRWD:POWER:ERR.STAT";
 monitor dp_error_stat;
 
-int     gap_voltage_check;
+/* Worst gap voltage, used as cavity_vacuum_check */
+float   gap_voltage_check;
 assign  gap_voltage_check to "{STN}:CAVVOLT:CHECK"; 
 monitor gap_voltage_check;
 
+/* MAJOR limits of the two CHECK records, for the forecasts.  Assumes the
+   records raise MAJOR at HIHI (HHSV = MAJOR); one that raises it at HIGH
+   instead must be pointed at .HIGH here. */
+float   cavity_vacuum_limit;
+assign  cavity_vacuum_limit to "{STN}:CAVVACM:CHECK.HIHI";
+monitor cavity_vacuum_limit;
+
+float   gap_voltage_limit;
+assign  gap_voltage_limit to "{STN}:CAVVOLT:CHECK.HIHI";
+monitor gap_voltage_limit;
+
+int     cond_ctrl;
+assign  cond_ctrl to "{STN}:HVPS:COND:CTRL";
+monitor cond_ctrl;
+
+double  cond_vacm_rate;
+assign  cond_vacm_rate to "{STN}:HVPS:COND:VACM:RATE";
+
+double  cond_vacm_fcst;
+assign  cond_vacm_fcst to "{STN}:HVPS:COND:VACM:FCST";
+
+double  cond_gapv_rate;
+assign  cond_gapv_rate to "{STN}:HVPS:COND:GAPV:RATE";
+
+double  cond_gapv_fcst;
+assign  cond_gapv_fcst to "{STN}:HVPS:COND:GAPV:FCST";
+
+double  cond_scale;
+assign  cond_scale to "{STN}:HVPS:COND:SCALE";
+
 float   requested_hvps_voltage;
 assign  requested_hvps_voltage to "{STN}:HVPS:VOLT:CTRL";
 
@@ -12,4 +12,9 @@
 #define MACRO_RING_NAME "RING"
 #define MACRO_REG_NAME  "REG"
 #define MACRO_IOC_NAME  "IOC"
+#define MACRO_CKPT_NAME "CKPT"
+
+/* Seconds an IOC restart may take and still resume the loops from their
+   checkpoints (rfCkpt.c); each loop adds its slowest cycle */
+#define LOOP_CKPT_RESTART    30.0
 
@@ -11,3 +11,15 @@
             ((arg_pvSeverity) >= MINOR_ALARM)                             \
             ) /* LOOP_MINOR_SEVERITY */
 
+/* Report a loop cycle to the adaptive scheduler (rfSched.c) and publish
+   its period, decision and activity when the period or decision change */
+#define LOOP_SCHED_RUN(id, err, scale, steady, period, decision, activity) \
+{                                                                          \
+        if (rfSchedRun(id, err, scale, steady))                            \
+        {                                                                  \
+          rfSchedGet(id, &period, &decision, &activity);                   \
+          pvPut(period);                                                   \
+          pvPut(decision);                                                 \
+          pvPut(activity);                                                 \
+        }                                                                  \
+} /* LOOP_SCHED_RUN */
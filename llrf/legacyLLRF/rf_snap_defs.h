@@ -0,0 +1,20 @@
+/*=============================================================================
+
+  Abs:  Defines used by the Station Status Snapshot Sequence
+
+  Name: rf_snap_defs.h
+
+  Prev: None
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+#define SNAP_LEN             75      /* MUST match RF_SNAP_LEN of rfSnap.h  */
+#define SNAP_MIN_PERIOD      0.2     /* min. sec. between snapshot puts     */
+#define SNAP_REFRESH         5.0     /* max. sec. between snapshot puts     */
@@ -0,0 +1,53 @@
+/*=============================================================================
+
+  Abs:  Process Variables used by the Station Status Snapshot Sequence
+
+  Name: rf_snap_pvs.h
+
+  Prev: rf_snap_defs.h        (SNAP_LEN)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/* Station words of the snapshot, each change republishes it */
+
+int     station_state;
+assign  station_state to "{STN}:STN:STATE:RBCK";
+monitor station_state;
+evflag  station_state_ef;
+sync    station_state station_state_ef;
+
+int     station_ctrl;
+assign  station_ctrl to "{STN}:STN:STATE:CTRL";
+monitor station_ctrl;
+evflag  station_ctrl_ef;
+sync    station_ctrl station_ctrl_ef;
+
+int     reset_count;
+assign  reset_count to "{STN}:STN:RESET:COUNTER";
+monitor reset_count;
+evflag  reset_count_ef;
+sync    reset_count reset_count_ef;
+
+int     fault_num;
+assign  fault_num to "{STN}:STN:FAULT:NUM";
+monitor fault_num;
+evflag  fault_num_ef;
+sync    fault_num fault_num_ef;
+
+int     fault_anum;
+assign  fault_anum to "{STN}:STN:FAULT:ANUM";
+monitor fault_anum;
+evflag  fault_anum_ef;
+sync    fault_anum fault_anum_ef;
+
+/* The snapshot, layout in rfSnap.h */
+
+double  snap[SNAP_LEN];
+assign  snap to "{STN}:STN:SNAP";
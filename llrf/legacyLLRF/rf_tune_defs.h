@@ -0,0 +1,20 @@
+/*=============================================================================
+
+  Abs:  Defines used by the Tune Measurement Sequence
+
+  Name: rf_tune_defs.h
+
+  Prev: None
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+#define TUNE_NRESP           2048    /* # samples in a response waveform    */
+#define TUNE_NBINS           128     /* # frequencies in the bank/spectrum  */
+#define TUNE_TICKLE_ON       1       /* {STN}:STN:TICKLE:CTRL on            */
@@ -0,0 +1,94 @@
+/*=============================================================================
+
+  Abs:  Process Variables used by the Tune Measurement Sequence
+
+  Name: rf_tune_pvs.h
+
+  Prev: rf_tune_defs.h        (TUNE_NRESP, TUNE_NBINS)
+
+  Auth: 19-Oct-2026, RF Controls
+  Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name)
+
+------------------------------------------------------------------------------
+
+  Mod:
+
++============================================================================*/
+
+/* Tickle control and excitation files, as used by rf_states */
+
+int     tickle;
+assign  tickle to "{STN}:STN:TICKLE:CTRL";
+monitor tickle;
+
+string  tifile;
+assign  tifile to "{STN}:STN:TICKLE:IFILE";
+
+string  tqfile;
+assign  tqfile to "{STN}:STN:TICKLE:QFILE";
+
+int     station_state;
+assign  station_state to "{STN}:STN:STATE:RBCK";
+monitor station_state;
+
+/* Station I & Q response.  The capture processes I then Q, so a new
+   block is flagged by the Q monitor. */
+
+float   resp_i[TUNE_NRESP];
+assign  resp_i to "{STN}:STN:TICKLE:RESP:I";
+monitor resp_i;
+
+float   resp_q[TUNE_NRESP];
+assign  resp_q to "{STN}:STN:TICKLE:RESP:Q";
+monitor resp_q;
+evflag  resp_ef;
+sync    resp_q resp_ef;
+
+/* Bank setup - response sample rate, search band (Hz from the carrier)
+   and # blocks averaged.  Any change sets up the bank again. */
+
+evflag  band_ef;
+
+double  tune_rate;
+assign  tune_rate to "{STN}:STN:TICKLE:RATE";
+monitor tune_rate;
+sync    tune_rate band_ef;
+
+double  tune_low;
+assign  tune_low to "{STN}:STN:TUNE:LOW";
+monitor tune_low;
+sync    tune_low band_ef;
+
+double  tune_high;
+assign  tune_high to "{STN}:STN:TUNE:HIGH";
+monitor tune_high;
+sync    tune_high band_ef;
+
+int     tune_navg;
+assign  tune_navg to "{STN}:STN:TUNE:NAVG";
+monitor tune_navg;
+sync    tune_navg band_ef;
+
+double  tune_frev;
+assign  tune_frev to "{STN}:STN:TUNE:FREV";
+monitor tune_frev;
+
+/* Results */
+
+double  tune_freq;
+assign  tune_freq to "{STN}:STN:TUNE:FREQ";
+
+double  tune;
+assign  tune to "{STN}:STN:TUNE";
+
+double  tune_conf;
+assign  tune_conf to "{STN}:STN:TUNE:CONF";
+
+double  tune_gain;
+assign  tune_gain to "{STN}:STN:TUNE:GAIN";
+
+int     tune_status;
+assign  tune_status to "{STN}:STN:TUNE:STATUS";
+
+float   tune_spectrum[TUNE_NBINS];
+assign  tune_spectrum to "{STN}:STN:TUNE:SPECTRUM";
@@ -12,10 +12,18 @@
 ------------------------------------------------------------------------------
 
   Mod:
+	19-Oct-2026, RF Controls
+	   Added Galil controller backend defines.
+	   Replaced LOOP_MAX_DELAY by the adaptive scheduler heartbeat.
+	   Added LOOP_EST_NOISE_K for the detuning estimator.
+	   Added the LOOP_CKPT defines for the restart checkpoint.
 
 +============================================================================*/
 
-#define LOOP_MAX_DELAY   60.0 /* max # seconds between loop cycles         */
+#define LOOP_SLOW_PERIOD 20.0 /* slowest loop cycle (sec.) - rfSched.c     */
+#define LOOP_SCHED_FORMAT "CAV%sTUNR:LOOP" /* scheduler name from CAV    */
+#define LOOP_EST_NOISE_K  3.0 /* estimator posn deltas within this many
+                                 noise std. errors are not moved on      */
 #define LOOP_NONFUNC_INTERVAL 1   /* # times that loop can miss a beat     */
 #define LOOP_DMOV_MEAS        1   /* # meas after SM is done moving        */
 #define LOOP_NOMOV_COUNT      5   /* # times attempts are made to move SM
@@ -78,3 +86,25 @@
 
 /* Definitions for some stepper motor attributes */
 #define SM_DONE_MOVING       1
+
+/* Only a loop that is good or off with the tuner at rest may slow down */
+#define LOOP_STEADY(status, dmov) ((((status) == LOOP_GOOD_STATUS) ||   \
+                                    ((status) == LOOP_OFF_STATUS))  &&  \
+                                   ((dmov) == SM_DONE_MOVING))
+
+/* Definitions for the Galil controller backend (see rfGalil.c) */
+#define MACRO_GALIL_NAME     "GALIL" /* controller name from rfGalilConfig */
+#define MACRO_AXIS_NAME      "AXIS"  /* controller axis letter of the cav  */
+#define TUNER_GALIL_NONE     (-1)    /* no controller - use motor record   */
+#define LOOP_MOVE_TIMEOUT    ((LOOP_MOVE_COUNT+1)*LOOP_MOVE_DELAY/60.0)
+                                     /* max # seconds to wait for a move   */
+
+/* Definitions for the restart checkpoint (see rfCkpt.c) */
+#define LOOP_CKPT_AGE        (LOOP_CKPT_RESTART + LOOP_SLOW_PERIOD)
+                                     /* oldest checkpoint resumed (sec.)   */
+#define LOOP_CKPT_STATE      0       /* slots of the checkpoint record     */
+#define LOOP_CKPT_STN        1
+#define LOOP_CKPT_CTRL       2
+#define LOOP_CKPT_POSN       3
+#define LOOP_CKPT_NOMOV      4
+#define LOOP_CKPT_LEN        5
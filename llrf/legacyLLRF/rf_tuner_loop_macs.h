@@ -11,6 +11,12 @@
         loop_defs.h           (LOOP* macros)
         tuner_loop_defs.h     (LOOP* defines)
         tuner_loop_pvs.h      (tuner loop process variable names)
+        %%rfGalil.h           (Galil controller prototypes)
+        %%rfDetune.h          (detuning estimator prototypes)
+        %%math.h              (fabs prototype)
+        %%rfFfwd.h            (feed-forward model prototypes)
+        %%rfCkpt.h            (restart checkpoint prototypes)
+        %%rfSnap.h            (station snapshot prototypes)
 
   Auth: 31-Oct-1996, Stephanie Allison
   Rev:  DD-MMM-YYYY, Reviewer's Name (.NE. Author's Name) 
@@ -18,6 +24,18 @@
 ------------------------------------------------------------------------------
 
   Mod:
+	19-Oct-2026, RF Controls
+	   Added TUNER_LOOP_SM_GET, TUNER_LOOP_SM_MOVE and TUNER_LOOP_SM_WAIT
+	   so the loop can drive the tuner through a Galil controller
+	   instead of the motor record.
+	   Added TUNER_LOOP_DELTA_GET to take posn delta from the station
+	   detuning estimator when it is enabled.
+	   Added TUNER_LOOP_FFWD_LEARN and TUNER_LOOP_FFWD_MOVE for the
+	   beam current and forward power feed-forward.
+	   Added TUNER_LOOP_CKPT_SAVE, TUNER_LOOP_CKPT_RESUME and
+	   TUNER_LOOP_CKPT_RESTORE for the restart checkpoint.
+	   Added TUNER_LOOP_SNAP for the station snapshot, also done by
+	   TUNER_LOOP_STATE_UPDATE.
 
 +============================================================================*/
 
@@ -36,6 +54,36 @@
 						           (loop_status)\
 )
 
+/*
+ * Posn delta and its severity.  With the estimator on, a stale or bad
+ * estimate reads as an invalid measurement and a delta within the
+ * noise is taken as no change.
+ */
+#define TUNER_LOOP_DELTA_GET(get_status, sevr)				\
+{									\
+  if (est_ctrl == LOOP_CONTROL_ON)					\
+  {									\
+    if (rfDetuneDelta(est_id, est_cav, &posn_delta, &est_noise) ==	\
+        RF_DETUNE_OK)							\
+    {									\
+      get_status = pvStatOK;						\
+      sevr       = NO_ALARM;						\
+      if (fabs(posn_delta) < LOOP_EST_NOISE_K * est_noise)		\
+        posn_delta = 0.0;						\
+    }									\
+    else								\
+    {									\
+      get_status = pvStatERROR;						\
+      sevr       = INVALID_ALARM;					\
+    }									\
+  }									\
+  else									\
+  {									\
+    get_status = pvGet(posn_delta);					\
+    sevr       = pvSeverity(posn_delta);				\
+  }									\
+}
+
 %%#define TUNER_LOOP_LDANG_STATUS(sevr)\
 (								    \
   ((sevr) > MINOR_ALARM) ? LOOP_LDANGLIM_STATUS : LOOP_GOOD_STATUS  \
@@ -56,6 +104,7 @@
   efClear(loop_home_park_ef);                                       \
   if ((reset_needed)&&(loop_ctrl == LOOP_CONTROL_ON)) efSet  (loop_reset_ef);\
   else                                                efClear(loop_reset_ef);\
+  TUNER_LOOP_SNAP();                                                \
 }
 /*
 
@@ -88,3 +137,166 @@
                 loop_name_c, home_name);				\
   }									\
 }
+/*
+
+*/
+/*
+ * Stepper motor access.  With a Galil controller (galil_id valid) the
+ * readback, done-moving and alarm come from the driver's batched status
+ * and moves are queued to the driver; otherwise the motor record is used.
+ */
+#define TUNER_LOOP_SM_GET(get_status)					\
+{									\
+  if (galil_id != TUNER_GALIL_NONE)					\
+  {									\
+    if (rfGalilStatus(galil_id, galil_axis, &sm_posn, &sm_dmov,		\
+                      &sm_stat, &sm_sevr) == RF_GALIL_OK)		\
+      get_status = pvStatOK;						\
+    else								\
+      get_status = pvStatERROR;						\
+  }									\
+  else									\
+  {									\
+    get_status = pvGet(sm_posn);					\
+    sm_sevr    = pvSeverity(sm_posn);					\
+    sm_stat    = pvStatus(sm_posn);					\
+  }									\
+}
+
+#define TUNER_LOOP_SM_MOVE()						\
+{									\
+  if (galil_id != TUNER_GALIL_NONE)					\
+  {									\
+    rfGalilMove(galil_id, galil_axis, posn_ctrl);			\
+    sm_dmov = !SM_DONE_MOVING;						\
+  }									\
+  else									\
+  {									\
+    pvPut(posn_ctrl);							\
+  }									\
+}
+
+#define TUNER_LOOP_SM_WAIT()						\
+{									\
+  if (galil_id != TUNER_GALIL_NONE)					\
+  {									\
+    rfGalilWaitDone(galil_id, galil_axis, LOOP_MOVE_TIMEOUT);		\
+    efClear(sm_done_ef);						\
+    TUNER_LOOP_SM_GET(get_status);					\
+  }									\
+  else									\
+  {									\
+    taskDelay(LOOP_MOVE_DELAY);						\
+    delay_count = 0;							\
+    while ((delay_count < LOOP_MOVE_COUNT) &&				\
+           (sm_dmov != SM_DONE_MOVING))					\
+    {									\
+      taskDelay(LOOP_MOVE_DELAY);					\
+      delay_count++;							\
+    }									\
+  }									\
+}
+
+/*
+ * Feed-forward.  A good cycle teaches the model where the tuner settles
+ * for the present beam current and forward power.  Between cycles, a
+ * change in those that the model says moves the tuner by RDBD or more
+ * pre-positions it, and the loop waits for a measurement after the move.
+ * Below the minimum forward power, as on a klystron trip, nothing moves
+ * and the mark is kept, so on recovery the tuner is still where the
+ * model has it for the inputs before the trip.
+ */
+#define TUNER_LOOP_FFWD_LEARN()						\
+{									\
+  if ((station_state != STATION_PARK)                         &&	\
+      ((loop_status == LOOP_GOOD_STATUS) ||				\
+       (loop_status == LOOP_LDANGLIM_STATUS))                 &&	\
+      (!LOOP_INVALID_SEVERITY(pvSeverity(beam_curr))))			\
+  {									\
+    rfFfwdLearn(ffwd_id, beam_curr, klys_frwd_pwr, sm_posn + posn_delta);\
+    rfFfwdGet(ffwd_id, &ffwd_beam_coef, &ffwd_pwr_coef, &ffwd_resid);	\
+    pvPut(ffwd_beam_coef);						\
+    pvPut(ffwd_pwr_coef);						\
+    pvPut(ffwd_resid);							\
+  }									\
+}
+
+#define TUNER_LOOP_FFWD_MOVE()						\
+{									\
+  if ((!LOOP_INVALID_SEVERITY(pvSeverity(klys_frwd_pwr)))     &&	\
+      (!LOOP_INVALID_SEVERITY(pvSeverity(beam_curr)))         &&	\
+      (klys_frwd_pwr >= klys_frwd_pwr_min)                    &&	\
+      (rfFfwdStep(ffwd_id, beam_curr, klys_frwd_pwr,			\
+                  &ffwd_step) == RF_FFWD_OK)                  &&	\
+      (fabs(ffwd_step) >= sm_rdbd))					\
+  {									\
+    TUNER_LOOP_SM_GET(get_status);					\
+    if (TUNER_LOOP_POSN_STATUS(get_status, sm_sevr, sm_stat) ==		\
+        LOOP_GOOD_STATUS)						\
+    {									\
+      posn_ctrl = sm_posn + ffwd_step;					\
+      if (posn_ctrl > sm_drvh) posn_ctrl = sm_drvh;			\
+      if (posn_ctrl < sm_drvl) posn_ctrl = sm_drvl;			\
+      TUNER_LOOP_SM_MOVE();						\
+      rfFfwdMark(ffwd_id, beam_curr, klys_frwd_pwr);			\
+      pvPut(ffwd_step);							\
+      dmov_meas_count = 0;						\
+    }									\
+  }									\
+}
+
+#define TUNER_LOOP_CKPT_SAVE()						\
+{									\
+  ckpt_rec[LOOP_CKPT_STATE] = loop_state;				\
+  ckpt_rec[LOOP_CKPT_STN]   = station_state;				\
+  ckpt_rec[LOOP_CKPT_CTRL]  = prev_loop_ctrl;				\
+  ckpt_rec[LOOP_CKPT_POSN]  = posn_ctrl;				\
+  ckpt_rec[LOOP_CKPT_NOMOV] = nomov_count;				\
+  rfCkptSave(ckpt_id, ckpt_rec);					\
+}
+
+/* Stage and commit this cavity's section of the station snapshot;
+   cavities past RF_SNAP_MAX_CAVS have none */
+#define TUNER_LOOP_SNAP()						\
+{									\
+  if ((snap_cav >= 0) && (snap_cav < RF_SNAP_MAX_CAVS))			\
+  {									\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_STATE,	\
+              loop_state);						\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_STATUS,	\
+              loop_status);						\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_CTRL,	\
+              loop_ctrl);						\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_POSN_CTRL,	\
+              posn_ctrl);						\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_POSN,	\
+              sm_posn);							\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_NOMOV,	\
+              nomov_count);						\
+    rfSnapPut(snap_id, RF_SNAP_TUNR(snap_cav) + RF_SNAP_TUNR_PERIOD,	\
+              sched_period);						\
+    rfSnapCommit(snap_id, RF_SNAP_SEC_TUNR(snap_cav));			\
+  }									\
+}
+
+/* True when the checkpoint is fresh, was taken on in the same station
+   state, and the tuner is at rest where the loop last put it */
+#define TUNER_LOOP_CKPT_RESUME(get_status)				\
+(									\
+  (rfCkptLoad(ckpt_id, ckpt_rec, LOOP_CKPT_AGE) == RF_CKPT_OK) &&	\
+  (ckpt_rec[LOOP_CKPT_STATE] == LOOP_ON)                       &&	\
+  (station_state != STATION_OFF)                               &&	\
+  (ckpt_rec[LOOP_CKPT_STN] == station_state)                   &&	\
+  ((get_status) == pvStatOK)                                   &&	\
+  (!LOOP_INVALID_SEVERITY(sm_sevr))                            &&	\
+  (sm_dmov == SM_DONE_MOVING)                                  &&	\
+  (fabs(sm_posn - ckpt_rec[LOOP_CKPT_POSN]) <= sm_rdbd)			\
+)
+
+/* Call after TUNER_LOOP_INIT_FLAGS, which clears nomov_count */
+#define TUNER_LOOP_CKPT_RESTORE()					\
+{									\
+  prev_loop_ctrl = ckpt_rec[LOOP_CKPT_CTRL];				\
+  posn_ctrl      = ckpt_rec[LOOP_CKPT_POSN];				\
+  nomov_count    = ckpt_rec[LOOP_CKPT_NOMOV];				\
+}
@@ -12,6 +12,10 @@
 ------------------------------------------------------------------------------
 
   Mod:
+	19-Oct-2026, RF Controls
+	   Added sm_done_ef for the Galil controller backend.
+	   Added est_ctrl for the station detuning estimator.
+	   Added beam current and FFWD PVs for tuner feed-forward.
 
 +============================================================================*/
 
@@ -75,6 +79,15 @@ assign  loop_status to "{STN}:CAV{CAV}TUNR:LOOP:STATUS";
   
 string  loop_status_string_c;
 assign  loop_status_string_c to "{STN}:CAV{CAV}TUNR:LOOP:STRING";
+
+float   sched_period;
+assign  sched_period to "{STN}:CAV{CAV}TUNR:LOOP:SCHED:PERIOD";
+
+int     sched_decision;
+assign  sched_decision to "{STN}:CAV{CAV}TUNR:LOOP:SCHED:DECISION";
+
+float   sched_activity;
+assign  sched_activity to "{STN}:CAV{CAV}TUNR:LOOP:SCHED:ACTIVITY";
   
 int     station_state;
 assign  station_state to "{STN}:STN:STATE:RBCK";
@@ -98,6 +111,11 @@ assign  posn_new       to "{STN}:CAV{CAV}TUNR:POSN:LOOP";
 float   posn_delta;
 assign  posn_delta     to "{STN}:CAV{CAV}TUNR:POSN:DELTA";
 
+/* On, posn delta comes from the station detuning estimator (rfDetune.c) */
+int     est_ctrl;
+assign  est_ctrl       to "{STN}:CAVTUNR:EST:CTRL";
+monitor est_ctrl;
+
 float   posn_park_home;
 assign  posn_park_home to "{STN}:CAV{CAV}TUNR:POSN:PARKHOME";
 
@@ -123,14 +141,43 @@ float   sm_rdbd;
 assign  sm_rdbd to "{STN}:CAV{CAV}TUNR:STEP:MOTOR.RDBD";
 monitor sm_rdbd;
 
+/* Set by the Galil driver on motion complete when GALIL is given */
+evflag  sm_done_ef;
+
+/* Feed-forward inputs - any change may pre-position the tuner */
+evflag  ffwd_ef;
+
 float   klys_frwd_pwr;
 assign  klys_frwd_pwr     to "{STN}:KLYSOUTFRWD:POWER";
 monitor klys_frwd_pwr;
+sync    klys_frwd_pwr ffwd_ef;
+
+float   beam_curr;
+assign  beam_curr         to "{STN}:STN:BEAM:CURRENT";
+monitor beam_curr;
+sync    beam_curr ffwd_ef;
 
 float   klys_frwd_pwr_min;
 assign  klys_frwd_pwr_min to "{STN}:KLYSOUTFRWD:POWER:MIN";
 monitor klys_frwd_pwr_min;
 
+/* Feed-forward control and model (see rfFfwd.c) */
+int     ffwd_ctrl;
+assign  ffwd_ctrl      to "{STN}:CAVTUNR:FFWD:CTRL";
+monitor ffwd_ctrl;
+
+float   ffwd_step;
+assign  ffwd_step      to "{STN}:CAV{CAV}TUNR:FFWD:STEP";
+
+double  ffwd_beam_coef;
+assign  ffwd_beam_coef to "{STN}:CAV{CAV}TUNR:FFWD:BEAM";
+
+double  ffwd_pwr_coef;
+assign  ffwd_pwr_coef  to "{STN}:CAV{CAV}TUNR:FFWD:POWR";
+
+double  ffwd_resid;
+assign  ffwd_resid     to "{STN}:CAV{CAV}TUNR:FFWD:RESID";
+
 int     load_angle_sevr;
 assign  load_angle_sevr to "{STN}:CAV{CAV}LOAD:ANGLE:ERR.SEVR";
 monitor load_angle_sevr;
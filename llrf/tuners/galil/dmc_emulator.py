@@ -0,0 +1,404 @@
+"""
+DMC-41x3 Command Set Emulator
+=============================
+
+TCP emulator of the subset of the Galil DMC-41x3 command set used by the
+tuner driver (llrf/legacyLLRF/rfGalil.c) and by hand during commissioning
+(see firstMotion2024.txt and functioningGalil20250825SwapABToManual.txt).
+It lets the tuner loop and the driver run offline without a controller.
+
+Protocol (as on the real controller over Ethernet):
+    Commands are terminated by CR and may be chained with ';'. Each
+    command answers with its output (if any) followed by ':' on
+    success, or '?' on error, after which the rest of the line is
+    discarded. ``TC1`` returns the code and text of the last error.
+
+Commands:
+    PA PR SP AC DC      per-axis values, either ``PA 10,,30`` or ``PAB=20``;
+                        ``SPA=?`` queries one axis
+    BG ST AB SH MO      motion and servo control, optional axis list
+    TP TS               tell position / switches of all or listed axes
+    MG                  message: numbers, "strings" and operands
+                        _TPx _RPx _BGx _TSx _MOx _LFx _LRx _SPx _ACx _DCx
+    TC1 ID              last error, identification
+    MT YA AG AU KP KI KD ER OE CN  accepted and stored, no effect
+
+Motion is a trapezoidal profile integrated in 1 ms steps against the
+wall clock. Limit switches trip at ``--fls``/``--rls`` counts; a BG
+towards an active limit fails with error 22, as on the station.
+
+Usage:
+    python3 llrf/tuners/galil/dmc_emulator.py --port 5023 --axes 4
+
+    # in the IOC
+    rfGalilConfig("RRRS", "localhost", 5023, 4, 50)
+"""
+
+import argparse
+import re
+import socketserver
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional
+
+FIRMWARE = "DMC4143 Rev 1.3h"
+TIME_STEP = 0.001
+
+ERRORS = {
+    1: "Unrecognized command",
+    6: "Number out of range",
+    7: "Command not valid while running",
+    20: "Begin not valid with motor off",
+    22: "Begin not possible due to limit switch",
+    58: "Bad command response",
+}
+
+# TS switch byte bits (rfGalil.h RF_GALIL_TS_*)
+TS_HOME = 0x02
+TS_RLS_OFF = 0x04
+TS_FLS_OFF = 0x08
+TS_MOTOR_OFF = 0x20
+TS_MOVING = 0x80
+
+STORED = ('MT', 'YA', 'AG', 'AU', 'KP', 'KI', 'KD', 'ER', 'OE', 'CN')
+
+
+class DmcError(Exception):
+    """Command failure carrying a controller error code."""
+
+    def __init__(self, code: int):
+        super().__init__(ERRORS.get(code, "Error"))
+        self.code = code
+
+
+@dataclass
+class Axis:
+    """One axis: trapezoidal profiler and limit switches.
+
+    Positions are in counts, speeds in counts/s, accelerations in
+    counts/s^2. The motor starts off, as after power-up.
+    """
+    fls: float
+    rls: float
+    sp: float = 25000.0
+    ac: float = 256000.0
+    dc: float = 256000.0
+    pos: float = 0.0
+    vel: float = 0.0
+    target: float = 0.0
+    moving: bool = False
+    stopping: bool = False
+    motor_on: bool = False
+    params: Dict[str, float] = field(default_factory=dict)
+
+    @property
+    def at_fls(self) -> bool:
+        return self.pos >= self.fls
+
+    @property
+    def at_rls(self) -> bool:
+        return self.pos <= self.rls
+
+    @property
+    def switches(self) -> int:
+        ts = TS_HOME
+        if not self.at_fls:
+            ts |= TS_FLS_OFF
+        if not self.at_rls:
+            ts |= TS_RLS_OFF
+        if not self.motor_on:
+            ts |= TS_MOTOR_OFF
+        if self.moving:
+            ts |= TS_MOVING
+        return ts
+
+    def begin(self):
+        if self.moving:
+            raise DmcError(7)
+        if not self.motor_on:
+            raise DmcError(20)
+        if ((self.target > self.pos and self.at_fls) or
+                (self.target < self.pos and self.at_rls)):
+            raise DmcError(22)
+        self.moving = self.target != self.pos
+        self.stopping = False
+
+    def stop(self, abort: bool = False):
+        if abort:
+            self.vel = 0.0
+            self.moving = False
+        elif self.moving:
+            self.stopping = True
+
+    def step(self, dt: float):
+        """Advance the profile by dt seconds."""
+        if not self.moving:
+            return
+        remaining = self.target - self.pos
+        direction = 1.0 if remaining > 0 else -1.0
+        speed = abs(self.vel)
+        stop_dist = speed * speed / (2.0 * self.dc)
+        if self.stopping or abs(remaining) <= stop_dist:
+            speed = max(speed - self.dc * dt, 0.0)
+        else:
+            speed = min(speed + self.ac * dt, self.sp)
+        move = direction * speed * dt
+        if abs(move) >= abs(remaining) or (speed == 0.0 and
+                                            (self.stopping or
+                                             abs(remaining) < 1.0)):
+            if not self.stopping:
+                self.pos = self.target
+            self.vel = 0.0
+            self.moving = False
+            return
+        self.pos += move
+        self.vel = direction * speed
+        if (direction > 0 and self.at_fls) or (direction < 0 and self.at_rls):
+            self.vel = 0.0
+            self.moving = False
+
+
+class Controller:
+    """Command interpreter shared by all client connections."""
+
+    def __init__(self, naxes: int = 4, fls: float = 1e7, rls: float = -1e7):
+        self.letters = "ABCDEFGH"[:naxes]
+        self.axes = [Axis(fls=fls, rls=rls) for _ in self.letters]
+        self.last_error = 0
+        self.lock = threading.Lock()
+        self.clock = time.monotonic()
+
+    # -- time -------------------------------------------------------------
+
+    def update(self):
+        now = time.monotonic()
+        steps = int((now - self.clock) / TIME_STEP)
+        if steps <= 0:
+            return
+        self.clock += steps * TIME_STEP
+        for axis in self.axes:
+            for _ in range(steps):
+                if not axis.moving:
+                    break
+                axis.step(TIME_STEP)
+
+    # -- parsing helpers --------------------------------------------------
+
+    def _axis_index(self, letter: str) -> int:
+        index = self.letters.find(letter.upper())
+        if index < 0 or not letter:
+            raise DmcError(1)
+        return index
+
+    def _axis_list(self, arg: str) -> List[int]:
+        arg = arg.strip()
+        if not arg:
+            return list(range(len(self.axes)))
+        return [self._axis_index(c) for c in arg if not c.isspace()]
+
+    @staticmethod
+    def _number(text: str) -> float:
+        try:
+            return float(text)
+        except ValueError:
+            raise DmcError(6)
+
+    @staticmethod
+    def _format(value: float) -> str:
+        return " %.4f" % value
+
+    def _operand(self, name: str) -> float:
+        name = name.upper()
+        if len(name) != 4 or name[0] != '_':
+            raise DmcError(1)
+        axis = self.axes[self._axis_index(name[3])]
+        key = name[1:3]
+        if key in ('TP', 'RP'):
+            return round(axis.pos)
+        if key == 'BG':
+            return 1.0 if axis.moving else 0.0
+        if key == 'TS':
+            return axis.switches
+        if key == 'MO':
+            return 0.0 if axis.motor_on else 1.0
+        if key == 'LF':
+            return 0.0 if axis.at_fls else 1.0
+        if key == 'LR':
+            return 0.0 if axis.at_rls else 1.0
+        if key == 'SP':
+            return axis.sp
+        if key == 'AC':
+            return axis.ac
+        if key == 'DC':
+            return axis.dc
+        if key == 'PA':
+            return axis.target
+        if key in STORED:
+            return axis.params.get(key, 0.0)
+        raise DmcError(1)
+
+    def _set(self, key: str, axis: Axis, value: float):
+        if key == 'PA':
+            axis.target = value
+        elif key == 'PR':
+            axis.target = axis.pos + value
+        elif key in ('SP', 'AC', 'DC'):
+            if value <= 0:
+                raise DmcError(6)
+            setattr(axis, key.lower(), value)
+        else:
+            axis.params[key] = value
+
+    # -- commands ---------------------------------------------------------
+
+    def command(self, cmd: str) -> str:
+        """Execute one command and return its output (without ':')."""
+        cmd = cmd.strip()
+        if not cmd:
+            return ""
+        key, arg = cmd[:2], cmd[2:]
+        settable = ('PA', 'PR', 'SP', 'AC', 'DC') + STORED
+
+        if key in settable:
+            match = re.fullmatch(r"\s*([A-Ha-h])\s*=\s*(\S+)\s*", arg)
+            if match:
+                index = self._axis_index(match.group(1))
+                if match.group(2) == '?':
+                    if key == 'PR':
+                        return " %d" % round(self.axes[index].target -
+                                             self.axes[index].pos)
+                    return " %d" % round(self._operand('_%s%s' % (
+                        key, self.letters[index])))
+                if key in ('PA', 'PR') and self.axes[index].moving:
+                    raise DmcError(7)
+                self._set(key, self.axes[index], self._number(match.group(2)))
+                return ""
+            values = arg.split(',')
+            if len(values) > len(self.axes):
+                raise DmcError(6)
+            for index, text in enumerate(values):
+                if text.strip():
+                    if key in ('PA', 'PR') and self.axes[index].moving:
+                        raise DmcError(7)
+                    self._set(key, self.axes[index], self._number(text))
+            return ""
+
+        if key == 'BG':
+            indices = self._axis_list(arg)
+            for index in indices:
+                axis = self.axes[index]
+                if axis.moving:
+                    raise DmcError(7)
+                if not axis.motor_on:
+                    raise DmcError(20)
+            for index in indices:
+                self.axes[index].begin()
+            return ""
+        if key in ('ST', 'AB'):
+            for index in self._axis_list(arg):
+                self.axes[index].stop(abort=(key == 'AB'))
+            return ""
+        if key in ('SH', 'MO'):
+            for index in self._axis_list(arg):
+                axis = self.axes[index]
+                if key == 'MO':
+                    axis.stop(abort=True)
+                axis.motor_on = key == 'SH'
+            return ""
+        if key in ('TP', 'TS'):
+            values = []
+            for index in self._axis_list(arg):
+                axis = self.axes[index]
+                values.append(round(axis.pos) if key == 'TP'
+                              else axis.switches)
+            return ",".join(" %d" % v for v in values)
+        if key == 'MG':
+            out = []
+            for item in re.findall(r'"[^"]*"|[^,\s]+', arg):
+                if item.startswith('"'):
+                    out.append(item[1:-1])
+                elif item.startswith('_'):
+                    out.append(self._format(self._operand(item)))
+                else:
+                    out.append(self._format(self._number(item)))
+            return "".join(out)
+        if key == 'TC':
+            code = self.last_error
+            if arg.strip() == '1':
+                return "%d %s" % (code, ERRORS.get(code, ""))
+            return " %d" % code
+        if key == 'ID':
+            return "FW, %s\r\nDMC, 4103, 16 bit, Rev 11" % FIRMWARE
+        raise DmcError(1)
+
+    def execute(self, line: str) -> str:
+        """Execute a ';'-separated command line and build the reply."""
+        reply = []
+        with self.lock:
+            self.update()
+            for cmd in line.split(';'):
+                try:
+                    out = self.command(cmd)
+                except DmcError as err:
+                    self.last_error = err.code
+                    reply.append('?')
+                    break
+                if out:
+                    reply.append(out + "\r\n")
+                reply.append(':')
+        return "".join(reply)
+
+
+class _Handler(socketserver.BaseRequestHandler):
+    def handle(self):
+        buffer = b""
+        while True:
+            data = self.request.recv(1024)
+            if not data:
+                return
+            buffer += data
+            while b"\r" in buffer:
+                line, buffer = buffer.split(b"\r", 1)
+                line = line.strip(b"\n").decode(errors='replace')
+                reply = self.server.controller.execute(line)
+                self.request.sendall(reply.encode())
+
+
+class EmulatorServer(socketserver.ThreadingTCPServer):
+    """Threaded TCP server in front of one Controller."""
+    allow_reuse_address = True
+    daemon_threads = True
+
+    def __init__(self, address, controller: Optional[Controller] = None):
+        super().__init__(address, _Handler)
+        self.controller = controller or Controller()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--host', default='0.0.0.0')
+    parser.add_argument('--port', type=int, default=5023)
+    parser.add_argument('--axes', type=int, default=4)
+    parser.add_argument('--fls', type=float, default=1e7,
+                        help='forward limit switch position in counts')
+    parser.add_argument('--rls', type=float, default=-1e7,
+                        help='reverse limit switch position in counts')
+    parser.add_argument('--servo', action='store_true',
+                        help='start with all motors on (SH)')
+    args = parser.parse_args()
+
+    controller = Controller(args.axes, args.fls, args.rls)
+    if args.servo:
+        controller.execute("SH")
+    server = EmulatorServer((args.host, args.port), controller)
+    print("%s emulator, %d axes, listening on %s:%d" %
+          (FIRMWARE, args.axes, args.host, args.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()